@@ -5,10 +5,10 @@ ActionInitialization::ActionInitialization() {}
 ActionInitialization::~ActionInitialization() {}
 
 void ActionInitialization::Build() const {
-  PrimaryGenerator *generator = new PrimaryGenerator();
-  SetUserAction(generator);
   RunAction *runAction = new RunAction();
   SetUserAction(runAction);
+  PrimaryGenerator *generator = new PrimaryGenerator(runAction);
+  SetUserAction(generator);
 
   EventAction *eventAction = new EventAction(runAction);
   SetUserAction(eventAction);
@@ -21,6 +21,16 @@ def combine_root_files(output_file, input_files):
     # Write the trees to the output file
     energy_tree.Write()
 
+    # Histograms are merged by Geant4 into the master output
+    master = ROOT.TFile.Open('build/output0.root')
+    if master and not master.IsZombie():
+        for name in ['Primaries', 'Response', 'ResponseBroad']:
+            hist = master.Get(name)
+            if hist:
+                output.cd()
+                hist.Write(name)
+        master.Close()
+
     # Close the output file
     output.Close()
     print(f"Combined {len(input_files)} ROOT files into {output_file}")
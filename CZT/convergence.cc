@@ -0,0 +1,240 @@
+#include "convergence.hh"
+
+#include "G4AutoLock.hh"
+#include "G4ios.hh"
+#include "TFile.h"
+#include "TParameter.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <fstream>
+
+namespace {
+// 0.01 keV bins, same range the analysis uses for the CZT peak study
+const G4int kBins = 10000;
+const G4double kLowKeV = 0.;
+const G4double kHighKeV = 100.;
+} // namespace
+
+ConvergenceControl *ConvergenceControl::Instance() {
+  static ConvergenceControl instance;
+  return &instance;
+}
+
+ConvergenceControl::ConvergenceControl()
+    : fActive(false), fConverged(false),
+      fNextSnapshot(0), fCriterion(kNone), fLow(0.), fHigh(0.), fTarget(0.),
+      fMinEvents(0), fCheckEvery(1), fEvents(0), fWindowSum(0.),
+      fWindowSum2(0.), fWindowCounts(0), fSpectrum(nullptr) {}
+
+ConvergenceControl::~ConvergenceControl() {
+  for (Tally *tally : fTallies)
+    delete tally;
+  delete fSpectrum;
+}
+
+void ConvergenceControl::Configure(const std::vector<G4long> &snapshots,
+                                   Criterion criterion, G4double lowKeV,
+                                   G4double highKeV, G4double target,
+                                   G4long minEvents, G4long checkEvery) {
+  // master, before the workers start their events
+  G4AutoLock lock(&fMutex);
+  fSnapshots = snapshots;
+  std::sort(fSnapshots.begin(), fSnapshots.end());
+  fNextSnapshot = 0;
+  fCriterion = criterion;
+  fLow = lowKeV;
+  fHigh = highKeV;
+  fTarget = target;
+  fMinEvents = minEvents;
+  fCheckEvery = std::max<G4long>(checkEvery, 1);
+
+  fEvents = 0;
+  fWindowSum = fWindowSum2 = 0.;
+  fWindowCounts = 0;
+  for (Tally *tally : fTallies)
+    Reset(*tally);
+  fConverged = false;
+  fActive = !fSnapshots.empty() || fCriterion != kNone;
+
+  if (!fSpectrum) {
+    fSpectrum = new TH1D("EnergyCZT", "CZT Spectrum;Energy (keV);Entries",
+                         kBins, kLowKeV, kHighKeV);
+    fSpectrum->SetDirectory(nullptr);
+  }
+  fSpectrum->Reset();
+}
+
+ConvergenceControl::Tally *ConvergenceControl::LocalTally() {
+  static G4ThreadLocal Tally *tally = nullptr;
+  if (!tally) {
+    tally = new Tally;
+    Reset(*tally);
+    G4AutoLock lock(&fMutex);
+    fTallies.push_back(tally);
+  }
+  return tally;
+}
+
+void ConvergenceControl::Reset(Tally &tally) const {
+  tally.events = 0;
+  tally.windowSum = tally.windowSum2 = 0.;
+  tally.windowCounts = 0;
+  // with the underflow and overflow bins, as in TH1
+  tally.spectrum.assign(kBins + 2, 0.);
+}
+
+void ConvergenceControl::AddEvent(G4double edepKeV) {
+  if (!fActive)
+    return;
+  Tally *tally = LocalTally();
+  ++tally->events;
+  if (edepKeV > 0.0001) {
+    G4int bin = kBins + 1;
+    if (edepKeV < kHighKeV)
+      bin = 1 + static_cast<G4int>((edepKeV - kLowKeV) /
+                                   (kHighKeV - kLowKeV) * kBins);
+    tally->spectrum[bin] += 1.;
+    if (edepKeV >= fLow && edepKeV <= fHigh) {
+      tally->windowSum += edepKeV;
+      tally->windowSum2 += edepKeV * edepKeV;
+      ++tally->windowCounts;
+    }
+  }
+  if (tally->events < fCheckEvery)
+    return;
+
+  Report report;
+  G4bool write = false;
+  {
+    G4AutoLock lock(&fMutex);
+    if (!fActive)
+      return;
+    Merge(*tally);
+    if (Evaluate()) {
+      report = MakeReport(true, "");
+      write = true;
+    }
+  }
+  if (write)
+    Write(report);
+}
+
+void ConvergenceControl::Merge(Tally &tally) {
+  G4double entries = 0.;
+  for (G4int bin = 0; bin < kBins + 2; bin++) {
+    if (tally.spectrum[bin] > 0.) {
+      fSpectrum->AddBinContent(bin, tally.spectrum[bin]);
+      entries += tally.spectrum[bin];
+    }
+  }
+  fSpectrum->SetEntries(fSpectrum->GetEntries() + entries);
+  fEvents += tally.events;
+  fWindowSum += tally.windowSum;
+  fWindowSum2 += tally.windowSum2;
+  fWindowCounts += tally.windowCounts;
+  Reset(tally);
+}
+
+G4bool ConvergenceControl::Evaluate() {
+  // the first merge at or past a snapshot count writes it, with the events
+  // merged by then
+  G4bool snapshot = false;
+  while (fNextSnapshot < fSnapshots.size() &&
+         fEvents >= fSnapshots[fNextSnapshot]) {
+    snapshot = true;
+    ++fNextSnapshot;
+  }
+
+  if (fCriterion != kNone && !fConverged && fEvents >= fMinEvents) {
+    G4double value, error;
+    if (RelativeUncertainty(value, error) <= fTarget) {
+      fConverged = true;
+      snapshot = true;
+    }
+  }
+  return snapshot;
+}
+
+G4double ConvergenceControl::RelativeUncertainty(G4double &value,
+                                                 G4double &error) const {
+  value = error = 0.;
+  if (fCriterion == kROICounts) {
+    value = fWindowCounts;
+    error = std::sqrt(value);
+  } else if (fCriterion == kCentroid && fWindowCounts > 1) {
+    G4double n = fWindowCounts;
+    value = fWindowSum / n;
+    G4double variance = (fWindowSum2 - n * value * value) / (n - 1);
+    error = std::sqrt(std::max(variance, 0.) / n);
+  }
+  return value > 0 ? error / value : DBL_MAX;
+}
+
+ConvergenceControl::Report
+ConvergenceControl::MakeReport(G4bool snapshot, const G4String &reason) {
+  Report report;
+  report.events = fEvents;
+  report.windowCounts = fWindowCounts;
+  report.relative = RelativeUncertainty(report.value, report.error);
+  report.spectrum = nullptr;
+  if (snapshot) {
+    report.spectrum = static_cast<TH1D *>(fSpectrum->Clone());
+    report.spectrum->SetDirectory(nullptr);
+  }
+  report.reason = reason;
+  return report;
+}
+
+void ConvergenceControl::Write(Report &report) {
+  // outside fMutex, the workers keep merging while a file is written
+  G4AutoLock lock(&fWriteMutex);
+  if (report.spectrum) {
+    TString fileName = TString::Format("snapshot_%ld.root", report.events);
+    TFile file(fileName, "RECREATE");
+    report.spectrum->Write("EnergyCZT");
+    TParameter<Long64_t>("events", report.events).Write();
+    file.Close();
+    delete report.spectrum;
+    report.spectrum = nullptr;
+    report.reason = fileName.Data();
+  }
+
+  std::ofstream summary("convergence.txt", std::ios::app);
+  summary << report.events << " " << report.windowCounts << " "
+          << report.value << " " << report.error << " " << report.relative
+          << " " << report.reason << "\n";
+
+  G4cout << "Convergence: " << report.events << " events, "
+         << report.windowCounts << " counts in [" << fLow << ", " << fHigh
+         << "] keV";
+  if (fCriterion == kCentroid)
+    G4cout << ", centroid " << report.value << " +- " << report.error
+           << " keV";
+  if (fCriterion != kNone)
+    G4cout << ", relative uncertainty " << report.relative << " (target "
+           << fTarget << ")";
+  G4cout << " -> " << report.reason << G4endl;
+}
+
+void ConvergenceControl::Finish() {
+  Report snapshot, summary;
+  G4bool writeSnapshot = false;
+  {
+    G4AutoLock lock(&fMutex);
+    if (!fActive)
+      return;
+    // what the workers did not merge yet
+    for (Tally *tally : fTallies)
+      Merge(*tally);
+    if (Evaluate()) {
+      snapshot = MakeReport(true, "");
+      writeSnapshot = true;
+    }
+    summary = MakeReport(false, fConverged ? "converged" : "completed");
+    fActive = false;
+  }
+  if (writeSnapshot)
+    Write(snapshot);
+  Write(summary);
+}
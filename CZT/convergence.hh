@@ -0,0 +1,82 @@
+#ifndef CONVERGENCE_HH
+#define CONVERGENCE_HH
+
+#include "G4String.hh"
+#include "G4Threading.hh"
+#include "G4Types.hh"
+#include "TH1D.h"
+#include <atomic>
+#include <vector>
+
+// Merged, process-wide CZT tally used to write statistics-ladder snapshots
+// at requested event counts and to stop the run once the tally of interest
+// reaches its target relative uncertainty. Configured by the master run
+// action. Every thread fills a tally of its own and merges it every
+// checkEvery events and at the end of the run; the snapshots and the
+// criterion are evaluated at the merges, and files are written after the
+// tally lock is released.
+class ConvergenceControl {
+public:
+  enum Criterion { kNone, kROICounts, kCentroid };
+
+  static ConvergenceControl *Instance();
+
+  void Configure(const std::vector<G4long> &snapshots, Criterion criterion,
+                 G4double lowKeV, G4double highKeV, G4double target,
+                 G4long minEvents, G4long checkEvery);
+  // master, after the workers finished the run
+  void Finish();
+
+  G4bool IsActive() const { return fActive.load(); }
+  G4bool IsConverged() const { return fConverged.load(); }
+
+  // worker, lock free except every checkEvery events of the thread
+  void AddEvent(G4double edepKeV);
+
+private:
+  struct Tally {
+    G4long events;
+    G4double windowSum, windowSum2;
+    G4long windowCounts;
+    std::vector<G4double> spectrum;
+  };
+  // what a snapshot or the summary writes, copied under the lock
+  struct Report {
+    G4long events;
+    G4long windowCounts;
+    G4double value, error, relative;
+    TH1D *spectrum;
+    G4String reason;
+  };
+
+  ConvergenceControl();
+  ~ConvergenceControl();
+
+  Tally *LocalTally();
+  void Reset(Tally &tally) const;
+  // under fMutex
+  void Merge(Tally &tally);
+  G4bool Evaluate();
+  Report MakeReport(G4bool snapshot, const G4String &reason);
+  void Write(Report &report);
+  G4double RelativeUncertainty(G4double &value, G4double &error) const;
+
+  G4Mutex fMutex;
+  G4Mutex fWriteMutex;
+  std::atomic<G4bool> fActive;
+  std::atomic<G4bool> fConverged;
+  std::vector<Tally *> fTallies;
+
+  std::vector<G4long> fSnapshots;
+  std::size_t fNextSnapshot;
+  Criterion fCriterion;
+  G4double fLow, fHigh, fTarget;
+  G4long fMinEvents, fCheckEvery;
+
+  G4long fEvents;
+  G4double fWindowSum, fWindowSum2;
+  G4long fWindowCounts;
+  TH1D *fSpectrum;
+};
+
+#endif
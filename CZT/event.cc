@@ -1,15 +1,47 @@
 #include "event.hh"
 
-EventAction::EventAction(RunAction *) { fEdep = 0.; }
+EventAction::EventAction(RunAction *runAction) : fRunAction(runAction) {
+  fEdep = 0.;
+}
 EventAction::~EventAction() {}
 
 void EventAction::BeginOfEventAction(const G4Event *) { fEdep = 0.; }
 
-void EventAction::EndOfEventAction(const G4Event *) {
+void EventAction::EndOfEventAction(const G4Event *event) {
 
   G4AnalysisManager *man = G4AnalysisManager::Instance();
+  G4double edepBroad = 0.;
   if (fEdep > 0.0000001) {
+    edepBroad = fRunAction->GetDigitizer()->Digitize("CZT", fEdep);
     man->FillNtupleDColumn(0, 0, fEdep / keV);
+    man->FillNtupleDColumn(0, 1, edepBroad / keV);
     man->AddNtupleRow(0);
   }
+
+  if (fRunAction->IsResponseMode()) {
+    G4double trueEnergy =
+        event->GetPrimaryVertex()->GetPrimary()->GetKineticEnergy();
+    man->FillH1(0, trueEnergy / keV);
+    if (fEdep > 0.0000001) {
+      man->FillH2(0, trueEnergy / keV, fEdep / keV);
+      man->FillH2(1, trueEnergy / keV, edepBroad / keV);
+    }
+  }
+
+  ConvergenceControl *convergence = ConvergenceControl::Instance();
+  if (convergence->IsActive()) {
+    convergence->AddEvent(fEdep / keV);
+    if (convergence->IsConverged())
+      G4RunManager::GetRunManager()->AbortRun(true);
+  }
+
+  SpectrumMonitor *monitor = fRunAction->GetMonitor();
+  if (monitor) {
+    if (fEdep > 0.0000001)
+      monitor->Fill(fEdep / keV);
+    monitor->EndOfEvent();
+    // finish the current event and end the run normally so output is kept
+    if (monitor->StopRequested())
+      G4RunManager::GetRunManager()->AbortRun(true);
+  }
 }
@@ -3,6 +3,9 @@
 
 #include "G4AnalysisManager.hh"
 #include "G4Event.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4RunManager.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4UserEventAction.hh"
 #include "Randomize.hh"
@@ -19,6 +22,7 @@ public:
   void AddEdep(G4double edep) { fEdep += edep; }
 
 private:
+  RunAction *fRunAction;
   G4double fEdep;
 };
 
@@ -1,6 +1,7 @@
 #include "generator.hh"
 
-PrimaryGenerator::PrimaryGenerator() {
+PrimaryGenerator::PrimaryGenerator(const RunAction *runAction)
+    : fRunAction(runAction) {
   fParticleGun = new G4ParticleGun(1);
   G4ParticleTable *particleTable = G4ParticleTable::GetParticleTable();
   G4String particleName = "gamma";
@@ -80,6 +81,16 @@ void PrimaryGenerator::GeneratePrimaries(G4Event *anEvent) {
     }    
   fParticleGun->SetParticleMomentumDirection(momentum.unit());
 
+  // response matrix mode: flat over the true energy grid, the event action
+  // reads the energy back from the primary vertex
+  if (fRunAction->IsResponseMode()) {
+    G4double emin = fRunAction->GetResponseEmin();
+    G4double emax = fRunAction->GetResponseEmax();
+    fParticleGun->SetParticleEnergy(emin + (emax - emin) * G4UniformRand());
+    fParticleGun->GeneratePrimaryVertex(anEvent);
+    return;
+  }
+
     // Mean energy = 68.75 keV
     // Resolution = 1.8/59.5 ≈ 0.03025
     // Sigma = mean_energy * resolution
@@ -9,16 +9,18 @@
 #include "Randomize.hh"
 #include "TFile.h"
 #include "TTree.h"
+#include "run.hh"
 
 class PrimaryGenerator : public G4VUserPrimaryGeneratorAction {
 public:
-  PrimaryGenerator();
+  PrimaryGenerator(const RunAction *);
   ~PrimaryGenerator();
 
   virtual void GeneratePrimaries(G4Event *);
 
 private:
   G4ParticleGun *fParticleGun;
+  const RunAction *fRunAction;
   void LoadStoredData();
   TFile *fRootFile;
   TTree *fTree;
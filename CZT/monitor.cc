@@ -0,0 +1,153 @@
+#include "monitor.hh"
+
+#include "G4Exception.hh"
+#include "G4ios.hh"
+#include <algorithm>
+#include <cmath>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+SpectrumMonitor::SpectrumMonitor()
+    : fSegment(nullptr), fSlot(nullptr), fOwner(false), fCadence(1000),
+      fSincePublish(0), fEvents(0), fHits(0) {}
+
+SpectrumMonitor::~SpectrumMonitor() {
+  if (fOwner) {
+    Destroy();
+  } else {
+    Detach();
+  }
+}
+
+G4bool SpectrumMonitor::Map(G4int fd, G4bool create) {
+  if (create && ftruncate(fd, sizeof(monitor::Segment)) != 0) {
+    close(fd);
+    return false;
+  }
+  void *address = mmap(nullptr, sizeof(monitor::Segment),
+                       PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (address == MAP_FAILED)
+    return false;
+  fSegment = static_cast<monitor::Segment *>(address);
+  return true;
+}
+
+G4bool SpectrumMonitor::Create(const G4String &name, G4int nBins,
+                               G4double lowEdge, G4double highEdge,
+                               G4int eventsRequested) {
+  Destroy();
+  fName = name;
+  G4int fd = shm_open(fName.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+  if (fd < 0 || !Map(fd, true)) {
+    G4Exception("SpectrumMonitor::Create", "ShmFailed", JustWarning,
+                ("Cannot create shared memory segment " + fName +
+                 ", live monitoring disabled")
+                    .c_str());
+    return false;
+  }
+  fOwner = true;
+
+  // ftruncate zero-fills, so the counters and slots start out empty
+  fSegment->nBins = std::min<G4int>(nBins, monitor::kMaxBins);
+  fSegment->lowEdge = lowEdge;
+  fSegment->highEdge = highEdge;
+  fSegment->startTime = monitor::Now();
+  fSegment->eventsRequested = eventsRequested;
+  fSegment->magic = monitor::kMagic;
+
+  G4cout << "Live spectrum monitor: attach with 'cztmonitor " << fName << "'"
+         << G4endl;
+  return true;
+}
+
+void SpectrumMonitor::Destroy() {
+  if (!fOwner || !fSegment)
+    return;
+  fSegment->finished = 1;
+  munmap(fSegment, sizeof(monitor::Segment));
+  // viewers that are still attached keep their mapping after the unlink
+  shm_unlink(fName.c_str());
+  fSegment = nullptr;
+  fSlot = nullptr;
+  fOwner = false;
+}
+
+G4bool SpectrumMonitor::Attach(const G4String &name, G4int cadence) {
+  // a sequential run fills through the segment its master created
+  if (!fOwner) {
+    Detach();
+    fName = name;
+    G4int fd = shm_open(fName.c_str(), O_RDWR, 0644);
+    if (fd < 0 || !Map(fd, false) || fSegment->magic != monitor::kMagic) {
+      G4Exception("SpectrumMonitor::Attach", "ShmFailed", JustWarning,
+                  ("Cannot attach to shared memory segment " + fName).c_str());
+      if (fSegment)
+        munmap(fSegment, sizeof(monitor::Segment));
+      fSegment = nullptr;
+      return false;
+    }
+  }
+
+  std::uint32_t slot = fSegment->nSlots.fetch_add(1);
+  if (slot >= monitor::kMaxSlots) {
+    G4Exception("SpectrumMonitor::Attach", "ShmFull", JustWarning,
+                "No free monitor slot left for this thread");
+    return false;
+  }
+  fSlot = &fSegment->slots[slot];
+  fCadence = cadence;
+  fSincePublish = 0;
+  fEvents = fHits = 0;
+  fSpectrum.assign(fSegment->nBins, 0);
+  return true;
+}
+
+void SpectrumMonitor::Detach() {
+  Publish();
+  fSlot = nullptr;
+  if (fOwner || !fSegment)
+    return;
+  munmap(fSegment, sizeof(monitor::Segment));
+  fSegment = nullptr;
+}
+
+void SpectrumMonitor::Fill(G4double edepKeV) {
+  if (!fSlot)
+    return;
+  ++fHits;
+  G4double width =
+      (fSegment->highEdge - fSegment->lowEdge) / fSegment->nBins;
+  if (fSpectrum.empty() || edepKeV < fSegment->lowEdge ||
+      edepKeV >= fSegment->highEdge)
+    return;
+  // floor and clamp, an edge value can round one past the last bin
+  G4int bin = static_cast<G4int>(
+      std::floor((edepKeV - fSegment->lowEdge) / width));
+  bin = std::min(std::max(bin, 0), static_cast<G4int>(fSpectrum.size()) - 1);
+  ++fSpectrum[bin];
+}
+
+void SpectrumMonitor::EndOfEvent() {
+  if (!fSlot)
+    return;
+  ++fEvents;
+  if (++fSincePublish >= fCadence)
+    Publish();
+}
+
+void SpectrumMonitor::Publish() {
+  if (!fSlot)
+    return;
+  for (std::size_t i = 0; i < fSpectrum.size(); ++i) {
+    fSlot->spectrum[i].store(fSpectrum[i], std::memory_order_relaxed);
+  }
+  fSlot->hits.store(fHits, std::memory_order_relaxed);
+  fSlot->events.store(fEvents, std::memory_order_release);
+  fSincePublish = 0;
+}
+
+G4bool SpectrumMonitor::StopRequested() const {
+  return fSegment && fSegment->stopRequested.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,47 @@
+#ifndef MONITOR_HH
+#define MONITOR_HH
+
+#include "G4String.hh"
+#include "G4Types.hh"
+#include "monitorsegment.hh"
+#include <vector>
+
+// Publishes the running CZT spectrum and event counters into a POSIX
+// shared-memory segment so cztmonitor can follow a long run while it is
+// going. The master creates the segment, every worker attaches to it and
+// copies its thread-local counts into its own slot every fCadence events.
+class SpectrumMonitor {
+public:
+  SpectrumMonitor();
+  ~SpectrumMonitor();
+
+  // master side
+  G4bool Create(const G4String &name, G4int nBins, G4double lowEdge,
+                G4double highEdge, G4int eventsRequested);
+  void Destroy();
+
+  // worker side
+  G4bool Attach(const G4String &name, G4int cadence);
+  void Detach();
+
+  void Fill(G4double edepKeV);
+  void EndOfEvent();
+  G4bool StopRequested() const;
+
+private:
+  G4bool Map(G4int fd, G4bool create);
+  void Publish();
+
+  G4String fName;
+  monitor::Segment *fSegment;
+  monitor::Slot *fSlot;
+  G4bool fOwner;
+
+  G4int fCadence;
+  G4int fSincePublish;
+  std::uint64_t fEvents;
+  std::uint64_t fHits;
+  std::vector<std::uint64_t> fSpectrum;
+};
+
+#endif
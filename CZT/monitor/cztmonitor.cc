@@ -0,0 +1,187 @@
+// Attaches to the shared memory segment published by sim (/monitor/enable)
+// and shows the merged CZT spectrum, event rate and ETA while a run is going.
+//
+//   cztmonitor [name] [-i seconds] [-d spectrum.txt] [-1] [-s]
+//
+// -s asks the simulation to finish its current events and end the run
+// normally, -d dumps the merged spectrum, -1 prints a single update.
+
+#include "../monitorsegment.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+struct Snapshot {
+  std::uint64_t events = 0;
+  std::uint64_t hits = 0;
+  std::vector<std::uint64_t> spectrum;
+};
+
+Snapshot Merge(const monitor::Segment *segment) {
+  Snapshot snap;
+  snap.spectrum.assign(segment->nBins, 0);
+  std::uint32_t nSlots = std::min(segment->nSlots.load(), monitor::kMaxSlots);
+  for (std::uint32_t s = 0; s < nSlots; ++s) {
+    const monitor::Slot &slot = segment->slots[s];
+    snap.events += slot.events.load(std::memory_order_acquire);
+    snap.hits += slot.hits.load(std::memory_order_relaxed);
+    for (std::uint32_t i = 0; i < segment->nBins; ++i) {
+      snap.spectrum[i] += slot.spectrum[i].load(std::memory_order_relaxed);
+    }
+  }
+  return snap;
+}
+
+std::string FormatTime(double seconds) {
+  if (!std::isfinite(seconds) || seconds < 0)
+    return "--:--:--";
+  long s = static_cast<long>(seconds);
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%02ld:%02ld:%02ld", s / 3600,
+                (s / 60) % 60, s % 60);
+  return buffer;
+}
+
+// coarse log-scale bar chart, wide enough to spot a misplaced peak
+void DrawSpectrum(const monitor::Segment *segment, const Snapshot &snap) {
+  const int columns = 72;
+  const int rows = 12;
+  std::vector<double> merged(columns, 0.);
+  for (std::uint32_t i = 0; i < segment->nBins; ++i) {
+    merged[i * columns / segment->nBins] += snap.spectrum[i];
+  }
+  double maxLog = 0.;
+  for (double counts : merged) {
+    maxLog = std::max(maxLog, std::log10(1. + counts));
+  }
+  for (int r = rows; r > 0; --r) {
+    std::string line;
+    for (double counts : merged) {
+      double height = maxLog > 0 ? std::log10(1. + counts) / maxLog * rows : 0;
+      line += height >= r ? '#' : ' ';
+    }
+    std::printf("|%s\n", line.c_str());
+  }
+  std::printf("+%s\n", std::string(columns, '-').c_str());
+  std::printf(" %-10.1f%*s%10.1f keV\n", segment->lowEdge, columns - 20, "",
+              segment->highEdge);
+}
+
+void Dump(const monitor::Segment *segment, const Snapshot &snap,
+          const char *fileName) {
+  FILE *out = std::fopen(fileName, "w");
+  if (!out) {
+    std::perror(fileName);
+    return;
+  }
+  double width = (segment->highEdge - segment->lowEdge) / segment->nBins;
+  std::fprintf(out, "# events %llu\n# lowEdge(keV) counts\n",
+               static_cast<unsigned long long>(snap.events));
+  for (std::uint32_t i = 0; i < segment->nBins; ++i) {
+    std::fprintf(out, "%g %llu\n", segment->lowEdge + i * width,
+                 static_cast<unsigned long long>(snap.spectrum[i]));
+  }
+  std::fclose(out);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::string name = "/czt_monitor";
+  double interval = 2.;
+  const char *dumpFile = nullptr;
+  bool once = false;
+  bool stop = false;
+
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "-i") && i + 1 < argc) {
+      interval = std::atof(argv[++i]);
+    } else if (!std::strcmp(argv[i], "-d") && i + 1 < argc) {
+      dumpFile = argv[++i];
+    } else if (!std::strcmp(argv[i], "-1")) {
+      once = true;
+    } else if (!std::strcmp(argv[i], "-s")) {
+      stop = true;
+    } else {
+      name = argv[i];
+    }
+  }
+
+  int fd = shm_open(name.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    std::fprintf(stderr, "No running simulation publishes %s\n", name.c_str());
+    return 1;
+  }
+  void *address = mmap(nullptr, sizeof(monitor::Segment),
+                       PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (address == MAP_FAILED) {
+    std::perror("mmap");
+    return 1;
+  }
+  auto *segment = static_cast<monitor::Segment *>(address);
+  if (segment->magic != monitor::kMagic) {
+    std::fprintf(stderr, "%s is not a spectrum monitor segment\n",
+                 name.c_str());
+    return 1;
+  }
+
+  if (stop) {
+    segment->stopRequested = 1;
+    std::printf("Requested a graceful stop of %s\n", name.c_str());
+    return 0;
+  }
+
+  Snapshot previous = Merge(segment);
+  double previousTime = monitor::Now();
+  while (true) {
+    if (!once)
+      std::this_thread::sleep_for(std::chrono::duration<double>(interval));
+    Snapshot snap = Merge(segment);
+    double now = monitor::Now();
+
+    double elapsed = now - segment->startTime;
+    double rate = elapsed > 0 ? snap.events / elapsed : 0.;
+    double recentRate =
+        now > previousTime ? (snap.events - previous.events) /
+                                 (now - previousTime)
+                           : 0.;
+    std::uint64_t requested = segment->eventsRequested.load();
+    double eta = rate > 0 ? (requested - snap.events) / rate : NAN;
+
+    if (!once)
+      std::printf("\033[2J\033[H");
+    std::printf("%s  threads %u%s\n", name.c_str(), segment->nSlots.load(),
+                segment->stopRequested ? "  (stop requested)" : "");
+    std::printf("events %llu / %llu (%.1f%%)  hits %llu\n",
+                static_cast<unsigned long long>(snap.events),
+                static_cast<unsigned long long>(requested),
+                requested ? 100. * snap.events / requested : 0.,
+                static_cast<unsigned long long>(snap.hits));
+    std::printf("rate %.0f ev/s (last %.0f ev/s)  elapsed %s  ETA %s\n\n",
+                rate, recentRate, FormatTime(elapsed).c_str(),
+                FormatTime(eta).c_str());
+    DrawSpectrum(segment, snap);
+
+    if (dumpFile)
+      Dump(segment, snap, dumpFile);
+    if (once || segment->finished)
+      break;
+    previous = snap;
+    previousTime = now;
+  }
+
+  munmap(address, sizeof(monitor::Segment));
+  return 0;
+}
@@ -0,0 +1,46 @@
+#ifndef MONITORSEGMENT_HH
+#define MONITORSEGMENT_HH
+
+// Layout of the POSIX shared-memory segment used by the live spectrum
+// monitor. Shared between the simulation and the cztmonitor viewer, so it
+// must not depend on Geant4.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace monitor {
+
+const std::uint32_t kMagic = 0x435a544d; // "CZTM"
+const std::uint32_t kMaxSlots = 256;
+const std::uint32_t kMaxBins = 2048;
+
+// one slot per worker thread, only ever written by its owner
+struct Slot {
+  std::atomic<std::uint64_t> events;
+  std::atomic<std::uint64_t> hits;
+  std::atomic<std::uint64_t> spectrum[kMaxBins];
+};
+
+struct Segment {
+  std::uint32_t magic;
+  std::uint32_t nBins;
+  double lowEdge;  // keV
+  double highEdge; // keV
+  double startTime;
+  std::atomic<std::uint64_t> eventsRequested;
+  std::atomic<std::uint32_t> nSlots;
+  std::atomic<std::int32_t> stopRequested;
+  std::atomic<std::int32_t> finished;
+  Slot slots[kMaxSlots];
+};
+
+inline double Now() {
+  return std::chrono::duration<double>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+} // namespace monitor
+
+#endif
@@ -1,22 +1,194 @@
 #include "run.hh"
 
-RunAction::RunAction() {
+#include "G4SystemOfUnits.hh"
+
+RunAction::RunAction()
+    : fMonitorEnabled(false), fMonitorName("/czt_monitor"),
+      fMonitorCadence(10000), fMonitorBins(1000), fMonitorEmax(100.),
+      fCriterion("none"), fWindowLow(64.75 * keV),
+      fWindowHigh(72.75 * keV), fTarget(0.), fMinEvents(1000),
+      fCheckEvery(1000), fResponseEnabled(false), fResponseEmin(10. * keV),
+      fResponseEmax(150. * keV), fResponseTrueBins(140),
+      fResponseDepositBins(1500), fResponseDepositMax(150. * keV) {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
   man->CreateNtuple("Energy", "Energy");
   man->CreateNtupleDColumn("fEdep");
+  man->CreateNtupleDColumn("fEdepBroad");
   man->FinishNtuple(0);
+
+  // response matrix, binned in BeginOfRunAction once the grid is known
+  man->CreateH1("Primaries", "Primaries per true energy bin", 1, 0., 1.);
+  man->CreateH2("Response", "True vs deposited energy", 1, 0., 1., 1, 0.,
+                1.);
+  man->CreateH2("ResponseBroad", "True vs digitized energy", 1, 0., 1., 1,
+                0., 1.);
+  man->SetActivation(true);
+
+  // resolution previously applied by TreeModule in simAnalysis
+  fDigitizer.SetRelative("CZT", 1.8 / 59.5);
+
+  DefineMonitorCommands();
+  DefineConvergenceCommands();
+  DefineResponseCommands();
+}
+RunAction::~RunAction() {
+  delete fMonitorMessenger;
+  delete fConvergenceMessenger;
+  delete fResponseMessenger;
+}
+
+void RunAction::DefineMonitorCommands() {
+  fMonitorMessenger =
+      new G4GenericMessenger(this, "/monitor/", "Live spectrum monitor");
+  fMonitorMessenger
+      ->DeclareProperty("enable", fMonitorEnabled,
+                        "Publish running spectra to shared memory")
+      .SetDefaultValue("true");
+  fMonitorMessenger->DeclareProperty("name", fMonitorName,
+                                     "Shared memory segment name");
+  fMonitorMessenger
+      ->DeclareProperty("cadence", fMonitorCadence,
+                        "Events per worker between two updates")
+      .SetRange("cadence>0");
+  fMonitorMessenger
+      ->DeclareProperty("bins", fMonitorBins, "Number of spectrum bins")
+      .SetRange("bins>0");
+  fMonitorMessenger->DeclareProperty("emax", fMonitorEmax,
+                                     "Upper spectrum edge in keV");
+}
+
+void RunAction::DefineConvergenceCommands() {
+  fConvergenceMessenger = new G4GenericMessenger(
+      this, "/convergence/", "Statistics snapshots and automatic stopping");
+  fConvergenceMessenger->DeclareProperty(
+      "snapshots", fSnapshotList,
+      "Event counts at which to write merged snapshots, e.g. '1e6 5e6 1e7'");
+  fConvergenceMessenger
+      ->DeclareProperty("criterion", fCriterion,
+                        "Tally that decides when to stop the run")
+      .SetCandidates("none roi centroid");
+  fConvergenceMessenger
+      ->DeclareProperty("windowLow", fWindowLow,
+                        "Lower edge of the tally window in keV")
+      .SetUnit("keV");
+  fConvergenceMessenger
+      ->DeclareProperty("windowHigh", fWindowHigh,
+                        "Upper edge of the tally window in keV")
+      .SetUnit("keV");
+  fConvergenceMessenger
+      ->DeclareProperty("target", fTarget,
+                        "Relative uncertainty at which the run stops")
+      .SetRange("target>=0");
+  fConvergenceMessenger->DeclareProperty(
+      "minEvents", fMinEvents, "Events before the criterion is evaluated");
+  fConvergenceMessenger
+      ->DeclareProperty("checkEvery", fCheckEvery,
+                        "Events of a thread between two merges into the "
+                        "tally, the criterion is evaluated at the merges")
+      .SetRange("checkEvery>0");
 }
-RunAction::~RunAction() {}
+
+void RunAction::DefineResponseCommands() {
+  fResponseMessenger = new G4GenericMessenger(
+      this, "/response/", "Detector response matrix over a true energy grid");
+  fResponseMessenger
+      ->DeclareProperty("enable", fResponseEnabled,
+                        "Sample primaries uniformly over the grid and fill "
+                        "the response matrix")
+      .SetDefaultValue("true");
+  fResponseMessenger
+      ->DeclareProperty("emin", fResponseEmin,
+                        "Lower edge of the true energy grid")
+      .SetUnit("keV");
+  fResponseMessenger
+      ->DeclareProperty("emax", fResponseEmax,
+                        "Upper edge of the true energy grid")
+      .SetUnit("keV");
+  fResponseMessenger
+      ->DeclareProperty("trueBins", fResponseTrueBins,
+                        "Number of true energy bins")
+      .SetRange("trueBins>0");
+  fResponseMessenger
+      ->DeclareProperty("depositBins", fResponseDepositBins,
+                        "Number of deposited energy bins")
+      .SetRange("depositBins>0");
+  fResponseMessenger
+      ->DeclareProperty("depositMax", fResponseDepositMax,
+                        "Upper edge of the deposited energy axis")
+      .SetUnit("keV");
+}
+
+void RunAction::ConfigureResponse() {
+  G4AnalysisManager *man = G4AnalysisManager::Instance();
+  if (fResponseEnabled) {
+    if (fResponseEmax <= fResponseEmin) {
+      G4Exception("RunAction::ConfigureResponse", "BadGrid", FatalException,
+                  "/response/emax must be above /response/emin");
+    }
+    man->SetH1(0, fResponseTrueBins, fResponseEmin / keV,
+               fResponseEmax / keV);
+    for (G4int id = 0; id < 2; id++) {
+      man->SetH2(id, fResponseTrueBins, fResponseEmin / keV,
+                 fResponseEmax / keV, fResponseDepositBins, 0.,
+                 fResponseDepositMax / keV);
+    }
+  }
+  man->SetH1Activation(0, fResponseEnabled);
+  man->SetH2Activation(0, fResponseEnabled);
+  man->SetH2Activation(1, fResponseEnabled);
+}
+
+void RunAction::ConfigureConvergence() {
+  std::vector<G4long> snapshots;
+  std::istringstream list(fSnapshotList);
+  G4double count;
+  while (list >> count) {
+    snapshots.push_back(static_cast<G4long>(count));
+  }
+
+  ConvergenceControl::Criterion criterion = ConvergenceControl::kNone;
+  if (fCriterion == "roi") {
+    criterion = ConvergenceControl::kROICounts;
+  } else if (fCriterion == "centroid") {
+    criterion = ConvergenceControl::kCentroid;
+  }
+
+  ConvergenceControl::Instance()->Configure(
+      snapshots, criterion, fWindowLow / keV, fWindowHigh / keV, fTarget,
+      static_cast<G4long>(fMinEvents), fCheckEvery);
+}
+
 void RunAction::BeginOfRunAction(const G4Run *run) {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
+  ConfigureResponse();
   G4int runNumber = run->GetRunID();
   std::stringstream strRunID;
   strRunID << runNumber;
   man->OpenFile("output" + strRunID.str() + ".root");
+
+  if (IsMaster())
+    ConfigureConvergence();
+
+  if (fMonitorEnabled) {
+    if (IsMaster()) {
+      fMonitor.Create(fMonitorName, fMonitorBins, 0., fMonitorEmax,
+                      run->GetNumberOfEventToBeProcessed());
+    }
+    // in sequential mode the master is also the thread that fills
+    if (!IsMaster() || !G4Threading::IsMultithreadedApplication()) {
+      fMonitor.Attach(fMonitorName, fMonitorCadence);
+    }
+  }
 }
 void RunAction::EndOfRunAction(const G4Run *) {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
 
   man->Write();
   man->CloseFile("");
+
+  fMonitor.Detach();
+  fMonitor.Destroy();
+
+  if (IsMaster())
+    ConvergenceControl::Instance()->Finish();
 }
@@ -2,8 +2,13 @@
 #define RUN_HH
 
 #include "G4AnalysisManager.hh"
+#include "G4GenericMessenger.hh"
 #include "G4Run.hh"
+#include "G4Threading.hh"
 #include "G4UserRunAction.hh"
+#include "convergence.hh"
+#include "digitizer.hh"
+#include "monitor.hh"
 
 class RunAction : public G4UserRunAction {
 public:
@@ -12,6 +17,47 @@ public:
 
   virtual void BeginOfRunAction(const G4Run *);
   virtual void EndOfRunAction(const G4Run *);
+
+  SpectrumMonitor *GetMonitor() {
+    return fMonitorEnabled ? &fMonitor : nullptr;
+  }
+  const Digitizer *GetDigitizer() const { return &fDigitizer; }
+
+  G4bool IsResponseMode() const { return fResponseEnabled; }
+  G4double GetResponseEmin() const { return fResponseEmin; }
+  G4double GetResponseEmax() const { return fResponseEmax; }
+
+private:
+  void DefineMonitorCommands();
+  void DefineConvergenceCommands();
+  void ConfigureConvergence();
+  void DefineResponseCommands();
+  void ConfigureResponse();
+
+  G4GenericMessenger *fMonitorMessenger;
+  SpectrumMonitor fMonitor;
+  G4bool fMonitorEnabled;
+  G4String fMonitorName;
+  G4int fMonitorCadence;
+  G4int fMonitorBins;
+  G4double fMonitorEmax;
+
+  G4GenericMessenger *fConvergenceMessenger;
+  G4String fSnapshotList;
+  G4String fCriterion;
+  G4double fWindowLow, fWindowHigh;
+  G4double fTarget;
+  G4double fMinEvents;
+  G4int fCheckEvery;
+
+  Digitizer fDigitizer;
+
+  G4GenericMessenger *fResponseMessenger;
+  G4bool fResponseEnabled;
+  G4double fResponseEmin, fResponseEmax;
+  G4int fResponseTrueBins;
+  G4int fResponseDepositBins;
+  G4double fResponseDepositMax;
 };
 
 #endif
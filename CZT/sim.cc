@@ -2,7 +2,7 @@
 #include "construction.hh"
 
 // include physics files
-#include "physics.hh"
+#include "physicslist.hh"
 
 // include actions
 #include "action.hh"
@@ -17,6 +17,9 @@
 #include "TROOT.h"
 
 int main(int argc, char **argv) {
+
+  // -p <physics> picks the physics list, see physicslist.hh
+  G4String physicsConfig = TakePhysicsOption(argc, argv);
   // Enable ROOT thread safety - add this at the start of main
   ROOT::EnableThreadSafety();
 #ifdef G4MULTITHREADED
@@ -25,7 +28,7 @@ int main(int argc, char **argv) {
   G4RunManager *runManager = new G4RunManager();
 #endif
   runManager->SetUserInitialization(new DetectorConstruction());
-  runManager->SetUserInitialization(new PhysicsList());
+  runManager->SetUserInitialization(new PhysicsList(physicsConfig, "gamma"));
   runManager->SetUserInitialization(new ActionInitialization());
 
   G4UIExecutive *ui = 0;
@@ -0,0 +1,12 @@
+#include "include/TreeModule.hh"
+#include "src/TreeModule.cpp"
+
+// Times the banded broadening against the original all-pairs version on
+// the 1E9 sample and checks that both give the same spectrum.
+void benchmark() {
+  gROOT->SetBatch(kTRUE);
+  ROOT::EnableImplicitMT();
+  TreeModule *tm = new TreeModule("../1E9.root", "benchmark_broadened.root");
+  tm->benchmarkBroadening("CZT");
+  delete tm;
+}
@@ -0,0 +1,23 @@
+#include "src/BroadTree.cpp"
+#include "src/Bootstrap.cpp"
+#include "src/PeakFitter.cpp"
+
+// Peak-position error versus measurement time from the 1E9 sample alone
+// (1E9 events correspond to 267 min)
+void bootstrap() {
+  gROOT->SetBatch(kTRUE);
+  ROOT::EnableImplicitMT();
+  BroadTree *broad = new BroadTree("../1E9_broadened.root");
+  TH1D *spectrum = broad->energySpectrumHist("CZT", 0, 100, 829);
+
+  Bootstrap bootstrap(spectrum, 1e9, 267.);
+  std::vector<double> minutes = {0.267, 1.3, 2.67, 13.3, 26.7, 100.};
+  std::vector<ExposurePoint> points =
+      bootstrap.run(minutes, 200, Bootstrap::kPoisson);
+  Bootstrap::printTable(points);
+  Bootstrap::writeTable(points, "bootstrapCZT.csv");
+  Bootstrap::drawErrorVsExposure(points, "bootstrapCZT.png");
+
+  delete spectrum;
+  delete broad;
+}
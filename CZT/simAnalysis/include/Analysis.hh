@@ -2,8 +2,10 @@
 #define ANALYSIS_HH
 
 #include "../src/BroadTree.cpp"
+#include "../src/PeakFitter.cpp"
 #include "../src/TreeModule.cpp"
 #include "BroadTree.hh"
+#include "PeakFitter.hh"
 #include "TreeModule.hh"
 #include <TCanvas.h>
 #include <TColor.h>
@@ -13,11 +15,16 @@
 #include <TLegend.h>
 #include <TLine.h>
 #include <TString.h>
+#include <TThreadExecutor.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 class Analysis {
 public:
   Analysis();
   ~Analysis();
+  void addInput(const TString fileName, const TString label);
   void loadFiles(bool firstTime);
   void testHists(const TString detectorName);
   void drawHists(const TString detectorName, bool isNormed);
@@ -29,19 +36,18 @@ public:
   void ClearTHStack(THStack *stack);
 
 private:
-  TreeModule *tmSim0;
-  TreeModule *tmSim1;
-  TreeModule *tmSim2;
-  TreeModule *tmSim3;
-  TreeModule *tmSim4;
-  TreeModule *tmSim5;
-
-  BroadTree *tmBroad0;
-  BroadTree *tmBroad1;
-  BroadTree *tmBroad2;
-  BroadTree *tmBroad3;
-  BroadTree *tmBroad4;
-  BroadTree *tmBroad5;
+  void styleHist(TH1D *hist, size_t index);
+  void addPeakFit(TLegend *legend, TH1D *hist, const PeakFitResult &result,
+                  double lowerBound, double upperBound);
+
+  PeakFitter peakFitter;
+
+  // simulation outputs (e.g. "../1E6.root") and their legend labels
+  std::vector<TString> inputFiles;
+  std::vector<TString> inputLabels;
+  std::vector<TString> broadenedFiles;
+  std::vector<TreeModule *> tmSims;
+  std::vector<BroadTree *> tmBroads;
 
   THStack *CZTStack;
   THStack *HPGeStack;
@@ -0,0 +1,67 @@
+#ifndef BOOTSTRAP_MODULE_H_INCLUDED
+#define BOOTSTRAP_MODULE_H_INCLUDED
+#include "PeakFitter.hh"
+#include <ROOT/TSeq.hxx>
+#include <TCanvas.h>
+#include <TF1.h>
+#include <TGraphErrors.h>
+#include <TH1.h>
+#include <TLegend.h>
+#include <TRandom3.h>
+#include <TString.h>
+#include <TThreadExecutor.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// Peak-position uncertainty at a given exposure, from replicas of one large
+// spectrum instead of separate Geant4 runs at every statistics level
+struct ExposurePoint {
+  double minutes;
+  double events;
+  int replicas;
+  int converged;
+  double centroidMean;
+  double centroidSpread;   // standard deviation over the replicas
+  double centroidFitError; // mean of the per-fit errors
+  double sigmaMean;
+  double sigmaSpread;
+};
+
+class Bootstrap {
+public:
+  // kPoisson: every bin is drawn from Poisson(content * exposure fraction),
+  //           any exposure, also beyond the parent one
+  // kSubsets: the parent counts are split into disjoint subsets of the
+  //           requested exposure, so replicas are independent; needs integer
+  //           counts and at most half of the parent exposure
+  enum Mode { kPoisson, kSubsets };
+
+private:
+  TH1D *spectrum;
+  double parentEvents;
+  double parentMinutes;
+  double peak;
+  double range;
+  unsigned long seed;
+  PeakFitter peakFitter;
+
+  std::vector<std::vector<double>> replicate(double fraction, int replicas,
+                                             Mode mode,
+                                             unsigned long stream) const;
+
+public:
+  Bootstrap(TH1D *spectrum, double parentEvents, double parentMinutes,
+            double peak = 68.75, double range = 5, unsigned long seed = 4357);
+  std::vector<ExposurePoint> run(const std::vector<double> &minutes,
+                                 int replicas, Mode mode = kPoisson) const;
+  static void printTable(const std::vector<ExposurePoint> &points);
+  static void writeTable(const std::vector<ExposurePoint> &points,
+                         const char *fileName);
+  static void drawErrorVsExposure(const std::vector<ExposurePoint> &points,
+                                  const char *fileName);
+};
+
+#endif
@@ -1,5 +1,6 @@
 #ifndef BROADTREE_MODULE_H_INCLUDED
 #define BROADTREE_MODULE_H_INCLUDED
+#include <ROOT/RDataFrame.hxx>
 #include <TBranch.h>
 #include <TDirectory.h>
 #include <TFile.h>
@@ -10,6 +11,7 @@
 #include <TTree.h>
 #include <cstring>
 #include <iostream>
+#include <map>
 #include <random>
 
 class BroadTree {
@@ -22,7 +24,14 @@ private:
   TBranch *branchEnergyDepCZT;
   TBranch *branchEnergyDepHPGe;
   TBranch *branchEnergyDepSiLi;
+  TH1D *broadHistCZT;
+  TH1D *broadHistHPGe;
+  TH1D *broadHistSiLi;
   const char *aFilename;
+  std::map<TString, TH1D *> spectrumCache;
+
+  TH1D *fillSpectrum(const TString detectorName, double lowerBound,
+                     double upperBound, int nbins);
 
 public:
   BroadTree(const char *filename);
@@ -34,6 +43,9 @@ public:
   TBranch *getBranchEnergyCZT() const { return branchEnergyDepCZT; };
   TBranch *getBranchEnergyHPGe() const { return branchEnergyDepHPGe; };
   TBranch *getBranchEnergySiLi() const { return branchEnergyDepSiLi; };
+  TH1D *getBroadHistCZT() const { return broadHistCZT; };
+  TH1D *getBroadHistHPGe() const { return broadHistHPGe; };
+  TH1D *getBroadHistSiLi() const { return broadHistSiLi; };
   const char *getFilename() { return aFilename; };
   TString getFormattedFilename();
   TH1D *energySpectrumHist(const TString detectorName, double lowerBound,
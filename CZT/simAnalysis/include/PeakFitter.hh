@@ -0,0 +1,70 @@
+#ifndef PEAKFITTER_MODULE_H_INCLUDED
+#define PEAKFITTER_MODULE_H_INCLUDED
+#include <ROOT/TSeq.hxx>
+#include <TF1.h>
+#include <TH1.h>
+#include <TMath.h>
+#include <TString.h>
+#include <TThreadExecutor.h>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// One peak to fit: the spectrum, the fit window and a starting centroid
+struct PeakFitJob {
+  const TH1D *hist;
+  double lowerBound;
+  double upperBound;
+  double peak;
+  TString label;
+};
+
+// Parameters in the order of the TF1 "gaus + [3]*x*x + [4]*x + [5]":
+// amplitude, centroid, sigma, quadratic, linear, constant
+struct PeakFitResult {
+  static const int nPars = 6;
+  TString label;
+  bool converged = false;
+  int iterations = 0;
+  std::array<double, nPars> pars = {};
+  std::array<double, nPars * nPars> covariance = {};
+  double chi2 = 0.;
+  int ndf = 0;
+  double centroid = 0., centroidError = 0.;
+  double sigma = 0., sigmaError = 0.;
+  double area = 0., areaError = 0.;
+
+  double error(int i) const { return std::sqrt(covariance[i * nPars + i]); }
+};
+
+// Levenberg-Marquardt fits of a Gaussian on a quadratic background with the
+// analytic Jacobian, many jobs at a time on a thread pool
+class PeakFitter {
+private:
+  int maxIterations;
+  double tolerance;
+
+  static double model(const std::array<double, PeakFitResult::nPars> &p,
+                      double x);
+  static void gradient(const std::array<double, PeakFitResult::nPars> &p,
+                       double x, double *grad);
+  static bool solve(std::array<double, 36> a, std::array<double, 6> b,
+                    std::array<double, 6> &x);
+  static bool invert(const std::array<double, 36> &a,
+                     std::array<double, 36> &inverse);
+
+public:
+  PeakFitter(int maxIterations = 200, double tolerance = 1e-9);
+  PeakFitResult fit(const PeakFitJob &job) const;
+  std::vector<PeakFitResult> fitAll(const std::vector<PeakFitJob> &jobs,
+                                    unsigned nThreads = 0) const;
+  static TF1 *makeFunction(const PeakFitResult &result, double lowerBound,
+                           double upperBound);
+  static void printTable(const std::vector<PeakFitResult> &results);
+  static void writeTable(const std::vector<PeakFitResult> &results,
+                         const char *fileName);
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef RESPONSEMATRIX_MODULE_H_INCLUDED
+#define RESPONSEMATRIX_MODULE_H_INCLUDED
+#include <TF1.h>
+#include <TFile.h>
+#include <TH1.h>
+#include <TH2.h>
+#include <TString.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// Detector response from a /response/ run: probability to deposit energy in
+// each bin per primary of a given true energy, and the folding of arbitrary
+// source spectra through it
+class ResponseMatrix {
+private:
+  int nTrue;
+  int nDeposit;
+  std::vector<double> trueEdges;
+  double depositLow;
+  double depositHigh;
+  // true-major, [i * nDeposit + j] is deposit bin j for true bin i
+  std::vector<double> probability;
+  std::vector<double> variance;
+
+  int trueBin(double energy) const;
+  TH1D *makeHist(const std::vector<double> &source, const char *name) const;
+
+public:
+  ResponseMatrix(const char *fileName, const char *responseName = "Response",
+                 const char *primariesName = "Primaries");
+  bool isValid() const { return nTrue > 0; }
+  int getNTrue() const { return nTrue; }
+  int getNDeposit() const { return nDeposit; }
+  const std::vector<double> &getTrueEdges() const { return trueEdges; }
+
+  // Expected counts per deposit bin for the given emissions per true bin
+  std::vector<double> fold(const std::vector<double> &source) const;
+  // Source histogram in emissions per bin, redistributed onto the true grid
+  TH1D *fold(const TH1D *source, const char *name) const;
+  // Source as emissions per keV, integrated over every true bin
+  TH1D *fold(TF1 *source, const char *name) const;
+  // Discrete lines, energies in keV and emissions per line
+  TH1D *foldLines(const std::vector<double> &energies,
+                  const std::vector<double> &intensities,
+                  const char *name) const;
+  TH1D *efficiencyHist(const char *name) const;
+};
+
+#endif
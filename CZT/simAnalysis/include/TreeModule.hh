@@ -1,15 +1,22 @@
 #ifndef TREE_MODULE_H_INCLUDED
 #define TREE_MODULE_H_INCLUDED
 
+#include <ROOT/RDataFrame.hxx>
+#include <ROOT/TSeq.hxx>
 #include <TBranch.h>
 #include <TDirectory.h>
 #include <TFile.h>
 #include <TH1.h>
 #include <TMath.h>
 #include <TString.h>
+#include <TStopwatch.h>
+#include <TThreadExecutor.h>
 #include <TTree.h>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <random>
+#include <vector>
 
 class TreeModule {
 private:
@@ -22,16 +29,23 @@ private:
   TBranch *branchEnergyDepCZT;
   TBranch *branchEnergyDepHPGe;
   TBranch *branchEnergyDepSiLi;
+  // fEdepBroad of the CZT simulation's Energy ntuple, already in keV
+  TBranch *branchEnergyBroadCZT;
   const char *aFilename;
 
-  TH1D *createHistogram(TBranch *branch, const char *histName);
+  TH1D *createHistogram(TBranch *branch, const char *histName,
+                        double toKeV = 1000.);
+  double resolution(const TString detectorName);
   TH1D *broadenedHist(TH1D *hist, const TString detectorName);
-  void writeHistogramToTree(TTree *tree, TH1D *hist, const char *branchName);
+  TH1D *broadenedHistReference(TH1D *hist, const TString detectorName);
+  TH1D *digitizedHist(TBranch *branch, const TString detectorName);
+  void writeBroadenedHistogram(TH1D *hist, const TString detectorName);
 
 public:
   TreeModule(const char *filename, const char *broadenedFilename = nullptr);
   ~TreeModule();
   void broadenAndStoreEnergy();
+  void benchmarkBroadening(const TString detectorName = "CZT");
   const char *getFilename() { return aFilename; };
 };
 
@@ -4,6 +4,12 @@
 void macro() {
   gROOT->SetBatch(kTRUE);
   Analysis *analysis = new Analysis();
+  analysis->addInput("../1E6.root", "0.267 min");
+  analysis->addInput("../5E6.root", "1.3 min");
+  analysis->addInput("../1E7.root", "2.67 min");
+  analysis->addInput("../5E7.root", "13.3 min");
+  analysis->addInput("../1E8.root", "26.7 min");
+  analysis->addInput("../1E9.root", "267 min");
   analysis->loadFiles();
   analysis->drawHists("CZT", false);
   analysis->drawPartialHists("CZT", 64.75, 72.75, false, 66);
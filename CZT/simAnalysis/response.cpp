@@ -0,0 +1,58 @@
+#include "src/ResponseMatrix.cpp"
+#include <TCanvas.h>
+#include <TLegend.h>
+#include <TMath.h>
+#include <TStopwatch.h>
+
+// Folds sources through the matrix from a response.mac run instead of
+// simulating each of them
+void response() {
+  gROOT->SetBatch(kTRUE);
+  ResponseMatrix response("../response.root", "ResponseBroad");
+  if (!response.isValid())
+    return;
+
+  // the Gaussian 68.75 keV source of generator.cc, 1E9 primaries
+  double mean = 68.752;
+  double sigma = mean * 1.8 / 59.5;
+  TF1 *source = new TF1("source", "gaus", 0, 200);
+  source->SetParameters(1e9 / (sigma * TMath::Sqrt(2 * TMath::Pi())), mean,
+                        sigma);
+
+  TStopwatch timer;
+  TH1D *folded = response.fold(source, "FoldedSource");
+  timer.Stop();
+  std::cout << "Folded " << response.getNTrue() << " x "
+            << response.getNDeposit() << " matrix in "
+            << 1000. * timer.RealTime() << " ms" << std::endl;
+
+  // Am-241 lines, emissions per 1E9 decays
+  TH1D *am241 = response.foldLines({26.34, 59.54}, {2.27e7, 3.59e8},
+                                   "FoldedAm241");
+  TH1D *efficiency = response.efficiencyHist("Efficiency");
+
+  TFile *output = new TFile("folded.root", "RECREATE");
+  folded->Write();
+  am241->Write();
+  efficiency->Write();
+  output->Close();
+
+  TCanvas *c1 = new TCanvas("c1", "c1", 2000, 1500);
+  c1->SetLeftMargin(0.15);
+  c1->SetBottomMargin(0.15);
+  c1->SetLogy();
+  folded->SetLineColor(kRed);
+  folded->Draw("HIST");
+  am241->SetLineColor(kBlue);
+  am241->Draw("HIST SAME");
+  TLegend *legend = new TLegend(0.6, 0.75, 0.88, 0.88);
+  legend->AddEntry(folded, "68.75 keV source", "l");
+  legend->AddEntry(am241, "Am-241", "l");
+  legend->Draw();
+  c1->Print("foldedSpectra.png");
+
+  delete legend;
+  delete c1;
+  delete output;
+  delete source;
+}
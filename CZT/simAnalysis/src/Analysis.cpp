@@ -1,18 +1,6 @@
 #include "../include/Analysis.hh"
 
 Analysis::Analysis() {
-  tmSim0 = nullptr;
-  tmSim1 = nullptr;
-  tmSim2 = nullptr;
-  tmSim3 = nullptr;
-  tmSim4 = nullptr;
-  tmSim5 = nullptr;
-  tmBroad0 = nullptr;
-  tmBroad1 = nullptr;
-  tmBroad2 = nullptr;
-  tmBroad3 = nullptr;
-  tmBroad4 = nullptr;
-  tmBroad5 = nullptr;
   CZTStack = new THStack();
   HPGeStack = new THStack();
   SiLiStack = new THStack();
@@ -22,18 +10,12 @@ Analysis::Analysis() {
 }
 
 Analysis::~Analysis() {
-  delete tmSim0;
-  delete tmSim1;
-  delete tmSim2;
-  delete tmSim3;
-  delete tmSim4;
-  delete tmSim5;
-  delete tmBroad0;
-  delete tmBroad1;
-  delete tmBroad2;
-  delete tmBroad3;
-  delete tmBroad4;
-  delete tmBroad5;
+  for (TreeModule *tmSim : tmSims) {
+    delete tmSim;
+  }
+  for (BroadTree *tmBroad : tmBroads) {
+    delete tmBroad;
+  }
   delete CZTStack;
   delete CZTStackPartial;
   delete HPGeStack;
@@ -42,29 +24,61 @@ Analysis::~Analysis() {
   delete SiLiStackPartial;
 }
 
+void Analysis::addInput(const TString fileName, const TString label) {
+  inputFiles.push_back(fileName);
+  inputLabels.push_back(label);
+}
+
+// Every input is independent, so they are broadened (or opened) on a thread
+// pool and the whole pass takes about as long as the largest file
 void Analysis::loadFiles(bool firstTime = false) {
-  if (firstTime) {
-    tmSim0 = new TreeModule("../1E6.root");
-    tmSim1 = new TreeModule("../5E6.root");
-    tmSim2 = new TreeModule("../1E7.root");
-    tmSim3 = new TreeModule("../5E7.root");
-    tmSim4 = new TreeModule("../1E8.root");
-    tmSim5 = new TreeModule("../1E9.root");
+  size_t nInputs = inputFiles.size();
+  if (nInputs == 0) {
+    std::cerr << "No inputs, call addInput() before loadFiles()" << std::endl;
+    return;
+  }
 
-    tmSim0->broadenAndStoreEnergy();
-    tmSim1->broadenAndStoreEnergy();
-    tmSim2->broadenAndStoreEnergy();
-    tmSim3->broadenAndStoreEnergy();
-    tmSim4->broadenAndStoreEnergy();
-    tmSim5->broadenAndStoreEnergy();
-  } else {
-    tmBroad0 = new BroadTree("../1E6_broadened.root");
-    tmBroad1 = new BroadTree("../5E6_broadened.root");
-    tmBroad2 = new BroadTree("../1E7_broadened.root");
-    tmBroad3 = new BroadTree("../5E7_broadened.root");
-    tmBroad4 = new BroadTree("../1E8_broadened.root");
-    tmBroad5 = new BroadTree("../1E9_broadened.root");
+  ROOT::EnableThreadSafety();
+  tmSims.assign(nInputs, nullptr);
+  tmBroads.assign(nInputs, nullptr);
+  // the modules keep the file name pointers, so they must outlive the pool
+  broadenedFiles.clear();
+  for (const TString &fileName : inputFiles) {
+    broadenedFiles.push_back(
+        TString(fileName).ReplaceAll(".root", "_broadened.root"));
   }
+  std::atomic<int> nDone(0);
+  std::mutex printMutex;
+
+  auto load = [&](size_t i) {
+    if (firstTime) {
+      tmSims[i] = new TreeModule(inputFiles[i].Data());
+      tmSims[i]->broadenAndStoreEnergy();
+    } else {
+      tmBroads[i] = new BroadTree(broadenedFiles[i].Data());
+    }
+    std::lock_guard<std::mutex> lock(printMutex);
+    std::cout << "[" << ++nDone << "/" << nInputs << "] "
+              << (firstTime ? "Broadened " : "Loaded ")
+              << (firstTime ? inputFiles[i] : broadenedFiles[i]) << std::endl;
+    return 0;
+  };
+
+  // once, on this thread: the RDataFrame fills inside the tasks then share
+  // the pool's threads instead of each task enabling implicit MT
+  if (!ROOT::IsImplicitMTEnabled())
+    ROOT::EnableImplicitMT();
+  ROOT::TThreadExecutor pool;
+  pool.Map(load, ROOT::TSeqUL(nInputs));
+}
+
+void Analysis::styleHist(TH1D *hist, size_t index) {
+  const Color_t colors[] = {kRed, kBlue, kGreen, kCyan, kYellow, kMagenta};
+  Color_t color = colors[index % 6];
+  Short_t lineWidth = 2;
+  hist->SetLineWidth(lineWidth);
+  hist->SetLineColor(color);
+  hist->SetFillColor(TColor::GetColorTransparent(color, 0.5));
 }
 
 void Analysis::drawHists(const TString detectorName, bool isNormed) {
@@ -80,46 +94,24 @@ void Analysis::drawHists(const TString detectorName, bool isNormed) {
     stack = SiLiStack;
   }
   ClearTHStack(stack);
-  TH1D *histBroad0 = tmBroad0->energySpectrumHist(detectorName);
-  TH1D *histBroad1 = tmBroad1->energySpectrumHist(detectorName);
-  TH1D *histBroad2 = tmBroad2->energySpectrumHist(detectorName);
-  TH1D *histBroad3 = tmBroad3->energySpectrumHist(detectorName);
-  TH1D *histBroad4 = tmBroad4->energySpectrumHist(detectorName);
-  TH1D *histBroad5 = tmBroad5->energySpectrumHist(detectorName);
+  std::vector<TH1D *> histBroads;
+  for (BroadTree *tmBroad : tmBroads) {
+    histBroads.push_back(tmBroad->energySpectrumHist(detectorName));
+  }
 
   // Set axis properties for thicker lines and tick marks
   gStyle->SetLineWidth(2);
   gStyle->SetHistLineWidth(2);
   gStyle->SetFrameLineWidth(2);
   // Set fill colors and styles
-  Short_t lineWidth = 2;
-  histBroad0->SetLineWidth(lineWidth);
-  histBroad1->SetLineWidth(lineWidth);
-  histBroad2->SetLineWidth(lineWidth);
-  histBroad3->SetLineWidth(lineWidth);
-  histBroad4->SetLineWidth(lineWidth);
-  histBroad5->SetLineWidth(lineWidth);
-  histBroad0->SetLineColor(kRed);
-  histBroad1->SetLineColor(kBlue);
-  histBroad2->SetLineColor(kGreen);
-  histBroad3->SetLineColor(kCyan);
-  histBroad4->SetLineColor(kYellow);
-  histBroad5->SetLineColor(kMagenta);
-
-  histBroad0->SetFillColor(TColor::GetColorTransparent(kRed, 0.5));
-  histBroad1->SetFillColor(TColor::GetColorTransparent(kBlue, 0.5));
-  histBroad2->SetFillColor(TColor::GetColorTransparent(kGreen, 0.5));
-  histBroad3->SetFillColor(TColor::GetColorTransparent(kCyan, 0.5));
-  histBroad4->SetFillColor(TColor::GetColorTransparent(kYellow, 0.5));
-  histBroad5->SetFillColor(TColor::GetColorTransparent(kMagenta, 0.5));
+  for (size_t i = 0; i < histBroads.size(); ++i) {
+    styleHist(histBroads[i], i);
+  }
 
   if (isNormed) {
-    histBroad0->Scale(1.0 / histBroad0->Integral());
-    histBroad1->Scale(1.0 / histBroad1->Integral());
-    histBroad2->Scale(1.0 / histBroad2->Integral());
-    histBroad3->Scale(1.0 / histBroad3->Integral());
-    histBroad4->Scale(1.0 / histBroad4->Integral());
-    histBroad5->Scale(1.0 / histBroad5->Integral());
+    for (TH1D *histBroad : histBroads) {
+      histBroad->Scale(1.0 / histBroad->Integral());
+    }
     fileName += "Normed";
     yTitle = "Counts / # of Incident Neutrons";
   }
@@ -130,12 +122,10 @@ void Analysis::drawHists(const TString detectorName, bool isNormed) {
   c1->SetBottomMargin(
       0.15); // Set the bottom margin to 15% of the canvas height
 
-  stack->Add(histBroad5);
-  stack->Add(histBroad4);
-  stack->Add(histBroad3);
-  stack->Add(histBroad2);
-  stack->Add(histBroad1);
-  stack->Add(histBroad0);
+  // largest sample at the back
+  for (size_t i = histBroads.size(); i-- > 0;) {
+    stack->Add(histBroads[i]);
+  }
   stack->Draw("nostack");
   stack->GetXaxis()->SetTitle("Energy (keV)");
   stack->GetYaxis()->SetTitle(yTitle);
@@ -164,55 +154,29 @@ void Analysis::drawPartialHists(const TString detectorName, double lowerBound,
     stackPartial = SiLiStackPartial;
   }
   ClearTHStack(stackPartial);
-  TH1D *histBroad0 =
-      tmBroad0->energySpectrumHist(detectorName, lowerBound, upperBound, nbins);
-  TH1D *histBroad1 =
-      tmBroad1->energySpectrumHist(detectorName, lowerBound, upperBound, nbins);
-  TH1D *histBroad2 =
-      tmBroad2->energySpectrumHist(detectorName, lowerBound, upperBound, nbins);
-  TH1D *histBroad3 =
-      tmBroad3->energySpectrumHist(detectorName, lowerBound, upperBound, nbins);
-  TH1D *histBroad4 =
-      tmBroad4->energySpectrumHist(detectorName, lowerBound, upperBound, nbins);
-  TH1D *histBroad5 =
-      tmBroad5->energySpectrumHist(detectorName, lowerBound, upperBound, nbins);
+  std::vector<TH1D *> histBroads;
+  for (BroadTree *tmBroad : tmBroads) {
+    histBroads.push_back(tmBroad->energySpectrumHist(detectorName, lowerBound,
+                                                     upperBound, nbins));
+  }
 
   // Set axis properties for thicker lines and tick marks
   gStyle->SetLineWidth(2);
   gStyle->SetHistLineWidth(2);
   gStyle->SetFrameLineWidth(2);
   // Set fill colors and styles
-  Short_t lineWidth = 2;
-  histBroad0->SetLineWidth(lineWidth);
-  histBroad1->SetLineWidth(lineWidth);
-  histBroad2->SetLineWidth(lineWidth);
-  histBroad3->SetLineWidth(lineWidth);
-  histBroad4->SetLineWidth(lineWidth);
-  histBroad5->SetLineWidth(lineWidth);
-  histBroad0->SetLineColor(kRed);
-  histBroad1->SetLineColor(kBlue);
-  histBroad2->SetLineColor(kGreen);
-  histBroad3->SetLineColor(kCyan);
-  histBroad4->SetLineColor(kYellow);
-  histBroad5->SetLineColor(kMagenta);
-  histBroad0->SetFillColor(TColor::GetColorTransparent(kRed, 0.5));
-  histBroad1->SetFillColor(TColor::GetColorTransparent(kBlue, 0.5));
-  histBroad2->SetFillColor(TColor::GetColorTransparent(kGreen, 0.5));
-  histBroad3->SetFillColor(TColor::GetColorTransparent(kCyan, 0.5));
-  histBroad4->SetFillColor(TColor::GetColorTransparent(kYellow, 0.5));
-  histBroad5->SetFillColor(TColor::GetColorTransparent(kMagenta, 0.5));
+  for (size_t i = 0; i < histBroads.size(); ++i) {
+    styleHist(histBroads[i], i);
+  }
 
   TString fileName = Form("partialHist_%."
                           "2f_%.2f",
                           lowerBound, upperBound);
 
   if (isNormed) {
-    histBroad0->Scale(1.0 / histBroad0->Integral());
-    histBroad1->Scale(1.0 / histBroad1->Integral());
-    histBroad2->Scale(1.0 / histBroad2->Integral());
-    histBroad3->Scale(1.0 / histBroad3->Integral());
-    histBroad4->Scale(1.0 / histBroad4->Integral());
-    histBroad5->Scale(1.0 / histBroad5->Integral());
+    for (TH1D *histBroad : histBroads) {
+      histBroad->Scale(1.0 / histBroad->Integral());
+    }
     fileName += "Normed";
     yTitle = "Log Normalized Counts";
   }
@@ -228,18 +192,21 @@ void Analysis::drawPartialHists(const TString detectorName, double lowerBound,
   legend->SetTextSize(0.025);
   legend->SetFillColor(0);
   legend->SetHeader("68.75 keV Peak Position Errors", "C");
-  fitGaussianToPeak(legend, histBroad0, 68.75, 5, "0.267 min");
-  fitGaussianToPeak(legend, histBroad1, 68.75, 5, "1.3 min");
-  fitGaussianToPeak(legend, histBroad2, 68.75, 5, "2.67 min");
-  fitGaussianToPeak(legend, histBroad3, 68.75, 5, "13.3 min");
-  fitGaussianToPeak(legend, histBroad4, 68.75, 5, "26.7 min");
-  fitGaussianToPeak(legend, histBroad5, 68.75, 5, "267 min");
-  stackPartial->Add(histBroad5);
-  stackPartial->Add(histBroad4);
-  stackPartial->Add(histBroad3);
-  stackPartial->Add(histBroad2);
-  stackPartial->Add(histBroad1);
-  stackPartial->Add(histBroad0);
+  // all spectra are fitted at once, see PeakFitter
+  std::vector<PeakFitJob> jobs;
+  for (size_t i = 0; i < histBroads.size(); ++i) {
+    jobs.push_back(
+        {histBroads[i], 68.75 - 5, 68.75 + 5, 68.75, inputLabels[i]});
+  }
+  std::vector<PeakFitResult> results = peakFitter.fitAll(jobs);
+  for (size_t i = 0; i < histBroads.size(); ++i) {
+    addPeakFit(legend, histBroads[i], results[i], 68.75 - 5, 68.75 + 5);
+  }
+  PeakFitter::printTable(results);
+  PeakFitter::writeTable(results, fileName + detectorName + "_fits.csv");
+  for (size_t i = histBroads.size(); i-- > 0;) {
+    stackPartial->Add(histBroads[i]);
+  }
   stackPartial->Draw("nostack, HIST");
   stackPartial->GetXaxis()->SetTitle("Energy (keV)");
   stackPartial->GetYaxis()->SetTitle(yTitle);
@@ -274,30 +241,26 @@ void Analysis::ClearTHStack(THStack *stack) {
 void Analysis::fitGaussianToPeak(TLegend *legend, TH1D *hist,
                                  double peak = 68.75, double range = 5,
                                  TString measurementTime = "") {
-  // Define the fit range around the peak position
-  double fitRangeMin = peak - range;
-  double fitRangeMax = peak + range;
-  // Define the Gaussian function
-  TF1 *gaussFit = new TF1("gaussFit", "gaus + [3]*x*x + [4]*x + [5]",
-                          fitRangeMin, fitRangeMax);
+  PeakFitResult result = peakFitter.fit(
+      {hist, peak - range, peak + range, peak, measurementTime});
+  addPeakFit(legend, hist, result, peak - range, peak + range);
+}
 
-  // Initial parameters: [0] = height, [1] = mean, [2] = sigma
-  gaussFit->SetParameters(hist->GetMaximum(), peak, 1.0);
+void Analysis::addPeakFit(TLegend *legend, TH1D *hist,
+                          const PeakFitResult &result, double lowerBound,
+                          double upperBound) {
+  TF1 *gaussFit = PeakFitter::makeFunction(result, lowerBound, upperBound);
   // Set the color for the fit from the histogram's color
   gaussFit->SetLineColor(hist->GetLineColor());
-  gaussFit->Draw();
-  // Perform the fit
-  hist->Fit(gaussFit, "RQ");
-  // Retrieve fit parameters and their uncertainties
-  double peakMean = gaussFit->GetParameter(1);
-  double peakMeanError = gaussFit->GetParError(1);
+  // drawn with the histogram, as TH1::Fit would
+  hist->GetListOfFunctions()->Add(gaussFit);
   // Create the legend
   legend->AddEntry(gaussFit,
-                   measurementTime + ": " +
-                       TString::Format("#pm %.3f keV", peakMeanError),
+                   result.label + ": " +
+                       TString::Format("#pm %.3f keV", result.centroidError),
                    "l");
 
   // Output fit results to console
-  std::cout << "Peak position (mean): " << peakMean << " ± " << peakMeanError 
-            << " keV" << std::endl;
+  std::cout << "Peak position (mean): " << result.centroid << " ± "
+            << result.centroidError << " keV" << std::endl;
 }
@@ -0,0 +1,193 @@
+#include "../include/Bootstrap.hh"
+
+Bootstrap::Bootstrap(TH1D *spectrum, double parentEvents, double parentMinutes,
+                     double peak, double range, unsigned long seed)
+    : spectrum(spectrum), parentEvents(parentEvents),
+      parentMinutes(parentMinutes), peak(peak), range(range), seed(seed) {}
+
+// Bin contents of the replicas for one exposure, each exposure gets its own
+// random stream so the result does not depend on the thread scheduling
+std::vector<std::vector<double>>
+Bootstrap::replicate(double fraction, int replicas, Mode mode,
+                     unsigned long stream) const {
+  TRandom3 random(seed + stream);
+  int nbins = spectrum->GetNbinsX();
+  std::vector<std::vector<double>> contents(replicas,
+                                            std::vector<double>(nbins + 2));
+  for (int i = 1; i <= nbins; ++i) {
+    double content = spectrum->GetBinContent(i);
+    if (content <= 0.)
+      continue;
+    if (mode == kPoisson) {
+      for (int r = 0; r < replicas; ++r)
+        contents[r][i] = random.Poisson(content * fraction);
+    } else {
+      // sequential binomial split of the bin into disjoint subsets
+      int remaining = std::lround(content);
+      double left = 1.;
+      for (int r = 0; r < replicas && remaining > 0; ++r) {
+        int drawn = random.Binomial(remaining, std::min(fraction / left, 1.));
+        contents[r][i] = drawn;
+        remaining -= drawn;
+        left -= fraction;
+      }
+    }
+  }
+  return contents;
+}
+
+std::vector<ExposurePoint> Bootstrap::run(const std::vector<double> &minutes,
+                                          int replicas, Mode mode) const {
+  std::vector<ExposurePoint> points;
+  ROOT::EnableThreadSafety();
+  Bool_t addDirectory = TH1::AddDirectoryStatus();
+  TH1::AddDirectory(kFALSE);
+
+  for (size_t e = 0; e < minutes.size(); ++e) {
+    double fraction = minutes[e] / parentMinutes;
+    int nReplicas = replicas;
+    if (mode == kSubsets) {
+      int available = (int)std::floor(1. / fraction);
+      if (available < 2) {
+        std::cerr << "Cannot draw disjoint subsets of " << minutes[e]
+                  << " min from " << parentMinutes << " min, skipped"
+                  << std::endl;
+        continue;
+      }
+      nReplicas = std::min(replicas, available);
+    }
+
+    std::vector<std::vector<double>> contents =
+        replicate(fraction, nReplicas, mode, e);
+    std::vector<PeakFitResult> results;
+    {
+      ROOT::TThreadExecutor pool;
+      results = pool.Map(
+          [&](size_t r) {
+            TH1D replica(*spectrum);
+            replica.Reset();
+            for (size_t i = 0; i < contents[r].size(); ++i) {
+              replica.SetBinContent(i, contents[r][i]);
+              replica.SetBinError(i, std::sqrt(contents[r][i]));
+            }
+            return peakFitter.fit({&replica, peak - range, peak + range, peak,
+                                   TString::Format("%zu", r)});
+          },
+          ROOT::TSeqUL(nReplicas));
+    }
+
+    ExposurePoint point = {};
+    point.minutes = minutes[e];
+    point.events = parentEvents * fraction;
+    point.replicas = nReplicas;
+    double sum = 0., sum2 = 0., sumError = 0., sumSigma = 0., sumSigma2 = 0.;
+    for (const PeakFitResult &result : results) {
+      if (!result.converged)
+        continue;
+      ++point.converged;
+      sum += result.centroid;
+      sum2 += result.centroid * result.centroid;
+      sumError += result.centroidError;
+      sumSigma += result.sigma;
+      sumSigma2 += result.sigma * result.sigma;
+    }
+    int n = point.converged;
+    if (n > 1) {
+      point.centroidMean = sum / n;
+      point.centroidSpread =
+          std::sqrt(std::max(0., (sum2 - sum * sum / n) / (n - 1)));
+      point.centroidFitError = sumError / n;
+      point.sigmaMean = sumSigma / n;
+      point.sigmaSpread = std::sqrt(
+          std::max(0., (sumSigma2 - sumSigma * sumSigma / n) / (n - 1)));
+    }
+    points.push_back(point);
+    std::cout << "Exposure " << minutes[e] << " min: " << n << "/"
+              << nReplicas << " replicas fitted" << std::endl;
+  }
+
+  TH1::AddDirectory(addDirectory);
+  return points;
+}
+
+void Bootstrap::printTable(const std::vector<ExposurePoint> &points) {
+  std::cout << TString::Format("%10s %12s %9s %12s %12s %12s %10s",
+                               "Minutes", "Events", "Replicas", "Centroid",
+                               "Spread", "Fit error", "Sigma")
+            << std::endl;
+  for (const ExposurePoint &point : points) {
+    std::cout << TString::Format("%10.3f %12.4g %5d/%-3d %12.5f %12.5f "
+                                 "%12.5f %10.4f",
+                                 point.minutes, point.events, point.converged,
+                                 point.replicas, point.centroidMean,
+                                 point.centroidSpread, point.centroidFitError,
+                                 point.sigmaMean)
+              << std::endl;
+  }
+}
+
+void Bootstrap::writeTable(const std::vector<ExposurePoint> &points,
+                           const char *fileName) {
+  std::ofstream table(fileName);
+  table << "minutes,events,replicas,converged,centroid_mean,centroid_spread,"
+           "centroid_fit_error,sigma_mean,sigma_spread"
+        << std::endl;
+  for (const ExposurePoint &point : points) {
+    table << point.minutes << "," << point.events << "," << point.replicas
+          << "," << point.converged << "," << point.centroidMean << ","
+          << point.centroidSpread << "," << point.centroidFitError << ","
+          << point.sigmaMean << "," << point.sigmaSpread << std::endl;
+  }
+}
+
+void Bootstrap::drawErrorVsExposure(const std::vector<ExposurePoint> &points,
+                                    const char *fileName) {
+  TGraphErrors *spread = new TGraphErrors();
+  TGraphErrors *fitError = new TGraphErrors();
+  for (const ExposurePoint &point : points) {
+    if (point.converged < 2)
+      continue;
+    int i = spread->GetN();
+    spread->SetPoint(i, point.minutes, point.centroidSpread);
+    // standard error of a standard deviation estimated from n replicas
+    spread->SetPointError(
+        i, 0., point.centroidSpread / std::sqrt(2. * (point.converged - 1)));
+    fitError->SetPoint(i, point.minutes, point.centroidFitError);
+  }
+
+  TCanvas *c1 = new TCanvas("bootstrap", "c1", 2000, 1500);
+  c1->SetLeftMargin(0.15);
+  c1->SetBottomMargin(0.15);
+  c1->SetLogx();
+  c1->SetLogy();
+  spread->SetTitle(";Measurement Time (min);Peak Position Error (keV)");
+  spread->SetMarkerStyle(20);
+  spread->SetMarkerSize(2);
+  spread->SetMarkerColor(kBlue);
+  spread->Draw("AP");
+  fitError->SetMarkerStyle(24);
+  fitError->SetMarkerSize(2);
+  fitError->SetMarkerColor(kRed);
+  fitError->Draw("P SAME");
+
+  // statistics-limited scaling, error proportional to 1/sqrt(time)
+  TF1 *scaling = new TF1("scaling", "[0]/sqrt(x)", 1e-3, 1e6);
+  scaling->SetLineColor(kBlue);
+  scaling->SetLineStyle(2);
+  spread->Fit(scaling, "Q");
+
+  TLegend *legend = new TLegend(0.55, 0.7, 0.9, 0.88);
+  legend->AddEntry(spread, "Replica spread", "p");
+  legend->AddEntry(fitError, "Mean fit error", "p");
+  legend->AddEntry(scaling,
+                   TString::Format("%.3f keV #sqrt{min} / #sqrt{t}",
+                                   scaling->GetParameter(0)),
+                   "l");
+  legend->Draw();
+  c1->Update();
+  c1->Print(fileName);
+  delete legend;
+  delete c1;
+  delete spread;
+  delete fitError;
+}
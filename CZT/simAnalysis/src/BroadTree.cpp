@@ -3,27 +3,40 @@
 BroadTree::BroadTree(const char *filename) {
   aFilename = filename;
   aFile = new TFile(filename, "READ");
+  energyTreeCZT = nullptr;
+  energyTreeHPGe = nullptr;
+  energyTreeSiLi = nullptr;
+  branchEnergyDepCZT = nullptr;
+  branchEnergyDepHPGe = nullptr;
+  branchEnergyDepSiLi = nullptr;
+  broadHistCZT = nullptr;
+  broadHistHPGe = nullptr;
+  broadHistSiLi = nullptr;
   if (aFile->IsOpen()) {
+    aFile->GetObject("BroadenedHistCZT", broadHistCZT);
+    aFile->GetObject("BroadenedHistHPGe", broadHistHPGe);
+    aFile->GetObject("BroadenedHistSiLi", broadHistSiLi);
+    // files broadened before the spectra were stored as histograms
     energyTreeCZT = static_cast<TTree *>(aFile->Get("BroadenedEnergyCZT;"));
     energyTreeHPGe = static_cast<TTree *>(aFile->Get("BroadenedEnergyHPGe;"));
     energyTreeSiLi = static_cast<TTree *>(aFile->Get("BroadenedEnergySiLi"));
-    branchEnergyDepCZT = energyTreeCZT->GetBranch("fEdepCZT");
-    branchEnergyDepHPGe = energyTreeHPGe->GetBranch("fEdepHPGe");
-    branchEnergyDepSiLi = energyTreeSiLi->GetBranch("fEdepSiLi");
+    if (energyTreeCZT)
+      branchEnergyDepCZT = energyTreeCZT->GetBranch("fEdepCZT");
+    if (energyTreeHPGe)
+      branchEnergyDepHPGe = energyTreeHPGe->GetBranch("fEdepHPGe");
+    if (energyTreeSiLi)
+      branchEnergyDepSiLi = energyTreeSiLi->GetBranch("fEdepSiLi");
   } else {
     std::cerr << "Failed to open the file: " << filename << std::endl;
     aFile = nullptr;
-    energyTreeCZT = nullptr;
-    energyTreeHPGe = nullptr;
-    energyTreeSiLi = nullptr;
-    branchEnergyDepCZT = nullptr;
-    branchEnergyDepHPGe = nullptr;
-    branchEnergyDepSiLi = nullptr;
   }
 }
 
 BroadTree::~BroadTree() {
   std::cout << "Deleting BroadTree..." << std::endl;
+  for (auto &cached : spectrumCache) {
+    delete cached.second;
+  }
   if (aFile) {
     aFile->Close();
     delete aFile;
@@ -68,35 +81,77 @@ TH1D *BroadTree::energySpectrumHist(const TString detectorName,
                                     double lowerBound = 0,
                                     double upperBound = 100, int nbins = 829) {
 
-  double eDep;
+  // every (detector, binning) is only read once, callers get their own copy
+  // since they rescale and restyle it
+  TString key = TString::Format("%s_%g_%g_%d", detectorName.Data(),
+                                lowerBound, upperBound, nbins);
+  auto cached = spectrumCache.find(key);
+  if (cached == spectrumCache.end()) {
+    TH1D *filled = fillSpectrum(detectorName, lowerBound, upperBound, nbins);
+    filled->SetDirectory(nullptr);
+    cached = spectrumCache.emplace(key, filled).first;
+  }
+
+  TH1D *hist =
+      static_cast<TH1D *>(cached->second->Clone(generateRandomString()));
+  hist->SetDirectory(nullptr);
+  hist->SetStats(0);
+  return hist;
+}
+
+TH1D *BroadTree::fillSpectrum(const TString detectorName, double lowerBound,
+                              double upperBound, int nbins) {
   double etemp;
-  int entries = 0;
   TH1D *hist = nullptr;
+  TH1D *broadHist = nullptr;
   TBranch *branchEnergyDep = nullptr;
 
   if (detectorName == "CZT") {
-    entries = branchEnergyDepCZT->GetEntries();
+    broadHist = broadHistCZT;
     branchEnergyDep = branchEnergyDepCZT;
   } else if (detectorName == "HPGe") {
-    entries = branchEnergyDepHPGe->GetEntries();
+    broadHist = broadHistHPGe;
     branchEnergyDep = branchEnergyDepHPGe;
   } else if (detectorName == "SiLi") {
-    entries = branchEnergyDepSiLi->GetEntries();
+    broadHist = broadHistSiLi;
     branchEnergyDep = branchEnergyDepSiLi;
   }
 
-  branchEnergyDep->SetAddress(&eDep);
   TString histName = generateRandomString();
   hist = new TH1D(histName, ";Energy (keV);Entries", nbins, lowerBound,
                   upperBound);
-  for (int i = 0; i < entries; i++) {
-    branchEnergyDep->GetEntry(i);
-    etemp = eDep;
-    if (etemp >= lowerBound && etemp <= upperBound) {
-      hist->Fill(etemp);
+
+  if (broadHist) {
+    // rebin the stored spectrum, each bin's counts go to its centre like
+    // the per-count tree entries used to. The contents are counts, not
+    // weights, so the errors stay sqrt(content) without Sumw2
+    double entries = 0.;
+    for (int i = 1; i <= broadHist->GetNbinsX(); i++) {
+      etemp = broadHist->GetBinCenter(i);
+      double counts = broadHist->GetBinContent(i);
+      if (counts != 0. && etemp >= lowerBound && etemp <= upperBound) {
+        hist->AddBinContent(hist->FindBin(etemp), counts);
+        entries += counts;
+      }
     }
+    hist->SetEntries(entries);
+  } else if (branchEnergyDep) {
+    ROOT::RDataFrame frame(*branchEnergyDep->GetTree());
+    auto filled =
+        frame
+            .Filter(
+                [lowerBound, upperBound](double eDep) {
+                  return eDep >= lowerBound && eDep <= upperBound;
+                },
+                {branchEnergyDep->GetName()})
+            .Histo1D<double>(
+                {histName + "_df", "", nbins, lowerBound, upperBound},
+                branchEnergyDep->GetName());
+    hist->Add(filled.GetPtr());
+  } else {
+    std::cerr << "No broadened " << detectorName << " spectrum in "
+              << aFilename << std::endl;
   }
 
-  hist->SetStats(0);
   return hist;
 }
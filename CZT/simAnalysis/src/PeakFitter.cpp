@@ -0,0 +1,295 @@
+#include "../include/PeakFitter.hh"
+
+PeakFitter::PeakFitter(int maxIterations, double tolerance)
+    : maxIterations(maxIterations), tolerance(tolerance) {}
+
+// The background is fitted in u = x - x0 around the window centre, which
+// keeps the normal equations well conditioned; see fit()
+double PeakFitter::model(const std::array<double, PeakFitResult::nPars> &p,
+                         double x) {
+  double d = (x - p[1]) / p[2];
+  return p[0] * std::exp(-0.5 * d * d) + p[3] * x * x + p[4] * x + p[5];
+}
+
+void PeakFitter::gradient(const std::array<double, PeakFitResult::nPars> &p,
+                          double x, double *grad) {
+  double d = (x - p[1]) / p[2];
+  double g = std::exp(-0.5 * d * d);
+  grad[0] = g;
+  grad[1] = p[0] * g * d / p[2];
+  grad[2] = p[0] * g * d * d / p[2];
+  grad[3] = x * x;
+  grad[4] = x;
+  grad[5] = 1.;
+}
+
+// Gaussian elimination with partial pivoting, a is 6x6 row-major
+bool PeakFitter::solve(std::array<double, 36> a, std::array<double, 6> b,
+                       std::array<double, 6> &x) {
+  const int n = 6;
+  for (int col = 0; col < n; ++col) {
+    int pivot = col;
+    for (int row = col + 1; row < n; ++row) {
+      if (std::abs(a[row * n + col]) > std::abs(a[pivot * n + col]))
+        pivot = row;
+    }
+    if (a[pivot * n + col] == 0.)
+      return false;
+    if (pivot != col) {
+      for (int k = 0; k < n; ++k)
+        std::swap(a[col * n + k], a[pivot * n + k]);
+      std::swap(b[col], b[pivot]);
+    }
+    for (int row = col + 1; row < n; ++row) {
+      double factor = a[row * n + col] / a[col * n + col];
+      for (int k = col; k < n; ++k)
+        a[row * n + k] -= factor * a[col * n + k];
+      b[row] -= factor * b[col];
+    }
+  }
+  for (int row = n - 1; row >= 0; --row) {
+    double sum = b[row];
+    for (int k = row + 1; k < n; ++k)
+      sum -= a[row * n + k] * x[k];
+    x[row] = sum / a[row * n + row];
+  }
+  return true;
+}
+
+bool PeakFitter::invert(const std::array<double, 36> &a,
+                        std::array<double, 36> &inverse) {
+  for (int col = 0; col < 6; ++col) {
+    std::array<double, 6> unit = {}, column = {};
+    unit[col] = 1.;
+    if (!solve(a, unit, column))
+      return false;
+    for (int row = 0; row < 6; ++row)
+      inverse[row * 6 + col] = column[row];
+  }
+  return true;
+}
+
+PeakFitResult PeakFitter::fit(const PeakFitJob &job) const {
+  const int n = PeakFitResult::nPars;
+  PeakFitResult result;
+  result.label = job.label;
+
+  // bins with their centre in the window and a non-zero error, like
+  // TH1::Fit with the "R" option
+  std::vector<double> xs, ys, weights;
+  const TH1D *hist = job.hist;
+  double x0 = 0.5 * (job.lowerBound + job.upperBound);
+  for (int i = 1; i <= hist->GetNbinsX(); ++i) {
+    double x = hist->GetBinCenter(i);
+    double error = hist->GetBinError(i);
+    if (x < job.lowerBound || x > job.upperBound || error <= 0.)
+      continue;
+    xs.push_back(x - x0);
+    ys.push_back(hist->GetBinContent(i));
+    weights.push_back(1. / (error * error));
+  }
+  result.ndf = (int)xs.size() - n;
+  if (result.ndf <= 0)
+    return result;
+
+  // starting values: flat background from the window edges, the highest
+  // bin near the requested peak, and the width at half maximum
+  std::array<double, n> p = {};
+  double background = 0.5 * (ys.front() + ys.back());
+  size_t top = 0;
+  for (size_t i = 0; i < xs.size(); ++i) {
+    if (ys[i] > ys[top])
+      top = i;
+  }
+  p[0] = std::max(ys[top] - background, 1.);
+  p[1] = job.peak - x0;
+  size_t left = top, right = top;
+  while (left > 0 && ys[left] - background > 0.5 * p[0])
+    --left;
+  while (right + 1 < xs.size() && ys[right] - background > 0.5 * p[0])
+    ++right;
+  p[2] = std::max((xs[right] - xs[left]) / 2.355, 1e-3);
+  p[5] = background;
+
+  auto chi2Of = [&](const std::array<double, n> &q) {
+    double chi2 = 0.;
+    for (size_t i = 0; i < xs.size(); ++i) {
+      double r = ys[i] - model(q, xs[i]);
+      chi2 += weights[i] * r * r;
+    }
+    return chi2;
+  };
+  auto normalEquations = [&](const std::array<double, n> &q,
+                             std::array<double, 36> &alpha,
+                             std::array<double, 6> &beta) {
+    alpha.fill(0.);
+    beta.fill(0.);
+    double grad[n];
+    for (size_t i = 0; i < xs.size(); ++i) {
+      gradient(q, xs[i], grad);
+      double r = ys[i] - model(q, xs[i]);
+      for (int j = 0; j < n; ++j) {
+        beta[j] += weights[i] * r * grad[j];
+        for (int k = 0; k <= j; ++k)
+          alpha[j * n + k] += weights[i] * grad[j] * grad[k];
+      }
+    }
+    for (int j = 0; j < n; ++j) {
+      for (int k = j + 1; k < n; ++k)
+        alpha[j * n + k] = alpha[k * n + j];
+    }
+  };
+
+  double chi2 = chi2Of(p);
+  double lambda = 1e-3;
+  std::array<double, 36> alpha;
+  std::array<double, 6> beta;
+  for (result.iterations = 0; result.iterations < maxIterations;
+       ++result.iterations) {
+    normalEquations(p, alpha, beta);
+    bool improved = false;
+    while (lambda < 1e10) {
+      std::array<double, 36> damped = alpha;
+      for (int j = 0; j < n; ++j)
+        damped[j * n + j] *= 1. + lambda;
+      std::array<double, 6> step = {};
+      std::array<double, n> trial = p;
+      if (solve(damped, beta, step)) {
+        for (int j = 0; j < n; ++j)
+          trial[j] += step[j];
+      }
+      double trialChi2 = trial[2] > 0. ? chi2Of(trial) : chi2 + 1.;
+      if (trialChi2 <= chi2) {
+        improved = true;
+        result.converged = chi2 - trialChi2 <= tolerance * (chi2 + tolerance);
+        p = trial;
+        chi2 = trialChi2;
+        lambda = std::max(lambda / 10., 1e-12);
+        break;
+      }
+      lambda *= 10.;
+    }
+    if (!improved) {
+      // no step lowers chi2 any more: we are at the minimum
+      result.converged = true;
+      break;
+    }
+    if (result.converged)
+      break;
+  }
+
+  normalEquations(p, alpha, beta);
+  std::array<double, 36> covU = {};
+  if (!invert(alpha, covU)) {
+    result.converged = false;
+    return result;
+  }
+
+  // back from u = x - x0 to x for the background and centroid:
+  // q u^2 + l u + c = q x^2 + (l - 2 q x0) x + (q x0^2 - l x0 + c)
+  std::array<double, 36> t = {};
+  t[0 * n + 0] = 1.;
+  t[2 * n + 2] = 1.;
+  t[1 * n + 1] = 1.;
+  t[3 * n + 3] = 1.;
+  t[4 * n + 3] = -2. * x0;
+  t[4 * n + 4] = 1.;
+  t[5 * n + 3] = x0 * x0;
+  t[5 * n + 4] = -x0;
+  t[5 * n + 5] = 1.;
+  result.pars = {p[0],
+                 p[1] + x0,
+                 p[2],
+                 p[3],
+                 p[4] - 2. * p[3] * x0,
+                 p[3] * x0 * x0 - p[4] * x0 + p[5]};
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) {
+      double sum = 0.;
+      for (int k = 0; k < n; ++k) {
+        for (int l = 0; l < n; ++l)
+          sum += t[i * n + k] * covU[k * n + l] * t[j * n + l];
+      }
+      result.covariance[i * n + j] = sum;
+    }
+  }
+
+  result.chi2 = chi2;
+  result.centroid = result.pars[1];
+  result.centroidError = result.error(1);
+  result.sigma = std::abs(result.pars[2]);
+  result.sigmaError = result.error(2);
+  // counts under the Gaussian, in entries rather than entries x keV
+  double binWidth = hist->GetBinWidth(1);
+  double norm = TMath::Sqrt(2. * TMath::Pi()) / binWidth;
+  result.area = norm * result.pars[0] * result.sigma;
+  double dA = norm * result.sigma;
+  double dS = norm * result.pars[0];
+  result.areaError = std::sqrt(dA * dA * result.covariance[0] +
+                               dS * dS * result.covariance[2 * n + 2] +
+                               2. * dA * dS * result.covariance[2]);
+  return result;
+}
+
+std::vector<PeakFitResult>
+PeakFitter::fitAll(const std::vector<PeakFitJob> &jobs,
+                   unsigned nThreads) const {
+  ROOT::TThreadExecutor pool(nThreads);
+  return pool.Map([&](size_t i) { return fit(jobs[i]); },
+                  ROOT::TSeqUL(jobs.size()));
+}
+
+TF1 *PeakFitter::makeFunction(const PeakFitResult &result, double lowerBound,
+                              double upperBound) {
+  TF1 *function = new TF1("gaussFit_" + result.label,
+                          "gaus + [3]*x*x + [4]*x + [5]", lowerBound,
+                          upperBound);
+  for (int i = 0; i < PeakFitResult::nPars; ++i) {
+    function->SetParameter(i, result.pars[i]);
+    function->SetParError(i, result.error(i));
+  }
+  function->SetChisquare(result.chi2);
+  function->SetNDF(result.ndf);
+  return function;
+}
+
+void PeakFitter::printTable(const std::vector<PeakFitResult> &results) {
+  std::cout << TString::Format("%-16s %12s %10s %10s %10s %14s %12s %10s",
+                               "Label", "Centroid", "Error", "Sigma", "Error",
+                               "Area", "Error", "Chi2/NDF")
+            << std::endl;
+  for (const PeakFitResult &result : results) {
+    std::cout << TString::Format(
+                     "%-16s %12.5f %10.5f %10.5f %10.5f %14.1f %12.1f %10.3f%s",
+                     result.label.Data(), result.centroid,
+                     result.centroidError, result.sigma, result.sigmaError,
+                     result.area, result.areaError,
+                     result.ndf > 0 ? result.chi2 / result.ndf : 0.,
+                     result.converged ? "" : "  (not converged)")
+              << std::endl;
+  }
+}
+
+void PeakFitter::writeTable(const std::vector<PeakFitResult> &results,
+                            const char *fileName) {
+  std::ofstream table(fileName);
+  table << "label,centroid,centroid_error,sigma,sigma_error,area,area_error,"
+           "chi2,ndf,converged";
+  for (int i = 0; i < PeakFitResult::nPars; ++i) {
+    for (int j = 0; j <= i; ++j)
+      table << ",cov" << i << j;
+  }
+  table << std::endl;
+  for (const PeakFitResult &result : results) {
+    table << result.label << "," << result.centroid << ","
+          << result.centroidError << "," << result.sigma << ","
+          << result.sigmaError << "," << result.area << ","
+          << result.areaError << "," << result.chi2 << "," << result.ndf
+          << "," << result.converged;
+    for (int i = 0; i < PeakFitResult::nPars; ++i) {
+      for (int j = 0; j <= i; ++j)
+        table << "," << result.covariance[i * PeakFitResult::nPars + j];
+    }
+    table << std::endl;
+  }
+}
@@ -0,0 +1,147 @@
+#include "../include/ResponseMatrix.hh"
+
+ResponseMatrix::ResponseMatrix(const char *fileName, const char *responseName,
+                               const char *primariesName)
+    : nTrue(0), nDeposit(0), depositLow(0.), depositHigh(0.) {
+  TFile *file = new TFile(fileName, "READ");
+  if (!file->IsOpen()) {
+    std::cerr << "Failed to open the file: " << fileName << std::endl;
+    delete file;
+    return;
+  }
+  TH2D *response = nullptr;
+  TH1D *primaries = nullptr;
+  file->GetObject(responseName, response);
+  file->GetObject(primariesName, primaries);
+  if (!response || !primaries) {
+    std::cerr << "No " << responseName << " or " << primariesName << " in "
+              << fileName << ", was the run made with /response/enable?"
+              << std::endl;
+    delete file;
+    return;
+  }
+
+  nTrue = response->GetNbinsX();
+  nDeposit = response->GetNbinsY();
+  for (int i = 1; i <= nTrue + 1; i++)
+    trueEdges.push_back(response->GetXaxis()->GetBinLowEdge(i));
+  depositLow = response->GetYaxis()->GetXmin();
+  depositHigh = response->GetYaxis()->GetXmax();
+
+  probability.assign((size_t)nTrue * nDeposit, 0.);
+  variance.assign((size_t)nTrue * nDeposit, 0.);
+  for (int i = 0; i < nTrue; i++) {
+    double thrown = primaries->GetBinContent(i + 1);
+    if (thrown <= 0.) {
+      std::cerr << "No primaries in true bin " << i + 1 << " ("
+                << trueEdges[i] << " keV)" << std::endl;
+      continue;
+    }
+    for (int j = 0; j < nDeposit; j++) {
+      double counts = response->GetBinContent(i + 1, j + 1);
+      probability[(size_t)i * nDeposit + j] = counts / thrown;
+      variance[(size_t)i * nDeposit + j] = counts / (thrown * thrown);
+    }
+  }
+  delete file;
+}
+
+int ResponseMatrix::trueBin(double energy) const {
+  if (energy < trueEdges.front() || energy >= trueEdges.back())
+    return -1;
+  return std::upper_bound(trueEdges.begin(), trueEdges.end(), energy) -
+         trueEdges.begin() - 1;
+}
+
+std::vector<double>
+ResponseMatrix::fold(const std::vector<double> &source) const {
+  std::vector<double> folded(nDeposit, 0.);
+  for (int i = 0; i < nTrue && i < (int)source.size(); i++) {
+    if (source[i] == 0.)
+      continue;
+    const double *column = &probability[(size_t)i * nDeposit];
+    for (int j = 0; j < nDeposit; j++)
+      folded[j] += column[j] * source[i];
+  }
+  return folded;
+}
+
+TH1D *ResponseMatrix::makeHist(const std::vector<double> &source,
+                               const char *name) const {
+  TH1D *hist = new TH1D(name, ";Energy (keV);Counts", nDeposit, depositLow,
+                        depositHigh);
+  std::vector<double> folded = fold(source);
+  // statistical error of the matrix itself, the source is taken as exact
+  std::vector<double> error(nDeposit, 0.);
+  for (int i = 0; i < nTrue; i++) {
+    if (source[i] == 0.)
+      continue;
+    const double *column = &variance[(size_t)i * nDeposit];
+    for (int j = 0; j < nDeposit; j++)
+      error[j] += column[j] * source[i] * source[i];
+  }
+  for (int j = 0; j < nDeposit; j++) {
+    hist->SetBinContent(j + 1, folded[j]);
+    hist->SetBinError(j + 1, std::sqrt(error[j]));
+  }
+  return hist;
+}
+
+TH1D *ResponseMatrix::fold(const TH1D *source, const char *name) const {
+  std::vector<double> onGrid(nTrue, 0.);
+  for (int k = 1; k <= source->GetNbinsX(); k++) {
+    double content = source->GetBinContent(k);
+    if (content == 0.)
+      continue;
+    double low = source->GetBinLowEdge(k);
+    double high = low + source->GetBinWidth(k);
+    // share the bin between the true bins it overlaps
+    for (int i = std::max(trueBin(low), 0); i < nTrue; i++) {
+      if (trueEdges[i] >= high)
+        break;
+      double overlap =
+          std::min(high, trueEdges[i + 1]) - std::max(low, trueEdges[i]);
+      if (overlap > 0.)
+        onGrid[i] += content * overlap / (high - low);
+    }
+  }
+  return makeHist(onGrid, name);
+}
+
+TH1D *ResponseMatrix::fold(TF1 *source, const char *name) const {
+  std::vector<double> onGrid(nTrue, 0.);
+  for (int i = 0; i < nTrue; i++)
+    onGrid[i] = source->Integral(trueEdges[i], trueEdges[i + 1]);
+  return makeHist(onGrid, name);
+}
+
+TH1D *ResponseMatrix::foldLines(const std::vector<double> &energies,
+                                const std::vector<double> &intensities,
+                                const char *name) const {
+  std::vector<double> onGrid(nTrue, 0.);
+  for (size_t k = 0; k < energies.size() && k < intensities.size(); k++) {
+    int i = trueBin(energies[k]);
+    if (i < 0) {
+      std::cerr << "Line at " << energies[k]
+                << " keV is outside the response grid, skipped" << std::endl;
+      continue;
+    }
+    onGrid[i] += intensities[k];
+  }
+  return makeHist(onGrid, name);
+}
+
+TH1D *ResponseMatrix::efficiencyHist(const char *name) const {
+  TH1D *hist = new TH1D(name, ";True Energy (keV);Detection Efficiency",
+                        nTrue, trueEdges.data());
+  for (int i = 0; i < nTrue; i++) {
+    double sum = 0., error = 0.;
+    for (int j = 0; j < nDeposit; j++) {
+      sum += probability[(size_t)i * nDeposit + j];
+      error += variance[(size_t)i * nDeposit + j];
+    }
+    hist->SetBinContent(i + 1, sum);
+    hist->SetBinError(i + 1, std::sqrt(error));
+  }
+  return hist;
+}
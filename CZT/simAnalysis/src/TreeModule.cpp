@@ -8,9 +8,15 @@ TreeModule::TreeModule(const char *filename, const char *broadenedFilename) {
     energyTreeCZT = static_cast<TTree *>(aFile->Get("EnergyCZT"));
     energyTreeHPGe = static_cast<TTree *>(aFile->Get("EnergyHPGe"));
     energyTreeSiLi = static_cast<TTree *>(aFile->Get("EnergySiLi"));
-    branchEnergyDepCZT = energyTreeCZT->GetBranch("fEdepCZT");
-    branchEnergyDepHPGe = energyTreeHPGe->GetBranch("fEdepHPGe");
-    branchEnergyDepSiLi = energyTreeSiLi->GetBranch("fEdepSiLi");
+    branchEnergyDepCZT =
+        energyTreeCZT ? energyTreeCZT->GetBranch("fEdepCZT") : nullptr;
+    branchEnergyDepHPGe =
+        energyTreeHPGe ? energyTreeHPGe->GetBranch("fEdepHPGe") : nullptr;
+    branchEnergyDepSiLi =
+        energyTreeSiLi ? energyTreeSiLi->GetBranch("fEdepSiLi") : nullptr;
+    TTree *digitizedTree = static_cast<TTree *>(aFile->Get("Energy"));
+    branchEnergyBroadCZT =
+        digitizedTree ? digitizedTree->GetBranch("fEdepBroad") : nullptr;
   } else {
     std::cerr << "Failed to open the file: " << filename << std::endl;
     aFile = nullptr;
@@ -21,6 +27,7 @@ TreeModule::TreeModule(const char *filename, const char *broadenedFilename) {
     branchEnergyDepCZT = nullptr;
     branchEnergyDepHPGe = nullptr;
     branchEnergyDepSiLi = nullptr;
+    branchEnergyBroadCZT = nullptr;
   }
 
   TString broadenedFileName;
@@ -51,10 +58,8 @@ TreeModule::~TreeModule() {
   std::cout << "Done." << std::endl;
 }
 
-TH1D *TreeModule::createHistogram(TBranch *branch, const char *histName) {
-  double eDep;
-  branch->SetAddress(&eDep);
-
+TH1D *TreeModule::createHistogram(TBranch *branch, const char *histName,
+                                  double toKeV) {
   double FWHM = 0.;
   double res = 0.;
 
@@ -85,29 +90,117 @@ TH1D *TreeModule::createHistogram(TBranch *branch, const char *histName) {
   TString histTitle =
       TString::Format("%s Spectrum;Energy (keV);Entries", histName);
   TH1D *hist = new TH1D(histName, histTitle, nbins, 0, 10400);
-  int entries = branch->GetEntries();
+  Long64_t entries = branch->GetEntries();
   std::cout << "Creating histogram " << histName << " with " << entries
             << " entries." << std::endl;
 
-  for (int i = 0; i < entries; ++i) {
-    branch->GetEntry(i);
-    hist->Fill(eDep * 1000);
-  }
+  // bulk read of the branch instead of GetEntry per entry, multi-threaded
+  // when the caller enabled implicit MT
+  ROOT::RDataFrame frame(*branch->GetTree());
+  auto filled =
+      frame
+          .Define("energyKeV", [toKeV](double eDep) { return eDep * toKeV; },
+                  {branch->GetName()})
+          .Histo1D<double>({TString(histName) + "_df", "", nbins, 0, 10400},
+                           "energyKeV");
+  hist->Add(filled.GetPtr());
   std::cout << "Filled histogram " << histName << " with " << hist->GetEntries()
             << " entries." << std::endl;
   return hist;
 }
 
-TH1D *TreeModule::broadenedHist(TH1D *hist, const TString detectorName) {
-  double res = 0.;
-
+double TreeModule::resolution(const TString detectorName) {
   if (detectorName == "CZT") {
-    res = 1.8 / 59.5;
+    return 1.8 / 59.5;
   } else if (detectorName == "HPGe") {
-    res = 0.430 / 68.75;
+    return 0.430 / 68.75;
   } else if (detectorName == "SiLi") {
-    res = 0.165 / 5.9;
+    return 0.165 / 5.9;
   }
+  return 0.;
+}
+
+// Only bins within +-kBandSigmas of each source bin are touched: beyond 8
+// sigma the Gaussian tail is below 1e-15 of the bin content, under double
+// precision. Each bin edge's erf is evaluated once per source bin and reused
+// by both neighbouring destination bins, and the source bins are split in
+// chunks broadened in parallel and summed at the end.
+TH1D *TreeModule::broadenedHist(TH1D *hist, const TString detectorName) {
+  const double kBandSigmas = 8.;
+  double res = resolution(detectorName);
+
+  TH1D *broadSpectrum = (TH1D *)hist->Clone();
+  broadSpectrum->Reset("ICES");
+
+  const int nbins = hist->GetNbinsX();
+  std::vector<double> edges(nbins + 1);
+  for (int j = 1; j <= nbins + 1; ++j) {
+    edges[j - 1] = broadSpectrum->GetBinLowEdge(j);
+  }
+  std::vector<double> centers(nbins + 1), contents(nbins + 1);
+  for (int i = 1; i <= nbins; ++i) {
+    centers[i] = hist->GetBinCenter(i);
+    contents[i] = hist->GetBinContent(i);
+  }
+
+  auto broadenRange = [&](int first, int last) {
+    std::vector<double> partial(nbins + 2, 0.);
+    std::vector<double> erfEdges(nbins + 1);
+    for (int i = first; i <= last; ++i) {
+      double binContent = contents[i];
+      if (binContent == 0.)
+        continue;
+      double eCenter = centers[i];
+      double simBinSigma = (eCenter * res) / 2.35;
+      double scale = 1. / (TMath::Sqrt(2.0) * simBinSigma);
+
+      // destination bins overlapping [eCenter - k sigma, eCenter + k sigma]
+      int jLow = std::upper_bound(edges.begin(), edges.end(),
+                                  eCenter - kBandSigmas * simBinSigma) -
+                 edges.begin();
+      int jHigh = std::lower_bound(edges.begin(), edges.end(),
+                                   eCenter + kBandSigmas * simBinSigma) -
+                  edges.begin();
+      jLow = std::max(jLow, 1);
+      jHigh = std::min(jHigh, nbins);
+
+      for (int j = jLow; j <= jHigh + 1; ++j) {
+        erfEdges[j - 1] = std::erf((edges[j - 1] - eCenter) * scale);
+      }
+      for (int j = jLow; j <= jHigh; ++j) {
+        partial[j] += binContent * (erfEdges[j] - erfEdges[j - 1]) / 2.0;
+      }
+    }
+    return partial;
+  };
+
+  ROOT::TThreadExecutor pool;
+  const int nChunks = std::min(nbins, 4 * (int)pool.GetPoolSize());
+  auto partials = pool.Map(
+      [&](int chunk) {
+        int first = 1 + (long)nbins * chunk / nChunks;
+        int last = (long)nbins * (chunk + 1) / nChunks;
+        return broadenRange(first, last);
+      },
+      ROOT::TSeqI(nChunks));
+
+  for (int j = 1; j <= nbins; ++j) {
+    double sum = 0.;
+    for (const auto &partial : partials) {
+      sum += partial[j];
+    }
+    broadSpectrum->SetBinContent(j, sum);
+  }
+
+  broadSpectrum->SetStats(0);
+  return broadSpectrum;
+}
+
+// Original all-pairs broadening, kept as the reference for
+// benchmarkBroadening()
+TH1D *TreeModule::broadenedHistReference(TH1D *hist,
+                                         const TString detectorName) {
+  double res = resolution(detectorName);
 
   TH1D *broadSpectrum = (TH1D *)hist->Clone();
   broadSpectrum->Reset("ICES");
@@ -134,22 +227,55 @@ TH1D *TreeModule::broadenedHist(TH1D *hist, const TString detectorName) {
   return broadSpectrum;
 }
 
-void TreeModule::writeHistogramToTree(TTree *tree, TH1D *hist,
-                                      const char *branchName) {
-  double energy;
-  TBranch *branch = tree->Branch(branchName, &energy, "energy/D");
-  std::cout << "Writing broadened histogram to tree with branch " << branchName
-            << std::endl;
+void TreeModule::benchmarkBroadening(const TString detectorName) {
+  TBranch *branch = nullptr;
+  if (detectorName == "CZT") {
+    branch = branchEnergyDepCZT;
+  } else if (detectorName == "HPGe") {
+    branch = branchEnergyDepHPGe;
+  } else if (detectorName == "SiLi") {
+    branch = branchEnergyDepSiLi;
+  }
+  if (!branch) {
+    std::cerr << "No " << detectorName << " branch in " << aFilename
+              << std::endl;
+    return;
+  }
 
-  for (int i = 1; i <= hist->GetNbinsX(); ++i) {
-    energy = hist->GetBinCenter(i);
-    int entries = hist->GetBinContent(i);
-    for (int j = 0; j < entries; ++j) {
-      tree->Fill();
-    }
+  TH1D *hist = createHistogram(branch, detectorName.Data());
+  TStopwatch timer;
+
+  timer.Start();
+  TH1D *banded = broadenedHist(hist, detectorName);
+  timer.Stop();
+  double bandedTime = timer.RealTime();
+  std::cout << "Banded broadening: " << bandedTime << " s" << std::endl;
+
+  timer.Start();
+  TH1D *reference = broadenedHistReference(hist, detectorName);
+  timer.Stop();
+  double referenceTime = timer.RealTime();
+  std::cout << "Reference broadening: " << referenceTime << " s" << std::endl;
+
+  double maxAbsDiff = 0.;
+  double maxRelDiff = 0.;
+  for (int j = 1; j <= hist->GetNbinsX(); ++j) {
+    double ref = reference->GetBinContent(j);
+    double diff = std::abs(banded->GetBinContent(j) - ref);
+    maxAbsDiff = std::max(maxAbsDiff, diff);
+    if (ref != 0.)
+      maxRelDiff = std::max(maxRelDiff, diff / std::abs(ref));
   }
-  std::cout << "Wrote " << branch->GetEntries() << " entries to branch "
-            << branchName << std::endl;
+  std::cout << detectorName << " (" << hist->GetNbinsX() << " bins, "
+            << hist->GetEntries() << " entries): speedup "
+            << referenceTime / bandedTime << "x, max |diff| " << maxAbsDiff
+            << ", max relative diff " << maxRelDiff << ", integrals "
+            << banded->Integral() << " / " << reference->Integral()
+            << std::endl;
+
+  delete hist;
+  delete banded;
+  delete reference;
 }
 
 void TreeModule::broadenAndStoreEnergy() {
@@ -157,40 +283,56 @@ void TreeModule::broadenAndStoreEnergy() {
     std::cerr << "Broadened file is not open or valid." << std::endl;
     return;
   }
-  broadenedFile
-      ->cd(); // Ensure that we are working in the broadened file context
 
-  if (branchEnergyDepCZT) {
-    TTree *broadenedTreeCZT =
-        new TTree("BroadenedEnergyCZT", "Broadened Energy Spectrum for CZT");
+  if (branchEnergyBroadCZT) {
+    TH1D *broadHistCZT = digitizedHist(branchEnergyBroadCZT, "CZT");
+    writeBroadenedHistogram(broadHistCZT, "CZT");
+    delete broadHistCZT;
+  } else if (branchEnergyDepCZT) {
     TH1D *histCZT = createHistogram(branchEnergyDepCZT, "CZT");
     TH1D *broadHistCZT = broadenedHist(histCZT, "CZT");
-    writeHistogramToTree(broadenedTreeCZT, broadHistCZT, "fEdepCZT");
-    broadenedTreeCZT->Write(); // Write the tree to the file
-    broadenedTreeCZT->Print();
+    writeBroadenedHistogram(broadHistCZT, "CZT");
     delete histCZT;
     delete broadHistCZT;
   }
 
   if (branchEnergyDepHPGe) {
-    TTree *broadenedTreeHPGe =
-        new TTree("BroadenedEnergyHPGe", "Broadened Energy Spectrum for HPGe");
     TH1D *histHPGe = createHistogram(branchEnergyDepHPGe, "HPGe");
     TH1D *broadHistHPGe = broadenedHist(histHPGe, "HPGe");
-    writeHistogramToTree(broadenedTreeHPGe, broadHistHPGe, "fEdepHPGe");
-    broadenedTreeHPGe->Write(); // Write the tree to the file
+    writeBroadenedHistogram(broadHistHPGe, "HPGe");
     delete histHPGe;
     delete broadHistHPGe;
   }
 
   if (branchEnergyDepSiLi) {
-    TTree *broadenedTreeSiLi =
-        new TTree("BroadenedEnergySiLi", "Broadened Energy Spectrum for SiLi");
     TH1D *histSiLi = createHistogram(branchEnergyDepSiLi, "SiLi");
     TH1D *broadHistSiLi = broadenedHist(histSiLi, "SiLi");
-    writeHistogramToTree(broadenedTreeSiLi, broadHistSiLi, "fEdepSiLi");
-    broadenedTreeSiLi->Write(); // Write the tree to the file
+    writeBroadenedHistogram(broadHistSiLi, "SiLi");
     delete histSiLi;
     delete broadHistSiLi;
   }
 }
+
+// Runs digitized in the simulation already carry the broadened energy in
+// keV, so it only has to be histogrammed; older runs get the convolution
+TH1D *TreeModule::digitizedHist(TBranch *branch, const TString detectorName) {
+  std::cout << "Using the digitized " << detectorName << " energy"
+            << std::endl;
+  TH1D *digitized = createHistogram(branch, detectorName.Data(), 1.);
+  digitized->SetName(detectorName + "Broad");
+  return digitized;
+}
+
+// The broadened spectrum is stored as it is, fractional bin contents
+// included, instead of one tree entry per count
+void TreeModule::writeBroadenedHistogram(TH1D *hist,
+                                         const TString detectorName) {
+  TString histName = "BroadenedHist" + detectorName;
+  hist->SetName(histName);
+  hist->SetTitle(TString::Format(
+      "Broadened Energy Spectrum for %s;Energy (keV);Entries",
+      detectorName.Data()));
+  broadenedFile->WriteObject(hist, histName);
+  std::cout << "Wrote " << histName << " with integral " << hist->Integral()
+            << std::endl;
+}
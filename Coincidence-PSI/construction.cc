@@ -2,9 +2,10 @@
 
 #include "G4UnitsTable.hh"
 
-DetectorConstruction::DetectorConstruction() {}
+DetectorConstruction::DetectorConstruction()
+    : fNaIResponse(new ScintillatorResponse("nai")) {}
 
-DetectorConstruction::~DetectorConstruction() {}
+DetectorConstruction::~DetectorConstruction() { delete fNaIResponse; }
 
 G4VPhysicalVolume *DetectorConstruction::Construct() {
 
@@ -98,18 +99,6 @@ G4VPhysicalVolume *DetectorConstruction::Construct() {
 
   G4double CdTePosZ = GePosZ; // same z position as Ge center
 
-  G4RotationMatrix *rotCdTe = new G4RotationMatrix();
-
-  rotCdTe->rotateX(90 * deg);
-
-  // Place CdTe detector below the beamline
-
-  G4VPhysicalVolume *physCdTe =
-
-      new G4PVPlacement(rotCdTe, G4ThreeVector(0, CdTePosY, CdTePosZ),
-
-                        fScoringVolumeCdTe, "CdTe", logicWorld, false, 0, true);
-
   // Create cylindrical lead shielding around CdTe with 1 cm thick walls
 
   // CdTe is rotated, so it's oriented as a disc in the x-z plane (axis along y)
@@ -135,38 +124,12 @@ G4VPhysicalVolume *DetectorConstruction::Construct() {
 
   G4double shieldOuterHalfHeight = shieldInnerHalfHeight + 0.4 * cm;
 
-  // Create outer cylinder
-
-  G4Tubs *solidLeadOuter =
-
-      new G4Tubs("LeadShieldOuter", 0., shieldOuterRadius,
-                 shieldOuterHalfHeight, 0 * deg, 360 * deg);
-
-  // Create inner cavity (to be subtracted)
-
-  G4Tubs *solidLeadInner =
-
-      new G4Tubs("LeadShieldInner", 0., shieldInnerRadius,
-                 shieldInnerHalfHeight, 0 * deg, 360 * deg);
-
-  // Create the hollow cylinder by subtraction
-
-  G4SubtractionSolid *leadShield =
-
-      new G4SubtractionSolid("LeadShield", solidLeadOuter, solidLeadInner);
-
-  G4LogicalVolume *logicLeadShield =
-
-      new G4LogicalVolume(leadShield, leadMaterial, "LeadShield");
-
   // Set visual attributes for lead shield
 
   G4VisAttributes *leadShieldVisAttr =
 
       new G4VisAttributes(G4Colour(0.4, 0.4, 0.4)); // Dark gray
 
-  logicLeadShield->SetVisAttributes(leadShieldVisAttr);
-
   // Place lead shield at same position and orientation as CdTe
 
   // Need to rotate the shield the same way as CdTe
@@ -175,12 +138,24 @@ G4VPhysicalVolume *DetectorConstruction::Construct() {
 
   rotLeadShield->rotateX(90 * deg);
 
-  G4VPhysicalVolume *physLeadShield = new G4PVPlacement(
+  // Hollow cylinder from /geometry/builder/mode, nested by default so the
+  // gammas crossing it do not navigate a subtraction solid
+
+  GeometryBuilder::Cavity shieldCavity = fBuilder.HollowCylinder(
+
+      "LeadShield", leadMaterial, worldMat, shieldInnerRadius,
+      shieldOuterRadius, shieldInnerHalfHeight, shieldOuterHalfHeight,
+      leadShieldVisAttr, rotLeadShield, G4ThreeVector(0, CdTePosY, CdTePosZ),
+      logicWorld);
+
+  // Place CdTe detector below the beamline, inside the shield cavity
+
+  G4VPhysicalVolume *physCdTe =
 
-      rotLeadShield, G4ThreeVector(0, CdTePosY, CdTePosZ), logicLeadShield,
-      "LeadShield",
+      new G4PVPlacement(shieldCavity.rotation, shieldCavity.position,
 
-      logicWorld, false, 0, true);
+                        fScoringVolumeCdTe, "CdTe", shieldCavity.mother,
+                        false, 0, true);
 
   // Define aluminum material for the layer between Ge and NaI
 
@@ -230,6 +205,14 @@ G4VPhysicalVolume *DetectorConstruction::Construct() {
 
   fScoringVolumeNaI = new G4LogicalVolume(solidNaI, NaI, "NaI");
 
+  // region for the fast scintillator response model
+
+  fNaIRegion = new G4Region("NaI");
+
+  fNaIRegion->AddRootLogicalVolume(fScoringVolumeNaI);
+
+  fNaIResponse->SetCrystal(fScoringVolumeNaI);
+
   G4double NaIPosY = AlPosY + AlHalfThickness + NaIHalfHeight;
 
   G4double NaIPosZ = GePosZ; // Centered at same Z as Ge
@@ -266,6 +249,8 @@ G4VPhysicalVolume *DetectorConstruction::Construct() {
 
   fScoringVolumeNaI->SetVisAttributes(NaIVis);
 
+  fBuilder.ApplySmartless();
+
   return physWorld;
 }
 
@@ -288,4 +273,8 @@ void DetectorConstruction::ConstructSDandField() {
   SensitiveDetector *NaISD = new SensitiveDetector("NaI");
 
   fScoringVolumeNaI->SetSensitiveDetector(NaISD);
+
+  // idle unless /nai/fastsim/mode fast
+
+  new ScintillatorFastSim("NaIResponse", fNaIRegion, fNaIResponse);
 }
@@ -5,6 +5,7 @@
 #include "G4LogicalVolume.hh"
 #include "G4NistManager.hh"
 #include "G4PVPlacement.hh"
+#include "G4Region.hh"
 #include "G4RotationMatrix.hh"
 #include "G4SubtractionSolid.hh"
 #include "G4SystemOfUnits.hh"
@@ -14,6 +15,8 @@
 #include "G4VisAttributes.hh"
 #include "cmath"
 #include "detector.hh"
+#include "geometry.hh"
+#include "scintillator.hh"
 
 class DetectorConstruction : public G4VUserDetectorConstruction {
 public:
@@ -22,6 +25,7 @@ public:
   G4LogicalVolume *GetScoringVolumeGe() const { return fScoringVolumeGe; };
   G4LogicalVolume *GetScoringVolumeCdTe() const { return fScoringVolumeCdTe; };
   G4LogicalVolume *GetScoringVolumeNaI() const { return fScoringVolumeNaI; };
+  ScintillatorResponse *GetNaIResponse() const { return fNaIResponse; }
 
   virtual G4VPhysicalVolume *Construct();
 
@@ -29,6 +33,9 @@ private:
   G4LogicalVolume *fScoringVolumeGe;
   G4LogicalVolume *fScoringVolumeCdTe;
   G4LogicalVolume *fScoringVolumeNaI;
+  G4Region *fNaIRegion;
+  ScintillatorResponse *fNaIResponse;
+  GeometryBuilder fBuilder;
   virtual void ConstructSDandField();
 };
 
@@ -1,8 +1,14 @@
 #include "event.hh"
 
-EventAction::EventAction(RunAction *) {
+EventAction::EventAction(RunAction *runAction)
+    : fRunAction(runAction),
+      fNaIRecorder(static_cast<const DetectorConstruction *>(
+                       G4RunManager::GetRunManager()
+                           ->GetUserDetectorConstruction())
+                       ->GetNaIResponse()) {
   fEdepGe = fEdepCdTe = fEdepNaI = 0.;
   fTimeGe = fTimeCdTe = fTimeNaI = -1.;
+  fSteps = 0;
 }
 
 EventAction::~EventAction() {}
@@ -10,6 +16,7 @@ EventAction::~EventAction() {}
 void EventAction::BeginOfEventAction(const G4Event *) {
   fEdepGe = fEdepCdTe = fEdepNaI = 0.;
   fTimeGe = fTimeCdTe = fTimeNaI = -1.;
+  fSteps = 0;
 }
 
 void EventAction::AddEdepGe(G4double edep, G4double time) {
@@ -31,22 +38,29 @@ void EventAction::AddEdepNaI(G4double edep, G4double time) {
 }
 
 void EventAction::EndOfEventAction(const G4Event *) {
+  fRunAction->AddSteps(fSteps);
+  fNaIRecorder.Flush();
+
   G4AnalysisManager *man = G4AnalysisManager::Instance();
+  const Digitizer *digitizer = fRunAction->GetDigitizer();
 
   if (fEdepGe > 1e-7 || fEdepCdTe > 1e-7 || fEdepNaI > 1e-7) {
     // Ntuple 0: Ge
     man->FillNtupleDColumn(0, 0, fEdepGe / MeV);
     man->FillNtupleDColumn(0, 1, fTimeGe / ns);
+    man->FillNtupleDColumn(0, 2, digitizer->Digitize("Ge", fEdepGe) / MeV);
     man->AddNtupleRow(0);
 
     // Ntuple 1: CdTe
     man->FillNtupleDColumn(1, 0, fEdepCdTe / MeV);
     man->FillNtupleDColumn(1, 1, fTimeCdTe / ns);
+    man->FillNtupleDColumn(1, 2, digitizer->Digitize("CdTe", fEdepCdTe) / MeV);
     man->AddNtupleRow(1);
 
     // Ntuple 2: NaI
     man->FillNtupleDColumn(2, 0, fEdepNaI / MeV);
     man->FillNtupleDColumn(2, 1, fTimeNaI / ns);
+    man->FillNtupleDColumn(2, 2, digitizer->Digitize("NaI", fEdepNaI) / MeV);
     man->AddNtupleRow(2);
   }
 }
@@ -8,6 +8,7 @@
 #include "G4UserEventAction.hh"
 #include "Randomize.hh"
 #include "run.hh"
+#include "scintillator.hh"
 
 class EventAction : public G4UserEventAction {
 public:
@@ -20,10 +21,19 @@ public:
   void AddEdepGe(G4double edep, G4double time);
   void AddEdepCdTe(G4double edep, G4double time);
   void AddEdepNaI(G4double edep, G4double time);
+  // every step of the event, for the navigation benchmark
+  void AddStep() { fSteps++; }
+
+  // NaI response calibration, see ScintillatorResponse
+  void RecordResponse(const G4Step *step) { fNaIRecorder.Record(step); }
 
 private:
+  RunAction *fRunAction;
   G4double fEdepGe, fEdepCdTe, fEdepNaI;
   G4double fTimeGe, fTimeCdTe, fTimeNaI;
+  G4int fSteps;
+
+  ResponseRecorder fNaIRecorder;
 };
 
 #endif
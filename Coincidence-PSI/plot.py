@@ -138,11 +138,21 @@ def plot_coincidence_hist(data1, data2, times1, times2, title, xlabel, ylabel):
 # Modify your data loading section to include times
 def load_detector_data(file_path, detector_name):
     root_file = uproot.open(file_path)
-    return {
-        "energy": root_file[detector_name]["fEDep"].array(library="np")
-        * 1000.0,  # Convert to keV
-        "time": root_file[detector_name]["fTime"].array(library="np"),
+    tree = root_file[detector_name]
+    data = {
+        "energy": tree["fEDep"].array(library="np") * 1000.0,  # Convert to keV
+        "time": tree["fTime"].array(library="np"),
     }
+    # Energy broadened by the digitizer during the run (/digitizer/...)
+    if "fEDepBroad" in tree.keys():
+        data["energy_broad"] = tree["fEDepBroad"].array(library="np") * 1000.0
+    return data
+
+
+def broadened_energy(data, resolution_function):
+    if "energy_broad" in data:
+        return data["energy_broad"]
+    return apply_energy_broadening(data["energy"], resolution_function)
 
 
 # Load data for both detectors
@@ -160,7 +170,7 @@ plot_histogram_cdte(
     color="g",
 )
 
-broadened_edep_cdte = apply_energy_broadening(cdte_data["energy"], cdte_resolution)
+broadened_edep_cdte = broadened_energy(cdte_data, cdte_resolution)
 plot_histogram_cdte(
     broadened_edep_cdte,
     "Total Energy Deposition in CdTe (with broadening)_coincidence",
@@ -170,7 +180,7 @@ plot_histogram_cdte(
 )
 
 # Plot for NaI Total Edep (0-6 MeV)
-broadened_edep_nai = apply_energy_broadening(nai_data["energy"], nai_3x3_resolution)
+broadened_edep_nai = broadened_energy(nai_data, nai_3x3_resolution)
 plot_histogram_nai(
     broadened_edep_nai,
     "Total Energy Deposition in NaI (with broadening)",
@@ -1,34 +1,68 @@
 #include "run.hh"
 
-RunAction::RunAction() {
+RunAction::RunAction() : fSteps("Steps", 0.) {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
 
   man->CreateNtuple("Ge", "Ge");
   man->CreateNtupleDColumn("fEDep");
   man->CreateNtupleDColumn("fTime");
+  man->CreateNtupleDColumn("fEDepBroad");
   man->FinishNtuple(0);
 
   man->CreateNtuple("CdTe", "CdTe");
   man->CreateNtupleDColumn("fEDep");
   man->CreateNtupleDColumn("fTime");
+  man->CreateNtupleDColumn("fEDepBroad");
   man->FinishNtuple(1);
 
   man->CreateNtuple("NaI", "NaI");
   man->CreateNtupleDColumn("fEDep");
   man->CreateNtupleDColumn("fTime");
-  man->FinishNtuple(1);
+  man->CreateNtupleDColumn("fEDepBroad");
+  man->FinishNtuple(2);
+
+  // resolution models previously applied in plot.py, the Ge is left ideal
+  fDigitizer.SetSqrt("CdTe", 0.008, 0.012, 0.0015);
+  fDigitizer.SetSqrt("NaI", 0.030, 0.062, 0.);
+
+  G4AccumulableManager::Instance()->RegisterAccumulable(fSteps);
 }
 RunAction::~RunAction() {}
+
+// the NaI response model, set up with /nai/fastsim/
+static ScintillatorResponse *NaIResponse() {
+  return static_cast<const DetectorConstruction *>(
+             G4RunManager::GetRunManager()->GetUserDetectorConstruction())
+      ->GetNaIResponse();
+}
+
 void RunAction::BeginOfRunAction(const G4Run *run) {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
+  G4AccumulableManager::Instance()->Reset();
+  if (IsMaster()) {
+    NaIResponse()->Configure();
+    fTimer.Start();
+  }
   G4int runNumber = run->GetRunID();
   std::stringstream strRunID;
   strRunID << runNumber;
   man->OpenFile("output" + strRunID.str() + ".root");
 }
-void RunAction::EndOfRunAction(const G4Run *) {
+void RunAction::EndOfRunAction(const G4Run *run) {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
 
   man->Write();
   man->CloseFile("output.root");
+
+  G4AccumulableManager::Instance()->Merge();
+  if (IsMaster()) {
+    NaIResponse()->Finish();
+    fTimer.Stop();
+    G4int events = run->GetNumberOfEvent();
+    if (events > 0)
+      G4cout << "Navigation: " << events << " events, "
+             << fSteps.GetValue() / events << " steps/event, "
+             << 1000. * fTimer.GetRealElapsed() / events << " ms/event"
+             << G4endl;
+  }
 }
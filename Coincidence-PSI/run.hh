@@ -1,9 +1,15 @@
 #ifndef RUN_HH
 #define RUN_HH
 
+#include "G4Accumulable.hh"
+#include "G4AccumulableManager.hh"
 #include "G4AnalysisManager.hh"
+#include "G4RunManager.hh"
 #include "G4Run.hh"
+#include "G4Timer.hh"
 #include "G4UserRunAction.hh"
+#include "construction.hh"
+#include "digitizer.hh"
 
 class RunAction : public G4UserRunAction {
 public:
@@ -12,6 +18,16 @@ public:
 
   virtual void BeginOfRunAction(const G4Run *);
   virtual void EndOfRunAction(const G4Run *);
+
+  const Digitizer *GetDigitizer() const { return &fDigitizer; }
+  void AddSteps(G4double steps) { fSteps += steps; }
+
+private:
+  Digitizer fDigitizer;
+
+  // steps and wall time per event, read by navigation_benchmark.py
+  G4Accumulable<G4double> fSteps;
+  G4Timer fTimer;
 };
 
 #endif
@@ -2,8 +2,9 @@
 #include "construction.hh"
 
 // include physics files
+#include "G4FastSimulationPhysics.hh"
 #include "QGSP_BIC_HP.hh"
-#include "physics.hh"
+#include "physicslist.hh"
 // include actions
 #include "action.hh"
 
@@ -17,13 +18,22 @@
 
 int main(int argc, char **argv) {
 
+  // -p <physics> picks the physics list, see physicslist.hh
+  G4String physicsConfig = TakePhysicsOption(argc, argv);
+
 #ifdef G4MULTITHREADED
   G4MTRunManager *runManager = new G4MTRunManager();
 #else
   G4RunManager *runManager = new G4RunManager();
 #endif
   runManager->SetUserInitialization(new DetectorConstruction());
-  runManager->SetUserInitialization(new PhysicsList());
+  PhysicsList *physicsList = new PhysicsList(physicsConfig, "neutron");
+  // lets the NaI response model take over gammas
+  G4FastSimulationPhysics *fastSimulationPhysics =
+      new G4FastSimulationPhysics();
+  fastSimulationPhysics->ActivateFastSimulation("gamma");
+  physicsList->RegisterPhysics(fastSimulationPhysics);
+  runManager->SetUserInitialization(physicsList);
   runManager->SetUserInitialization(new ActionInitialization());
 
   G4UIExecutive *ui = 0;
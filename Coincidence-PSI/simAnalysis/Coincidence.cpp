@@ -0,0 +1,21 @@
+#include "../../Common/simAnalysis/CoincidenceBuilder.cpp"
+
+// Ge, CdTe and NaI of the PSI setup, see CoincidenceBuilder.cpp
+CoincidenceConfig DetectorConfig() {
+  CoincidenceConfig config;
+  config.detectors = {"Ge", "CdTe", "NaI"};
+  config.nbins = 1200;
+  config.energyMin = 0.; // MeV
+  config.energyMax = 6.;
+  return config;
+}
+
+//   root -l -b -q 'Coincidence.cpp+("../1E8.root")'
+void Coincidence(const char *fileName = "../1E8.root",
+                 double window = 0.1, int minMultiplicity = 2,
+                 const char *outputName = "coincidence.root") {
+  CoincidenceConfig config = DetectorConfig();
+  config.window = window;
+  config.minMultiplicity = minMultiplicity;
+  RunCoincidence(fileName, config, outputName);
+}
@@ -0,0 +1,77 @@
+#include <ROOT/RDataFrame.hxx>
+#include <TCanvas.h>
+#include <TChain.h>
+#include <TH1D.h>
+#include <TLegend.h>
+#include <TPad.h>
+#include <TROOT.h>
+#include <iostream>
+
+// Compares the NaI spectrum with the tabulated response model against full
+// transport, from the outputs of nai.mac (run 1 fast, run 2 full). Energies
+// in MeV, as stored in fEDep.
+TH1D *NaISpectrum(const char *pattern, const char *name, Long64_t &hits) {
+  TChain chain("NaI");
+  chain.Add(pattern);
+  ROOT::RDataFrame df(chain);
+  auto filtered = df.Filter("fEDep > 0");
+  auto hist = filtered.Histo1D(
+      {name, ";Energy (MeV);Counts per 5 keV", 1200, 0., 6.}, "fEDep");
+  hits = *filtered.Count();
+  TH1D *result = (TH1D *)hist->Clone(name);
+  result->SetDirectory(nullptr);
+  return result;
+}
+
+void ValidateFastSim(const char *fullPattern = "../build/output2_t*.root",
+                     const char *fastPattern = "../build/output1_t*.root") {
+  gROOT->SetBatch(kTRUE);
+  ROOT::EnableImplicitMT();
+
+  Long64_t fullHits, fastHits;
+  TH1D *full = NaISpectrum(fullPattern, "FullTransport", fullHits);
+  TH1D *fast = NaISpectrum(fastPattern, "ResponseModel", fastHits);
+
+  std::cout << "NaI hits: full " << fullHits << ", response model "
+            << fastHits << std::endl;
+  std::cout << "Chi2 test p-value: " << full->Chi2Test(fast, "UU")
+            << ", Kolmogorov p-value: " << full->KolmogorovTest(fast)
+            << std::endl;
+
+  TCanvas *c1 = new TCanvas("c1", "c1", 2000, 1500);
+  TPad *top = new TPad("top", "", 0, 0.3, 1, 1);
+  TPad *bottom = new TPad("bottom", "", 0, 0, 1, 0.3);
+  top->SetLogy();
+  top->Draw();
+  bottom->Draw();
+
+  top->cd();
+  full->SetLineColor(kBlue);
+  full->Draw("HIST");
+  fast->SetLineColor(kRed);
+  fast->Draw("HIST SAME");
+  TLegend *legend = new TLegend(0.55, 0.75, 0.88, 0.88);
+  legend->AddEntry(full, "Full transport", "l");
+  legend->AddEntry(fast, "Response model", "l");
+  legend->Draw();
+
+  bottom->cd();
+  TH1D *ratio = (TH1D *)fast->Clone("Ratio");
+  ratio->Rebin(10);
+  TH1D *fullRebinned = (TH1D *)full->Clone("FullRebinned");
+  fullRebinned->Rebin(10);
+  ratio->Divide(fullRebinned);
+  ratio->SetTitle(";Energy (MeV);Model / Full");
+  ratio->SetMinimum(0.5);
+  ratio->SetMaximum(1.5);
+  ratio->Draw("E");
+
+  c1->Print("NaIFastSimValidation.png");
+
+  delete legend;
+  delete c1;
+  delete ratio;
+  delete fullRebinned;
+  delete full;
+  delete fast;
+}
@@ -7,6 +7,8 @@ SteppingAction::SteppingAction(EventAction *eventAction) {
 SteppingAction::~SteppingAction() {}
 
 void SteppingAction::UserSteppingAction(const G4Step *step) {
+  fEventAction->AddStep();
+
   G4LogicalVolume *volume = step->GetPreStepPoint()
                                 ->GetTouchableHandle()
                                 ->GetVolume()
@@ -34,4 +36,6 @@ void SteppingAction::UserSteppingAction(const G4Step *step) {
   if (volume == fScoringVolumeNaI) {
     fEventAction->AddEdepNaI(edep, time);
   }
+
+  fEventAction->RecordResponse(step);
 }
@@ -0,0 +1,90 @@
+#include "bias.hh"
+
+#include "G4BiasingProcessInterface.hh"
+#include "G4BiasingProcessSharedData.hh"
+#include "G4Exception.hh"
+#include "G4Neutron.hh"
+#include "G4ProcessManager.hh"
+#include <cfloat>
+#include <sstream>
+
+std::atomic<G4double> CaptureBiasing::fFactor(1.);
+
+CaptureBiasing::CaptureBiasing() : G4VBiasingOperator("CaptureBiasing") {}
+
+CaptureBiasing::~CaptureBiasing() {
+  for (auto &operation : fOperations)
+    delete operation.second;
+}
+
+void CaptureBiasing::CheckEventWeight(G4double weight) {
+  if (fFactor.load() != 1. || weight == 1.)
+    return;
+  std::ostringstream message;
+  message << "History weight " << weight << " with a capture factor of 1";
+  G4Exception("CaptureBiasing::CheckEventWeight", "AnalogWeight",
+              JustWarning, message.str().c_str());
+}
+
+void CaptureBiasing::StartRun() {
+  if (!fOperations.empty())
+    return;
+  // one operation per wrapped process, 6Li(n,t) is part of the HP
+  // neutronInelastic final states
+  const G4BiasingProcessSharedData *sharedData =
+      G4BiasingProcessInterface::GetSharedData(
+          G4Neutron::Definition()->GetProcessManager());
+  if (!sharedData) {
+    G4Exception("CaptureBiasing::StartRun", "NoBiasingPhysics",
+                JustWarning,
+                "Neutrons are not biased, is G4GenericBiasingPhysics "
+                "registered?");
+    return;
+  }
+  for (const G4BiasingProcessInterface *process :
+       sharedData->GetPhysicsBiasingProcessInterfaces()) {
+    const G4String &name = process->GetWrappedProcess()->GetProcessName();
+    if (name == "neutronInelastic" || name == "nCapture")
+      fOperations[process] = new G4BOptnChangeCrossSection("XS-" + name);
+  }
+}
+
+G4VBiasingOperation *CaptureBiasing::ProposeOccurenceBiasingOperation(
+    const G4Track *track, const G4BiasingProcessInterface *process) {
+  G4double factor = fFactor.load();
+  if (factor == 1. || track->GetDefinition() != G4Neutron::Definition())
+    return nullptr;
+  auto found = fOperations.find(process);
+  if (found == fOperations.end())
+    return nullptr;
+
+  G4double analogLength =
+      process->GetWrappedProcess()->GetCurrentInteractionLength();
+  if (analogLength > DBL_MAX / 10.)
+    return nullptr;
+  G4double biasedCrossSection = factor / analogLength;
+
+  // a new interaction length is sampled after every interaction, otherwise
+  // the one in flight is carried over the step with the updated cross section
+  G4BOptnChangeCrossSection *operation = found->second;
+  G4VBiasingOperation *previous =
+      process->GetPreviousOccurenceBiasingOperation();
+  if (!previous || operation->GetInteractionOccured()) {
+    operation->SetBiasedCrossSection(biasedCrossSection);
+    operation->Sample();
+  } else {
+    operation->UpdateForStep(process->GetPreviousStepSize());
+    operation->SetBiasedCrossSection(biasedCrossSection);
+    operation->UpdateForStep(0.);
+  }
+  return operation;
+}
+
+void CaptureBiasing::OperationApplied(
+    const G4BiasingProcessInterface *process, G4BiasingAppliedCase,
+    G4VBiasingOperation *occurenceOperation, G4double,
+    G4VBiasingOperation *, const G4VParticleChange *) {
+  auto found = fOperations.find(process);
+  if (found != fOperations.end() && found->second == occurenceOperation)
+    found->second->SetInteractionOccured();
+}
@@ -0,0 +1,57 @@
+#ifndef BIAS_HH
+#define BIAS_HH
+
+#include "G4BOptnChangeCrossSection.hh"
+#include "G4VBiasingOperator.hh"
+#include <atomic>
+#include <map>
+
+// Scales the neutron capture and inelastic cross sections in the volumes it
+// is attached to, which in the LiF crystal is dominated by 6Li(n,t). The
+// weights of the neutron and of everything it produces are corrected by
+// G4BOptnChangeCrossSection at every step in the crystal, so an event is
+// scored with the product of the weight changes of its tracks. A factor of
+// 1 leaves the transport analog.
+class CaptureBiasing : public G4VBiasingOperator {
+public:
+  CaptureBiasing();
+  ~CaptureBiasing();
+
+  // shared by the operators of every thread, set from the run action
+  static void SetFactor(G4double factor) { fFactor = factor; }
+  static G4double GetFactor() { return fFactor.load(); }
+  // warns when a history of an analog run, factor 1, does not have weight
+  // 1, which would no longer give one row of weight 1 per event
+  static void CheckEventWeight(G4double weight);
+
+  virtual void StartRun();
+
+private:
+  virtual G4VBiasingOperation *
+  ProposeOccurenceBiasingOperation(const G4Track *track,
+                                   const G4BiasingProcessInterface *process);
+  virtual G4VBiasingOperation *
+  ProposeFinalStateBiasingOperation(const G4Track *,
+                                    const G4BiasingProcessInterface *) {
+    return nullptr;
+  }
+  virtual G4VBiasingOperation *
+  ProposeNonPhysicsBiasingOperation(const G4Track *,
+                                    const G4BiasingProcessInterface *) {
+    return nullptr;
+  }
+
+  using G4VBiasingOperator::OperationApplied;
+  virtual void OperationApplied(const G4BiasingProcessInterface *process,
+                                G4BiasingAppliedCase biasingCase,
+                                G4VBiasingOperation *occurenceOperation,
+                                G4double weightForOccurence,
+                                G4VBiasingOperation *finalStateOperation,
+                                const G4VParticleChange *particleChange);
+
+  static std::atomic<G4double> fFactor;
+  std::map<const G4BiasingProcessInterface *, G4BOptnChangeCrossSection *>
+      fOperations;
+};
+
+#endif
@@ -0,0 +1,146 @@
+#include "cache.hh"
+
+#include "G4AutoLock.hh"
+#include "G4Material.hh"
+#include "G4ProductionCuts.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4Version.hh"
+#include "G4ios.hh"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+PhysicsTableCache *PhysicsTableCache::Instance() {
+  static PhysicsTableCache instance;
+  return &instance;
+}
+
+PhysicsTableCache::PhysicsTableCache()
+    : fEnabled(false), fDirectory("physics_cache"), fPhysicsList(nullptr),
+      fPending(false) {}
+
+void PhysicsTableCache::SetEnabled(G4bool enabled) {
+  G4AutoLock lock(&fMutex);
+  fEnabled = enabled;
+}
+
+void PhysicsTableCache::SetDirectory(const G4String &directory) {
+  G4AutoLock lock(&fMutex);
+  fDirectory = directory;
+}
+
+G4String PhysicsTableCache::Key(const G4String &physics) const {
+  std::ostringstream key;
+  key.precision(10);
+  key << "geant4 " << G4VERSION_NUMBER << "\n";
+  key << "physics " << physics << "\n";
+  key << "defaultCut " << fPhysicsList->GetDefaultCutValue() << "\n";
+  for (const G4Material *material : *G4Material::GetMaterialTable()) {
+    key << "material " << material->GetName() << " "
+        << material->GetDensity() << " " << material->GetState() << " "
+        << material->GetTemperature();
+    for (std::size_t i = 0; i < material->GetNumberOfElements(); i++)
+      key << " " << material->GetElement(i)->GetName() << " "
+          << material->GetFractionVector()[i];
+    key << "\n";
+  }
+  for (const G4Region *region : *G4RegionStore::GetInstance()) {
+    key << "region " << region->GetName();
+    G4ProductionCuts *cuts = region->GetProductionCuts();
+    if (cuts) {
+      for (G4int i = 0; i < NumberOfG4CutIndex; i++)
+        key << " " << cuts->GetProductionCut(i);
+    }
+    key << "\n";
+  }
+  return key.str();
+}
+
+G4String PhysicsTableCache::Hash(const G4String &key) {
+  // FNV-1a, stable between builds unlike std::hash
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : key) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  std::ostringstream hex;
+  hex << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return hex.str();
+}
+
+void PhysicsTableCache::Prepare(G4VUserPhysicsList *physicsList,
+                                const G4String &physics) {
+  G4AutoLock lock(&fMutex);
+  fPending = false;
+  if (!fEnabled)
+    return;
+
+  fPhysicsList = physicsList;
+  fKey = Key(physics);
+  fEntry = (fs::path(fDirectory) / Hash(fKey)).string();
+
+  std::ifstream stored(fEntry + "/key.txt");
+  std::ostringstream storedKey;
+  storedKey << stored.rdbuf();
+  if (stored && storedKey.str() == fKey) {
+    G4cout << "Retrieving physics tables from " << fEntry << G4endl;
+    physicsList->SetPhysicsTableRetrieved(fEntry);
+  } else {
+    fPending = true;
+  }
+}
+
+void PhysicsTableCache::Store() {
+  G4AutoLock lock(&fMutex);
+  if (!fPending)
+    return;
+  fPending = false;
+
+  // write into a private directory and rename it into place, so parallel
+  // jobs never read a half-written entry
+  fs::path temporary =
+      fs::path(fEntry).concat(".tmp" + std::to_string(::getpid()));
+  std::error_code error;
+  fs::create_directories(temporary, error);
+  if (error || !fPhysicsList->StorePhysicsTable(temporary.string())) {
+    G4cerr << "Could not store physics tables in " << temporary.string()
+           << G4endl;
+    fs::remove_all(temporary, error);
+    return;
+  }
+  std::ofstream(temporary / "key.txt") << fKey;
+
+  fs::rename(temporary, fEntry, error);
+  if (error) {
+    // another job stored the same configuration first
+    fs::remove_all(temporary, error);
+    return;
+  }
+  G4cout << "Stored physics tables in " << fEntry << G4endl;
+}
+
+void PhysicsTableCache::GeometryChanged() {
+  G4AutoLock lock(&fMutex);
+  fPending = false;
+  if (fPhysicsList)
+    fPhysicsList->ResetPhysicsTableRetrieved();
+}
+
+CachedPhysicsList::CachedPhysicsList(const G4String &config,
+                                     const G4String &defaultPhysics)
+    : PhysicsList(config, defaultPhysics) {}
+
+CachedPhysicsList::~CachedPhysicsList() {}
+
+void CachedPhysicsList::SetCuts() {
+  G4VUserPhysicsList::SetCuts();
+  // materials and cuts are final here and the tables are not built yet
+  if (G4Threading::IsMasterThread())
+    PhysicsTableCache::Instance()->Prepare(this, GetPhysics());
+}
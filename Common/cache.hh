@@ -0,0 +1,58 @@
+#ifndef CACHE_HH
+#define CACHE_HH
+
+#include "G4String.hh"
+#include "G4Threading.hh"
+#include "G4VUserPhysicsList.hh"
+#include "physicslist.hh"
+
+// On-disk cache of the built EM and hadronic physics tables, one directory
+// per physics list, material table and cuts. The first job of a scan
+// builds the tables and stores them, later jobs read them back instead.
+// G4ParticleHP data is not a physics table and is still read from G4NDL.
+// Off until /physics/cache/enable, a stale or foreign directory must not
+// be picked up by a run that did not ask for it.
+class PhysicsTableCache {
+public:
+  static PhysicsTableCache *Instance();
+
+  void SetEnabled(G4bool enabled);
+  void SetDirectory(const G4String &directory);
+
+  // From the master physics list once materials and cuts are set, before
+  // the tables are built: retrieve them if this configuration is cached
+  void Prepare(G4VUserPhysicsList *physicsList, const G4String &physics);
+  // From the master run action once the tables exist: store them if they
+  // were built rather than retrieved
+  void Store();
+  // From the detector construction when the geometry is rebuilt, the
+  // tables no longer match the entry
+  void GeometryChanged();
+
+private:
+  PhysicsTableCache();
+  ~PhysicsTableCache() {}
+
+  G4String Key(const G4String &physics) const;
+  static G4String Hash(const G4String &key);
+
+  G4Mutex fMutex;
+  G4bool fEnabled;
+  G4String fDirectory;
+
+  G4VUserPhysicsList *fPhysicsList;
+  G4String fKey;
+  G4String fEntry;
+  G4bool fPending;
+};
+
+// The -p physics with the physics tables taken from the cache.
+class CachedPhysicsList : public PhysicsList {
+public:
+  CachedPhysicsList(const G4String &config, const G4String &defaultPhysics);
+  ~CachedPhysicsList();
+
+  virtual void SetCuts();
+};
+
+#endif
@@ -0,0 +1,189 @@
+#include "digitizer.hh"
+
+#include "G4Exception.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace {
+const G4double kFWHMToSigma = 1. / (2. * std::sqrt(2. * std::log(2.)));
+
+void BadArguments(const G4String &command, const G4String &args) {
+  G4Exception("Digitizer", "BadArguments", JustWarning,
+              ("Cannot parse '/digitizer/" + command + " " + args +
+               "', resolution model unchanged")
+                  .c_str());
+}
+} // namespace
+
+Digitizer::Digitizer() {
+  fMessenger = new G4GenericMessenger(this, "/digitizer/",
+                                      "Event-by-event energy resolution");
+  fMessenger->DeclareMethod("none", &Digitizer::NoneCommand,
+                            "<detector>: store the true energy unchanged");
+  // the commands of several fields take one parameter per field
+  fCommands.Declare(
+      "/digitizer/constant", {{"detector", 's'}, {"fwhm", 'd'}},
+      [this](const G4String &args) { ConstantCommand(args); },
+      "<detector> <FWHM in keV>");
+  fCommands.Declare(
+      "/digitizer/relative", {{"detector", 's'}, {"fwhmOverE", 'd'}},
+      [this](const G4String &args) { RelativeCommand(args); },
+      "<detector> <FWHM/E>");
+  fCommands.Declare(
+      "/digitizer/sqrt",
+      {{"detector", 's'}, {"a", 'd'}, {"b", 'd'}, {"c", 'd'}},
+      [this](const G4String &args) { SqrtCommand(args); },
+      "<detector> <a> <b> <c>: FWHM/E = sqrt(a^2 + b^2/E + c^2/E^2), E in MeV");
+  fCommands.Declare(
+      "/digitizer/table", {{"detector", 's'}, {"file", 's'}},
+      [this](const G4String &args) { TableCommand(args); },
+      "<detector> <file>: FWHM interpolated from 'E FWHM' lines in keV");
+}
+
+Digitizer::~Digitizer() { delete fMessenger; }
+
+void Digitizer::SetNone(const G4String &detector) {
+  fResponses[detector] = Response();
+}
+
+void Digitizer::SetConstant(const G4String &detector, G4double fwhm) {
+  Response response;
+  response.model = kConstant;
+  response.par[0] = fwhm;
+  fResponses[detector] = response;
+}
+
+void Digitizer::SetRelative(const G4String &detector, G4double fwhmOverE) {
+  Response response;
+  response.model = kRelative;
+  response.par[0] = fwhmOverE;
+  fResponses[detector] = response;
+}
+
+void Digitizer::SetSqrt(const G4String &detector, G4double a, G4double b,
+                        G4double c) {
+  Response response;
+  response.model = kSqrt;
+  response.par[0] = a;
+  response.par[1] = b;
+  response.par[2] = c;
+  fResponses[detector] = response;
+}
+
+void Digitizer::SetTable(const G4String &detector, const G4String &fileName) {
+  std::ifstream file(fileName);
+  if (!file.is_open()) {
+    G4Exception("Digitizer::SetTable", "FileNotOpened", FatalException,
+                ("Cannot open resolution table " + fileName).c_str());
+    return;
+  }
+
+  std::vector<std::pair<G4double, G4double>> points;
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream values(line);
+    G4double energy, fwhm;
+    if (line.empty() || line[0] == '#' || !(values >> energy >> fwhm))
+      continue;
+    points.push_back({energy * keV, fwhm * keV});
+  }
+  if (points.empty()) {
+    G4Exception("Digitizer::SetTable", "EmptyTable", FatalException,
+                ("No 'E FWHM' points in " + fileName).c_str());
+    return;
+  }
+  std::sort(points.begin(), points.end());
+
+  Response response;
+  response.model = kTable;
+  for (const auto &point : points) {
+    response.energies.push_back(point.first);
+    response.fwhms.push_back(point.second);
+  }
+  fResponses[detector] = response;
+}
+
+G4double Digitizer::FWHM(const G4String &detector, G4double edep) const {
+  auto found = fResponses.find(detector);
+  if (found == fResponses.end() || edep <= 0.)
+    return 0.;
+  const Response &response = found->second;
+
+  switch (response.model) {
+  case kConstant:
+    return response.par[0];
+  case kRelative:
+    return response.par[0] * edep;
+  case kSqrt: {
+    G4double e = edep / MeV;
+    G4double a = response.par[0], b = response.par[1], c = response.par[2];
+    return edep * std::sqrt(a * a + b * b / e + c * c / (e * e));
+  }
+  case kTable: {
+    const std::vector<G4double> &x = response.energies;
+    const std::vector<G4double> &y = response.fwhms;
+    if (edep <= x.front())
+      return y.front();
+    if (edep >= x.back())
+      return y.back();
+    std::size_t i = std::upper_bound(x.begin(), x.end(), edep) - x.begin();
+    return y[i - 1] + (y[i] - y[i - 1]) * (edep - x[i - 1]) / (x[i] - x[i - 1]);
+  }
+  default:
+    return 0.;
+  }
+}
+
+G4double Digitizer::Digitize(const G4String &detector, G4double edep) const {
+  G4double fwhm = FWHM(detector, edep);
+  if (fwhm <= 0.)
+    return edep;
+  return G4RandGauss::shoot(edep, fwhm * kFWHMToSigma);
+}
+
+void Digitizer::NoneCommand(const G4String &args) {
+  std::istringstream values(args);
+  G4String detector;
+  if (!(values >> detector))
+    return BadArguments("none", args);
+  SetNone(detector);
+}
+
+void Digitizer::ConstantCommand(const G4String &args) {
+  std::istringstream values(args);
+  G4String detector;
+  G4double fwhm;
+  if (!(values >> detector >> fwhm))
+    return BadArguments("constant", args);
+  SetConstant(detector, fwhm * keV);
+}
+
+void Digitizer::RelativeCommand(const G4String &args) {
+  std::istringstream values(args);
+  G4String detector;
+  G4double fwhmOverE;
+  if (!(values >> detector >> fwhmOverE))
+    return BadArguments("relative", args);
+  SetRelative(detector, fwhmOverE);
+}
+
+void Digitizer::SqrtCommand(const G4String &args) {
+  std::istringstream values(args);
+  G4String detector;
+  G4double a, b, c;
+  if (!(values >> detector >> a >> b >> c))
+    return BadArguments("sqrt", args);
+  SetSqrt(detector, a, b, c);
+}
+
+void Digitizer::TableCommand(const G4String &args) {
+  std::istringstream values(args);
+  G4String detector, fileName;
+  if (!(values >> detector >> fileName))
+    return BadArguments("table", args);
+  SetTable(detector, fileName);
+}
@@ -0,0 +1,55 @@
+#ifndef DIGITIZER_HH
+#define DIGITIZER_HH
+
+#include "G4GenericMessenger.hh"
+#include "G4String.hh"
+#include "G4Types.hh"
+#include "messenger.hh"
+#include <map>
+#include <vector>
+
+// Applies the detector energy resolution to the summed deposit of an event,
+// so the ntuples carry the broadened energy next to the true one. The model
+// is chosen per detector from the macro:
+//   /digitizer/none     <detector>
+//   /digitizer/constant <detector> <FWHM in keV>
+//   /digitizer/relative <detector> <FWHM/E>
+//   /digitizer/sqrt     <detector> <a> <b> <c>
+//                       FWHM/E = sqrt(a^2 + b^2/E + c^2/E^2), E in MeV
+//   /digitizer/table    <detector> <file>
+//                       lines of "E FWHM" in keV, linearly interpolated
+class Digitizer {
+public:
+  enum Model { kNone, kConstant, kRelative, kSqrt, kTable };
+
+  Digitizer();
+  ~Digitizer();
+
+  void SetNone(const G4String &detector);
+  void SetConstant(const G4String &detector, G4double fwhm);
+  void SetRelative(const G4String &detector, G4double fwhmOverE);
+  void SetSqrt(const G4String &detector, G4double a, G4double b, G4double c);
+  void SetTable(const G4String &detector, const G4String &fileName);
+
+  G4double FWHM(const G4String &detector, G4double edep) const;
+  G4double Digitize(const G4String &detector, G4double edep) const;
+
+private:
+  struct Response {
+    Model model = kNone;
+    G4double par[3] = {0., 0., 0.};
+    std::vector<G4double> energies, fwhms;
+  };
+
+  void NoneCommand(const G4String &args);
+  void ConstantCommand(const G4String &args);
+  void RelativeCommand(const G4String &args);
+  void SqrtCommand(const G4String &args);
+  void TableCommand(const G4String &args);
+
+  G4GenericMessenger *fMessenger;
+  ArgumentMessenger fCommands;
+  std::map<G4String, Response> fResponses;
+};
+
+#endif
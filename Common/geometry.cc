@@ -0,0 +1,172 @@
+#include "geometry.hh"
+
+#include "G4Exception.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4RunManager.hh"
+#include "G4StateManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+#include <sstream>
+
+GeometryBuilder::GeometryBuilder() : fMode(kNested) {
+  // the geometry is shared, only the master may change it
+  fMessenger = new G4GenericMessenger(this, "/geometry/builder/",
+                                      "Shield and wall construction");
+  fMessenger
+      ->DeclareMethod("mode", &GeometryBuilder::SetMode,
+                      "boolean: subtraction solids, nested: cavity as a "
+                      "daughter volume, shells: hollow tubes and end caps")
+      .SetCandidates("boolean nested shells")
+      .SetStates(G4State_PreInit)
+      .SetToBeBroadcasted(false);
+  G4UIcommand *smartless = fCommands.Declare(
+      "/geometry/builder/smartless", {{"volume", 's'}, {"smartless", 'd'}},
+      [this](const G4String &args) { SetSmartless(args); },
+      "<logical volume> <smartless>: voxels per daughter of the volume, "
+      "Geant4 default 2");
+  smartless->SetToBeBroadcasted(false);
+}
+
+GeometryBuilder::~GeometryBuilder() { delete fMessenger; }
+
+void GeometryBuilder::SetMode(const G4String &mode) {
+  if (mode == "boolean") {
+    fMode = kBoolean;
+  } else if (mode == "shells") {
+    fMode = kShells;
+  } else {
+    fMode = kNested;
+  }
+}
+
+void GeometryBuilder::SetSmartless(const G4String &args) {
+  std::istringstream fields(args);
+  G4String volume;
+  G4double smartless = 0.;
+  fields >> volume >> smartless;
+  if (fields.fail() || smartless <= 0.) {
+    G4Exception("GeometryBuilder::SetSmartless", "BadSmartless",
+                JustWarning,
+                ("Expected '<logical volume> <smartless>' with smartless "
+                 "> 0, got '" + args + "'")
+                    .c_str());
+    return;
+  }
+  fSmartless[volume] = smartless;
+  // after /run/initialize the voxels are rebuilt when the next run closes
+  // the geometry
+  if (G4StateManager::GetStateManager()->GetCurrentState() == G4State_Idle) {
+    ApplySmartless();
+    G4RunManager::GetRunManager()->GeometryHasBeenModified();
+  }
+}
+
+void GeometryBuilder::ApplySmartless() {
+  for (const auto &entry : fSmartless) {
+    G4LogicalVolume *volume =
+        G4LogicalVolumeStore::GetInstance()->GetVolume(entry.first, false);
+    if (!volume) {
+      G4Exception("GeometryBuilder::ApplySmartless", "UnknownVolume",
+                  JustWarning,
+                  ("No logical volume " + entry.first).c_str());
+      continue;
+    }
+    volume->SetSmartless(entry.second);
+  }
+}
+
+GeometryBuilder::Cavity GeometryBuilder::HollowCylinder(
+    const G4String &name, G4Material *wall, G4Material *fill,
+    G4double innerRadius, G4double outerRadius, G4double innerHalfZ,
+    G4double outerHalfZ, G4VisAttributes *vis, G4RotationMatrix *rotation,
+    const G4ThreeVector &position, G4LogicalVolume *mother) {
+  if (fMode == kNested) {
+    G4Tubs *solidWall = new G4Tubs(name, 0., outerRadius, outerHalfZ,
+                                   0 * deg, 360 * deg);
+    G4LogicalVolume *logicWall = new G4LogicalVolume(solidWall, wall, name);
+    logicWall->SetVisAttributes(vis);
+    new G4PVPlacement(rotation, position, logicWall, name, mother, false, 0,
+                      true);
+
+    G4Tubs *solidCavity = new G4Tubs(name + "Cavity", 0., innerRadius,
+                                     innerHalfZ, 0 * deg, 360 * deg);
+    G4LogicalVolume *logicCavity =
+        new G4LogicalVolume(solidCavity, fill, name + "Cavity");
+    logicCavity->SetVisAttributes(G4VisAttributes::GetInvisible());
+    new G4PVPlacement(0, G4ThreeVector(), logicCavity, name + "Cavity",
+                      logicWall, false, 0, true);
+    return {logicCavity, nullptr, G4ThreeVector()};
+  }
+
+  if (fMode == kShells) {
+    // the side wall spans the cavity, the caps close it at both ends
+    G4Tubs *solidSide = new G4Tubs(name, innerRadius, outerRadius,
+                                   innerHalfZ, 0 * deg, 360 * deg);
+    G4LogicalVolume *logicSide = new G4LogicalVolume(solidSide, wall, name);
+    logicSide->SetVisAttributes(vis);
+    new G4PVPlacement(rotation, position, logicSide, name, mother, false, 0,
+                      true);
+
+    G4double capHalfZ = (outerHalfZ - innerHalfZ) / 2;
+    G4Tubs *solidCap = new G4Tubs(name + "Cap", 0., outerRadius, capHalfZ,
+                                  0 * deg, 360 * deg);
+    G4LogicalVolume *logicCap =
+        new G4LogicalVolume(solidCap, wall, name + "Cap");
+    logicCap->SetVisAttributes(vis);
+    for (G4int i = 0; i < 2; i++) {
+      // along the local axis of the wall, placed in the mother frame
+      G4ThreeVector offset(0., 0., (i ? 1 : -1) * (innerHalfZ + capHalfZ));
+      if (rotation)
+        offset = rotation->inverse() * offset;
+      new G4PVPlacement(rotation, position + offset, logicCap, name + "Cap",
+                        mother, false, i, true);
+    }
+    return {mother, rotation, position};
+  }
+
+  G4Tubs *solidOuter = new G4Tubs(name + "Outer", 0., outerRadius,
+                                  outerHalfZ, 0 * deg, 360 * deg);
+  G4Tubs *solidInner = new G4Tubs(name + "Inner", 0., innerRadius,
+                                  innerHalfZ, 0 * deg, 360 * deg);
+  G4SubtractionSolid *solidWall =
+      new G4SubtractionSolid(name, solidOuter, solidInner);
+  G4LogicalVolume *logicWall = new G4LogicalVolume(solidWall, wall, name);
+  logicWall->SetVisAttributes(vis);
+  new G4PVPlacement(rotation, position, logicWall, name, mother, false, 0,
+                    true);
+  return {mother, rotation, position};
+}
+
+void GeometryBuilder::DrilledBox(const G4String &name, G4Material *wall,
+                                 G4Material *fill, G4double halfX,
+                                 G4double halfY, G4double halfZ,
+                                 G4double holeRadius, G4VisAttributes *vis,
+                                 G4RotationMatrix *rotation,
+                                 const G4ThreeVector &position,
+                                 G4LogicalVolume *mother) {
+  G4Box *solidBox = new G4Box(name, halfX, halfY, halfZ);
+  if (fMode == kBoolean) {
+    // the hole sticks out so no thin skin is left at the faces
+    G4Tubs *solidHole = new G4Tubs(name + "Hole", 0., holeRadius,
+                                   halfZ + 1 * mm, 0 * deg, 360 * deg);
+    G4SubtractionSolid *solidWall = new G4SubtractionSolid(
+        name + "WithHole", solidBox, solidHole);
+    G4LogicalVolume *logicWall = new G4LogicalVolume(solidWall, wall, name);
+    logicWall->SetVisAttributes(vis);
+    new G4PVPlacement(rotation, position, logicWall, name, mother, false, 0,
+                      true);
+    return;
+  }
+
+  G4LogicalVolume *logicWall = new G4LogicalVolume(solidBox, wall, name);
+  logicWall->SetVisAttributes(vis);
+  new G4PVPlacement(rotation, position, logicWall, name, mother, false, 0,
+                    true);
+  G4Tubs *solidHole = new G4Tubs(name + "Hole", 0., holeRadius, halfZ,
+                                 0 * deg, 360 * deg);
+  G4LogicalVolume *logicHole =
+      new G4LogicalVolume(solidHole, fill, name + "Hole");
+  logicHole->SetVisAttributes(G4VisAttributes::GetInvisible());
+  new G4PVPlacement(0, G4ThreeVector(), logicHole, name + "Hole", logicWall,
+                    false, 0, true);
+}
@@ -0,0 +1,70 @@
+#ifndef GEOMETRY_HH
+#define GEOMETRY_HH
+
+#include "G4Box.hh"
+#include "G4GenericMessenger.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4PVPlacement.hh"
+#include "G4RotationMatrix.hh"
+#include "G4SubtractionSolid.hh"
+#include "G4ThreeVector.hh"
+#include "G4Tubs.hh"
+#include "G4VisAttributes.hh"
+#include "messenger.hh"
+#include <map>
+
+// Shields and walls with a cavity or a hole. kBoolean is a
+// G4SubtractionSolid, kNested places the cavity as a daughter of a solid
+// wall and kShells builds a closed can from a hollow G4Tubs and two end
+// caps, so that no boolean solid has to be navigated. /geometry/builder/
+// picks the mode before /run/initialize and sets the voxelization
+// (smartless) of any logical volume.
+class GeometryBuilder {
+public:
+  enum Mode { kBoolean, kNested, kShells };
+
+  // where the contents of a cavity are placed: in the cavity volume when
+  // nested, else in the mother of the wall at the wall's transform
+  struct Cavity {
+    G4LogicalVolume *mother;
+    G4RotationMatrix *rotation;
+    G4ThreeVector position;
+  };
+
+  GeometryBuilder();
+  ~GeometryBuilder();
+
+  Mode GetMode() const { return fMode; }
+
+  // closed cylinder along its local z with a cylindrical cavity
+  Cavity HollowCylinder(const G4String &name, G4Material *wall,
+                        G4Material *fill, G4double innerRadius,
+                        G4double outerRadius, G4double innerHalfZ,
+                        G4double outerHalfZ, G4VisAttributes *vis,
+                        G4RotationMatrix *rotation,
+                        const G4ThreeVector &position,
+                        G4LogicalVolume *mother);
+  // box with a cylindrical hole through it along its local z, shells
+  // are built nested
+  void DrilledBox(const G4String &name, G4Material *wall, G4Material *fill,
+                  G4double halfX, G4double halfY, G4double halfZ,
+                  G4double holeRadius, G4VisAttributes *vis,
+                  G4RotationMatrix *rotation, const G4ThreeVector &position,
+                  G4LogicalVolume *mother);
+
+  // from Construct, once the logical volumes exist
+  void ApplySmartless();
+
+private:
+  void SetMode(const G4String &mode);
+  // "<logical volume> <smartless>"
+  void SetSmartless(const G4String &args);
+
+  G4GenericMessenger *fMessenger;
+  ArgumentMessenger fCommands;
+  Mode fMode;
+  std::map<G4String, G4double> fSmartless;
+};
+
+#endif
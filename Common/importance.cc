@@ -0,0 +1,180 @@
+#include "importance.hh"
+
+#include "G4AutoLock.hh"
+#include "G4Exception.hh"
+#include "G4GeometryCell.hh"
+#include "G4ImportanceProcess.hh"
+#include "G4Neutron.hh"
+#include "G4ParallelWorldProcess.hh"
+#include "G4ProcessManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4WeightWindowProcess.hh"
+#include "G4ios.hh"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+ImportanceWorld::ImportanceWorld(const ModeratorSlab *moderator)
+    : G4VUserParallelWorld(kWorldName), fModerator(moderator), fLayers(1),
+      fImportances(2, 1.), fFrontZ(0.), fBackZ(0.), fGhostWorld(nullptr) {
+  DefineCommands();
+}
+
+ImportanceWorld::~ImportanceWorld() { delete fMessenger; }
+
+void ImportanceWorld::DefineCommands() {
+  // the importance world is shared, only the master may change it
+  fMessenger = new G4GenericMessenger(
+      this, "/moderator/importance/",
+      "Importance splitting and roulette through the moderator");
+  fMessenger
+      ->DeclareMethod("layers", &ImportanceWorld::SetLayers,
+                      "Number of moderator layers, before /run/initialize. "
+                      "Resets the importances to 1")
+      .SetStates(G4State_PreInit)
+      .SetToBeBroadcasted(false);
+  G4UIcommand *value = fCommands.Declare(
+      "/moderator/importance/value", {{"cell", 'i'}, {"importance", 'd'}},
+      [this](const G4String &args) { SetImportance(args); },
+      "<cell> <importance>: cells 0 to layers-1 are the layers, cell "
+      "layers is downstream of the moderator");
+  value->SetToBeBroadcasted(false);
+  fMessenger
+      ->DeclareMethod("geometric", &ImportanceWorld::SetGeometric,
+                      "Importance ratio^(i+1) for layer i")
+      .SetToBeBroadcasted(false);
+}
+
+void ImportanceWorld::Construct() {
+  fGhostWorld = GetWorld();
+  G4LogicalVolume *worldLogical = fGhostWorld->GetLogicalVolume();
+  const G4Box *worldBox = static_cast<const G4Box *>(worldLogical->GetSolid());
+  G4double worldHalfX = worldBox->GetXHalfLength();
+  G4double worldHalfY = worldBox->GetYHalfLength();
+  G4double worldHalfZ = worldBox->GetZHalfLength();
+
+  fFrontZ = fModerator->GetFrontZ();
+  fBackZ = fFrontZ + 2 * fModerator->GetHalfZ();
+  G4double layerHalfZ = (fBackZ - fFrontZ) / (2 * fLayers);
+
+  // the layers span the whole world across the beam so a neutron leaving
+  // the moderator sideways keeps its cell
+  fCells.clear();
+  G4Box *layerBox =
+      new G4Box("ImportanceLayer", worldHalfX, worldHalfY, layerHalfZ);
+  G4LogicalVolume *layerLogical =
+      new G4LogicalVolume(layerBox, nullptr, "ImportanceLayer");
+  for (G4int i = 0; i < fLayers; i++) {
+    G4double z = fFrontZ + (2 * i + 1) * layerHalfZ;
+    fCells.push_back(new G4PVPlacement(0, G4ThreeVector(0., 0., z),
+                                       layerLogical, "ImportanceLayer",
+                                       worldLogical, false, i + 1, true));
+  }
+
+  G4double downstreamHalfZ = (worldHalfZ - fBackZ) / 2;
+  G4Box *downstreamBox = new G4Box("ImportanceDownstream", worldHalfX,
+                                   worldHalfY, downstreamHalfZ);
+  G4LogicalVolume *downstreamLogical =
+      new G4LogicalVolume(downstreamBox, nullptr, "ImportanceDownstream");
+  fCells.push_back(new G4PVPlacement(
+      0, G4ThreeVector(0., 0., fBackZ + downstreamHalfZ), downstreamLogical,
+      "ImportanceDownstream", worldLogical, false, fLayers + 1, true));
+}
+
+G4int ImportanceWorld::CellAt(G4double z) const {
+  if (z < fFrontZ)
+    return 0;
+  if (z >= fBackZ)
+    return fLayers + 1;
+  G4int layer = static_cast<G4int>((z - fFrontZ) / (fBackZ - fFrontZ) *
+                                   fLayers);
+  return std::min(layer, fLayers - 1) + 1;
+}
+
+void ImportanceWorld::SetLayers(G4int layers) {
+  if (layers < 1) {
+    G4Exception("ImportanceWorld::SetLayers", "BadLayers", JustWarning,
+                "Need at least one layer, ignored");
+    return;
+  }
+  fLayers = layers;
+  fImportances.assign(fLayers + 1, 1.);
+}
+
+void ImportanceWorld::SetImportance(const G4String &args) {
+  std::istringstream fields(args);
+  G4int cell = -1;
+  G4double importance = 0.;
+  fields >> cell >> importance;
+  if (fields.fail() || cell < 0 || cell > fLayers || importance <= 0.) {
+    std::ostringstream message;
+    message << "Expected '<cell> <importance>' with cell 0 to " << fLayers
+            << " and importance > 0, got '" << args << "'";
+    G4Exception("ImportanceWorld::SetImportance", "BadImportance",
+                JustWarning, message.str().c_str());
+    return;
+  }
+  fImportances[cell] = importance;
+}
+
+void ImportanceWorld::SetGeometric(G4double ratio) {
+  if (ratio <= 0.) {
+    G4Exception("ImportanceWorld::SetGeometric", "BadImportance",
+                JustWarning, "The ratio has to be positive, ignored");
+    return;
+  }
+  for (G4int i = 0; i < fLayers; i++)
+    fImportances[i] = std::pow(ratio, i + 1);
+  // no roulette on the way out of the last layer
+  fImportances[fLayers] = fImportances[fLayers - 1];
+}
+
+void ImportanceWorld::FillStore() {
+  G4AutoLock lock(&fMutex);
+  // a /moderator/material or /moderator/thickness rebuild replaces the
+  // ghost world the stores and the processes were set up with
+  G4ProcessVector *processes =
+      G4Neutron::Definition()->GetProcessManager()->GetProcessList();
+  for (std::size_t i = 0; i < processes->size(); i++) {
+    G4VProcess *process = (*processes)[i];
+    if (auto importance = dynamic_cast<G4ImportanceProcess *>(process)) {
+      importance->SetParallelWorld(kWorldName);
+    } else if (auto window = dynamic_cast<G4WeightWindowProcess *>(process)) {
+      window->SetParallelWorld(kWorldName);
+    } else if (auto parallel =
+                   dynamic_cast<G4ParallelWorldProcess *>(process)) {
+      parallel->SetParallelWorld(kWorldName);
+    }
+  }
+
+  // the rest of the world first, then the layers and the downstream cell
+  std::vector<G4GeometryCell> cells = {G4GeometryCell(*fGhostWorld, 0)};
+  for (G4VPhysicalVolume *cell : fCells)
+    cells.push_back(G4GeometryCell(*cell, cell->GetCopyNo()));
+
+  G4IStore *store = G4IStore::GetInstance(kWorldName);
+  store->SetParallelWorldVolume(kWorldName);
+  auto set = [store](const G4GeometryCell &cell, G4double importance) {
+    if (store->IsKnown(cell)) {
+      store->ChangeImportance(importance, cell);
+    } else {
+      store->AddImportanceGeometryCell(importance, cell);
+    }
+  };
+  set(cells[0], 1.);
+  for (std::size_t i = 0; i < fCells.size(); i++)
+    set(cells[i + 1], fImportances[i]);
+
+  if (FillWindowStore(cells))
+    return;
+
+  G4bool analog = true;
+  for (G4double importance : fImportances)
+    analog = analog && importance == 1.;
+  if (G4Threading::IsMasterThread() && !analog) {
+    G4cout << "Moderator importances:";
+    for (G4double importance : fImportances)
+      G4cout << " " << importance;
+    G4cout << G4endl;
+  }
+}
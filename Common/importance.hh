@@ -0,0 +1,68 @@
+#ifndef IMPORTANCE_HH
+#define IMPORTANCE_HH
+
+#include "G4Box.hh"
+#include "G4GenericMessenger.hh"
+#include "G4GeometryCell.hh"
+#include "G4IStore.hh"
+#include "G4LogicalVolume.hh"
+#include "G4PVPlacement.hh"
+#include "G4String.hh"
+#include "G4Threading.hh"
+#include "G4VUserParallelWorld.hh"
+#include "messenger.hh"
+#include "moderator.hh"
+#include <vector>
+
+// Parallel world slicing the moderator into layers along the beam, for
+// importance splitting and Russian roulette of neutrons. Cells 0 to n-1 are
+// the layers, cell n is everything downstream of the moderator and the rest
+// of the world has importance 1. All importances 1 is an analog run.
+// Set from /moderator/importance/ on the master.
+class ImportanceWorld : public G4VUserParallelWorld {
+public:
+  static constexpr const char *kWorldName = "ImportanceWorld";
+
+  ImportanceWorld(const ModeratorSlab *moderator);
+  virtual ~ImportanceWorld();
+
+  virtual void Construct();
+
+  // layers can only change before /run/initialize
+  void SetLayers(G4int layers);
+  // "<cell> <importance>"
+  void SetImportance(const G4String &args);
+  // importance ratio^(i+1) for layer i, ratio^n downstream
+  void SetGeometric(G4double ratio);
+
+  G4int GetLayers() const { return fLayers; }
+  // 0 outside the moderator layers, 1 to n the layers, n+1 downstream
+  G4int CellAt(G4double z) const;
+
+  // called at the start of every run, the importances or the loaded weight
+  // windows may have changed
+  void FillStore();
+
+protected:
+  // weight windows to use instead of the importances: fill the window
+  // store for the cells, the rest of the world first, and return true
+  virtual G4bool FillWindowStore(const std::vector<G4GeometryCell> &) {
+    return false;
+  }
+
+private:
+  void DefineCommands();
+
+  G4GenericMessenger *fMessenger;
+  ArgumentMessenger fCommands;
+  const ModeratorSlab *fModerator;
+  G4int fLayers;
+  std::vector<G4double> fImportances;
+  G4double fFrontZ;
+  G4double fBackZ;
+  G4VPhysicalVolume *fGhostWorld;
+  std::vector<G4VPhysicalVolume *> fCells;
+  G4Mutex fMutex;
+};
+
+#endif
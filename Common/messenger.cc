@@ -0,0 +1,25 @@
+#include "messenger.hh"
+
+ArgumentMessenger::~ArgumentMessenger() {
+  for (auto &entry : fHandlers)
+    delete entry.first;
+}
+
+G4UIcommand *ArgumentMessenger::Declare(const G4String &path,
+                                        const Fields &fields,
+                                        const Handler &handler,
+                                        const G4String &doc) {
+  G4UIcommand *command = new G4UIcommand(path, this);
+  command->SetGuidance(doc);
+  for (const auto &field : fields)
+    command->SetParameter(
+        new G4UIparameter(field.first, field.second, false));
+  fHandlers[command] = handler;
+  return command;
+}
+
+void ArgumentMessenger::SetNewValue(G4UIcommand *command, G4String newValue) {
+  auto found = fHandlers.find(command);
+  if (found != fHandlers.end())
+    found->second(newValue);
+}
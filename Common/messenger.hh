@@ -0,0 +1,35 @@
+#ifndef MESSENGER_HH
+#define MESSENGER_HH
+
+#include "G4UIcommand.hh"
+#include "G4UImessenger.hh"
+#include "G4UIparameter.hh"
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
+// Macro commands of several fields. G4GenericMessenger hands a method of
+// one argument only the first word of the command, so these commands get
+// one G4UIparameter per field and pass the whole parameter string, checked
+// against the field types, to their handler. The commands are added to an
+// existing directory, e.g. one of a G4GenericMessenger.
+class ArgumentMessenger : public G4UImessenger {
+public:
+  using Handler = std::function<void(const G4String &)>;
+  // name and G4UIparameter type ('s', 'd', 'i' or 'b') of each field
+  using Fields = std::vector<std::pair<G4String, char>>;
+
+  ArgumentMessenger() {}
+  ~ArgumentMessenger();
+
+  G4UIcommand *Declare(const G4String &path, const Fields &fields,
+                       const Handler &handler, const G4String &doc);
+
+  virtual void SetNewValue(G4UIcommand *command, G4String newValue);
+
+private:
+  std::map<G4UIcommand *, Handler> fHandlers;
+};
+
+#endif
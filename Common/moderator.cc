@@ -0,0 +1,123 @@
+#include "moderator.hh"
+
+#include "G4Exception.hh"
+#include "G4NistManager.hh"
+#include "G4RunManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4UImanager.hh"
+#include "G4ios.hh"
+#include "cache.hh"
+#include <cmath>
+#include <map>
+#include <sstream>
+
+// short names of the scan outputs, anything else is taken as a NIST name
+static const std::map<G4String, G4String> kModeratorMaterials = {
+    {"Poly", "G4_POLYETHYLENE"}, {"Water", "G4_WATER"}};
+
+static G4String NistName(const G4String &material) {
+  auto alias = kModeratorMaterials.find(material);
+  return alias != kModeratorMaterials.end() ? alias->second : material;
+}
+
+ModeratorSlab::ModeratorSlab(const G4String &material, G4double thickness)
+    : fMaterial(NistName(material)), fThickness(thickness),
+      fVolume(nullptr), fFrontZ(0.), fHalfZ(0.) {
+  // the geometry is shared, only the master may change it
+  fMessenger = new G4GenericMessenger(this, "/moderator/",
+                                      "Moderator slab in front of WrapPost");
+  fMessenger
+      ->DeclareMethod("material", &ModeratorSlab::SetMaterial,
+                      "Poly, Water or a NIST material")
+      .SetToBeBroadcasted(false);
+  fMessenger
+      ->DeclareMethodWithUnit("thickness", "cm",
+                              &ModeratorSlab::SetThickness,
+                              "Thickness along the beam")
+      .SetToBeBroadcasted(false);
+  G4UIcommand *sweep = fCommands.Declare(
+      "/moderator/sweep",
+      {{"material", 's'},
+       {"first", 'd'},
+       {"last", 'd'},
+       {"step", 'd'},
+       {"events", 'i'}},
+      [this](const G4String &args) { Sweep(args); },
+      "<material> <first> <last> <step> <events>: one run per thickness "
+      "in cm, written to <material><t>cm");
+  sweep->AvailableForStates(G4State_Idle);
+  sweep->SetToBeBroadcasted(false);
+}
+
+ModeratorSlab::~ModeratorSlab() { delete fMessenger; }
+
+void ModeratorSlab::SetBuilt(G4LogicalVolume *volume, G4double frontZ,
+                             G4double halfZ) {
+  fVolume = volume;
+  fFrontZ = frontZ;
+  fHalfZ = halfZ;
+}
+
+void ModeratorSlab::SetMaterial(const G4String &material) {
+  if (!G4NistManager::Instance()->FindOrBuildMaterial(NistName(material))) {
+    G4Exception("ModeratorSlab::SetMaterial", "UnknownMaterial",
+                JustWarning,
+                ("No material " + material + ", moderator unchanged")
+                    .c_str());
+    return;
+  }
+  fMaterial = NistName(material);
+  Rebuild();
+}
+
+void ModeratorSlab::SetThickness(G4double thickness) {
+  if (thickness <= 0.) {
+    G4Exception("ModeratorSlab::SetThickness", "BadThickness", JustWarning,
+                "The thickness has to be positive, moderator unchanged");
+    return;
+  }
+  fThickness = thickness;
+  Rebuild();
+}
+
+void ModeratorSlab::Rebuild() {
+  // before /run/initialize the values are simply used by Construct
+  if (!fVolume)
+    return;
+  PhysicsTableCache::Instance()->GeometryChanged();
+  // tables of materials already in use are kept, only new ones are built
+  G4RunManager::GetRunManager()->ReinitializeGeometry(true);
+}
+
+void ModeratorSlab::Sweep(const G4String &args) {
+  std::istringstream fields(args);
+  G4String material;
+  G4double first = 0., last = 0., step = 0.;
+  G4int events = 0;
+  fields >> material >> first >> last >> step >> events;
+  if (fields.fail() || first <= 0. || last < first || step <= 0. ||
+      events < 0) {
+    G4Exception("ModeratorSlab::Sweep", "BadSweep", JustWarning,
+                ("Expected '<material> <first> <last> <step> <events>', "
+                 "got '" + args + "'")
+                    .c_str());
+    return;
+  }
+
+  SetMaterial(material);
+  if (fMaterial != NistName(material))
+    return;
+  G4int points = static_cast<G4int>(std::floor((last - first) / step + 1e-6));
+  for (G4int i = 0; i <= points; i++) {
+    G4double thickness = first + i * step;
+    SetThickness(thickness * cm);
+    std::ostringstream name;
+    name << material << thickness << "cm";
+    fOutputName = name.str();
+    G4cout << "Sweep point " << fOutputName << G4endl;
+    std::ostringstream beamOn;
+    beamOn << "/run/beamOn " << events;
+    G4UImanager::GetUIpointer()->ApplyCommand(beamOn.str());
+  }
+  fOutputName = "";
+}
@@ -0,0 +1,51 @@
+#ifndef MODERATOR_HH
+#define MODERATOR_HH
+
+#include "G4GenericMessenger.hh"
+#include "G4LogicalVolume.hh"
+#include "G4String.hh"
+#include "G4Types.hh"
+#include "messenger.hh"
+
+// Material and thickness of the moderator slab in front of WrapPost, from
+// /moderator/. The detector construction builds the slab from them and
+// reports the placed volume; a change after /run/initialize rebuilds the
+// geometry. /moderator/sweep runs a thickness scan in one process, so the
+// physics tables are only built once per material.
+class ModeratorSlab {
+public:
+  ModeratorSlab(const G4String &material, G4double thickness);
+  ~ModeratorSlab();
+
+  // NIST name of the material
+  const G4String &GetMaterial() const { return fMaterial; }
+  G4double GetThickness() const { return fThickness; }
+  // run output name set by a sweep, empty for output<run>
+  const G4String &GetOutputName() const { return fOutputName; }
+
+  // from Construct once the slab is placed, front face at frontZ
+  void SetBuilt(G4LogicalVolume *volume, G4double frontZ, G4double halfZ);
+  G4LogicalVolume *GetVolume() const { return fVolume; }
+  G4double GetFrontZ() const { return fFrontZ; }
+  G4double GetHalfZ() const { return fHalfZ; }
+
+  // rebuild the geometry when called after /run/initialize
+  void SetMaterial(const G4String &material);
+  void SetThickness(G4double thickness);
+  // "<material> <first> <last> <step> <events>", thicknesses in cm
+  void Sweep(const G4String &args);
+
+private:
+  void Rebuild();
+
+  G4GenericMessenger *fMessenger;
+  ArgumentMessenger fCommands;
+  G4String fMaterial;
+  G4double fThickness;
+  G4String fOutputName;
+  G4LogicalVolume *fVolume;
+  G4double fFrontZ;
+  G4double fHalfZ;
+};
+
+#endif
@@ -0,0 +1,133 @@
+#include "physicslist.hh"
+
+#include "G4Exception.hh"
+#include "G4HadronInelasticProcess.hh"
+#include "G4Neutron.hh"
+#include "G4NeutronCaptureProcess.hh"
+#include "G4ParticleHPCapture.hh"
+#include "G4ParticleHPCaptureData.hh"
+#include "G4ParticleHPInelastic.hh"
+#include "G4ParticleHPInelasticData.hh"
+#include "G4PhysicsListHelper.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+#include <map>
+#include <sstream>
+
+// presets expand to constructors, in registration order
+static const std::map<G4String, G4String> kPresets = {
+    {"gamma", "em,extra,decay,deex"},
+    {"alpha", "em4,extra,decay,ion,deex"},
+    {"hpge", "em,decay,rdm,bic_allhp"},
+    {"neutron", "hpelastic,bic_allhp,em4,decay,rdm"},
+    {"neutronhp", "em,bic_hp,hpelastic"},
+    {"thermal", "em4,hpelastic,thermal,nhp"}};
+
+PhysicsList::PhysicsList(const G4String &config,
+                         const G4String &defaultPhysics) {
+  SetVerboseLevel(0);
+
+  std::istringstream names(config.empty() ? defaultPhysics : config);
+  G4String name;
+  while (std::getline(names, name, ',')) {
+    auto preset = kPresets.find(name);
+    std::istringstream expanded(preset != kPresets.end() ? preset->second
+                                                         : name);
+    G4String constructor;
+    while (std::getline(expanded, constructor, ',')) {
+      Register(constructor);
+      fPhysics += (fPhysics.empty() ? "" : ",") + constructor;
+    }
+  }
+  G4cout << "Physics: " << fPhysics << G4endl;
+}
+
+PhysicsList::~PhysicsList() {}
+
+void PhysicsList::Register(const G4String &name) {
+  if (name == "em") {
+    RegisterPhysics(new G4EmStandardPhysics());
+  } else if (name == "em4") {
+    RegisterPhysics(new G4EmStandardPhysics_option4());
+  } else if (name == "livermore") {
+    RegisterPhysics(new G4EmLivermorePhysics());
+  } else if (name == "penelope") {
+    RegisterPhysics(new G4EmPenelopePhysics());
+  } else if (name == "extra") {
+    RegisterPhysics(new G4EmExtraPhysics());
+  } else if (name == "deex") {
+    // Auger cascade and fluorescence for the low-energy x-ray studies
+    G4EmParameters *param = G4EmParameters::Instance();
+    param->SetAugerCascade(true);
+    param->SetDeexcitationIgnoreCut(true);
+    param->SetFluo(true);
+    param->SetAuger(true);
+  } else if (name == "decay") {
+    RegisterPhysics(new G4DecayPhysics());
+  } else if (name == "rdm") {
+    RegisterPhysics(new G4RadioactiveDecayPhysics());
+  } else if (name == "ion") {
+    RegisterPhysics(new G4IonPhysics());
+  } else if (name == "hpelastic") {
+    RegisterPhysics(new G4HadronElasticPhysicsHP());
+  } else if (name == "thermal") {
+    // S(alpha, beta) below 4 eV, needs hpelastic first
+    RegisterPhysics(new G4ThermalNeutrons());
+  } else if (name == "bic_allhp") {
+    RegisterPhysics(new G4HadronPhysicsQGSP_BIC_AllHP());
+  } else if (name == "bic_hp") {
+    RegisterPhysics(new G4HadronPhysicsQGSP_BIC_HP());
+  } else if (name == "bert_hp") {
+    RegisterPhysics(new G4HadronPhysicsQGSP_BERT_HP());
+  } else if (name == "nhp") {
+    RegisterPhysics(new NeutronHPPhysics());
+  } else {
+    G4String known;
+    for (const auto &preset : kPresets)
+      known += " " + preset.first;
+    G4Exception("PhysicsList::Register", "UnknownPhysics", FatalException,
+                ("Unknown physics '" + name + "'. Presets:" + known +
+                 "; constructors: em em4 livermore penelope extra deex decay"
+                 " rdm ion hpelastic thermal bic_allhp bic_hp bert_hp nhp")
+                    .c_str());
+  }
+}
+
+NeutronHPPhysics::NeutronHPPhysics() : G4VPhysicsConstructor("NeutronHP") {}
+
+NeutronHPPhysics::~NeutronHPPhysics() {}
+
+void NeutronHPPhysics::ConstructParticle() { G4Neutron::Definition(); }
+
+void NeutronHPPhysics::ConstructProcess() {
+  G4PhysicsListHelper *helper = G4PhysicsListHelper::GetPhysicsListHelper();
+  G4ParticleDefinition *neutron = G4Neutron::Definition();
+
+  G4HadronInelasticProcess *inelastic =
+      new G4HadronInelasticProcess("neutronInelastic", neutron);
+  inelastic->AddDataSet(new G4ParticleHPInelasticData());
+  G4ParticleHPInelastic *inelasticModel = new G4ParticleHPInelastic();
+  inelasticModel->SetMaxEnergy(20. * MeV);
+  inelastic->RegisterMe(inelasticModel);
+  helper->RegisterProcess(inelastic, neutron);
+
+  G4NeutronCaptureProcess *capture = new G4NeutronCaptureProcess();
+  capture->AddDataSet(new G4ParticleHPCaptureData());
+  G4ParticleHPCapture *captureModel = new G4ParticleHPCapture();
+  captureModel->SetMaxEnergy(20. * MeV);
+  capture->RegisterMe(captureModel);
+  helper->RegisterProcess(capture, neutron);
+}
+
+G4String TakePhysicsOption(int &argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    if (G4String(argv[i]) == "-p" && i + 1 < argc) {
+      G4String physics = argv[i + 1];
+      for (int j = i; j + 2 <= argc; j++)
+        argv[j] = argv[j + 2];
+      argc -= 2;
+      return physics;
+    }
+  }
+  return "";
+}
@@ -0,0 +1,54 @@
+#ifndef PHYSICSLIST_HH
+#define PHYSICSLIST_HH
+
+#include "G4DecayPhysics.hh"
+#include "G4EmExtraPhysics.hh"
+#include "G4EmLivermorePhysics.hh"
+#include "G4EmParameters.hh"
+#include "G4EmPenelopePhysics.hh"
+#include "G4EmStandardPhysics.hh"
+#include "G4EmStandardPhysics_option4.hh"
+#include "G4HadronElasticPhysicsHP.hh"
+#include "G4HadronPhysicsQGSP_BERT_HP.hh"
+#include "G4HadronPhysicsQGSP_BIC_AllHP.hh"
+#include "G4HadronPhysicsQGSP_BIC_HP.hh"
+#include "G4IonPhysics.hh"
+#include "G4RadioactiveDecayPhysics.hh"
+#include "G4ThermalNeutrons.hh"
+#include "G4VModularPhysicsList.hh"
+#include "G4VPhysicsConstructor.hh"
+
+// Physics assembled from a comma separated list of presets and
+// constructors, selected with sim -p, e.g. "thermal" or "em4,decay,nhp".
+// An empty list gives the app's default. Apps that need constructors of
+// their own derive from it in their physics.hh.
+class PhysicsList : public G4VModularPhysicsList {
+public:
+  PhysicsList(const G4String &config, const G4String &defaultPhysics);
+  ~PhysicsList();
+
+  // the registered constructors, presets expanded
+  const G4String &GetPhysics() const { return fPhysics; }
+
+private:
+  void Register(const G4String &name);
+
+  G4String fPhysics;
+};
+
+// HP capture and inelastic scattering for neutrons below 20 MeV only,
+// for thermal work that does not need the full hadronic lists
+class NeutronHPPhysics : public G4VPhysicsConstructor {
+public:
+  NeutronHPPhysics();
+  ~NeutronHPPhysics();
+
+  virtual void ConstructParticle();
+  virtual void ConstructProcess();
+};
+
+// Takes "-p <physics>" out of the command line, so the remaining arguments
+// are the app's own; empty when not given
+G4String TakePhysicsOption(int &argc, char **argv);
+
+#endif
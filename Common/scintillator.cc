@@ -0,0 +1,323 @@
+#include "scintillator.hh"
+
+#include "G4AutoLock.hh"
+#include "G4Exception.hh"
+#include "G4Gamma.hh"
+#include "G4NavigationHistory.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4ios.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+// 20 bins per decade from 10 keV to 10 MeV, 5 in angle and 5 in position
+static const G4double kLogEnergyMin = -2.;
+static const G4double kLogEnergyMax = 1.;
+static const G4int kEnergyBins = 60;
+static const G4int kCosBins = 5;
+static const G4int kPositionBins = 5;
+static const G4double kSurfaceTolerance = 1. * um;
+
+ScintillatorResponse::ScintillatorResponse(const G4String &directory)
+    : fDirectory("/" + directory + "/fastsim/"), fModeName("off"),
+      fFileName(directory + ".response"), fMinSamples(50),
+      fCrystal(nullptr), fMode(kOff), fRadius(0.), fHalfLength(0.) {
+  fMessenger = new G4GenericMessenger(
+      this, fDirectory, "Tabulated response model for the crystal");
+  fMessenger
+      ->DeclareProperty("mode", fModeName,
+                        "off: full transport, calibrate: full transport and "
+                        "record the response, fast: sample the response")
+      .SetCandidates("off calibrate fast");
+  fMessenger->DeclareProperty(
+      "table", fFileName,
+      "Response table written by calibrate, read by fast");
+  fMessenger
+      ->DeclareProperty("minSamples", fMinSamples,
+                        "Samples an entry bin needs before it is used, "
+                        "sparser bins are transported in full")
+      .SetRange("minSamples>0");
+}
+
+ScintillatorResponse::~ScintillatorResponse() { delete fMessenger; }
+
+void ScintillatorResponse::Configure() {
+  Mode mode = kOff;
+  if (fModeName == "calibrate") {
+    mode = kCalibrate;
+  } else if (fModeName == "fast") {
+    mode = kFast;
+  }
+  const G4Tubs *crystal =
+      fCrystal ? dynamic_cast<const G4Tubs *>(fCrystal->GetSolid()) : nullptr;
+  if (mode != kOff && !crystal) {
+    G4Exception("ScintillatorResponse::Configure", "NoCrystal",
+                FatalException,
+                (fDirectory + " needs a cylindrical crystal").c_str());
+    return;
+  }
+
+  G4AutoLock lock(&fMutex);
+  fSamples.clear();
+  fFractions.clear();
+  if (crystal) {
+    fMaterial = fCrystal->GetMaterial()->GetName();
+    fRadius = crystal->GetOuterRadius();
+    fHalfLength = crystal->GetZHalfLength();
+  }
+  if (mode == kFast)
+    Load();
+  fMode = mode;
+}
+
+void ScintillatorResponse::Finish() {
+  G4AutoLock lock(&fMutex);
+  if (fMode == kCalibrate)
+    Write();
+}
+
+void ScintillatorResponse::AddSamples(
+    const std::vector<ResponseSample> &samples) {
+  G4AutoLock lock(&fMutex);
+  fSamples.insert(fSamples.end(), samples.begin(), samples.end());
+}
+
+G4bool ScintillatorResponse::EntryCoordinates(const G4Tubs *crystal,
+                                              const G4ThreeVector &position,
+                                              const G4ThreeVector &direction,
+                                              G4int &face, G4double &cosTheta,
+                                              G4double &entry) {
+  G4double radius = crystal->GetOuterRadius();
+  G4double halfLength = crystal->GetZHalfLength();
+  G4double r = position.perp();
+  if (std::abs(std::abs(position.z()) - halfLength) < kSurfaceTolerance) {
+    face = 0;
+    cosTheta = position.z() > 0. ? -direction.z() : direction.z();
+    entry = std::min(r / radius, 1.);
+  } else if (std::abs(r - radius) < kSurfaceTolerance) {
+    face = 1;
+    cosTheta = -(direction.x() * position.x() + direction.y() * position.y()) /
+               r;
+    // distance from the end the gamma is heading away from
+    G4double z = direction.z() < 0. ? -position.z() : position.z();
+    entry = std::max(0., std::min((z + halfLength) / (2. * halfLength), 1.));
+  } else {
+    return false;
+  }
+  return cosTheta > 0.;
+}
+
+G4int ScintillatorResponse::Bin(G4int face, G4double energy,
+                                G4double cosTheta, G4double position) const {
+  if (energy <= 0.)
+    return -1;
+  G4int energyBin = static_cast<G4int>(
+      (std::log10(energy / MeV) - kLogEnergyMin) /
+      (kLogEnergyMax - kLogEnergyMin) * kEnergyBins);
+  if (energyBin < 0 || energyBin >= kEnergyBins)
+    return -1;
+  G4int cosBin = std::max(
+      0, std::min(static_cast<G4int>(cosTheta * kCosBins), kCosBins - 1));
+  G4int positionBin =
+      std::max(0, std::min(static_cast<G4int>(position * kPositionBins),
+                           kPositionBins - 1));
+  return ((face * kEnergyBins + energyBin) * kCosBins + cosBin) *
+             kPositionBins +
+         positionBin;
+}
+
+G4bool ScintillatorResponse::SampleDeposit(G4int face, G4double energy,
+                                           G4double cosTheta,
+                                           G4double position,
+                                           G4double &deposit) const {
+  G4int bin = Bin(face, energy, cosTheta, position);
+  if (bin < 0 || fFractions.empty())
+    return false;
+  const std::vector<G4double> &fractions = fFractions[bin];
+  if (static_cast<G4int>(fractions.size()) < fMinSamples)
+    return false;
+  std::size_t pick =
+      static_cast<std::size_t>(G4UniformRand() * fractions.size());
+  deposit = energy * fractions[std::min(pick, fractions.size() - 1)];
+  return true;
+}
+
+void ScintillatorResponse::Load() {
+  std::ifstream file(fFileName);
+  if (!file) {
+    G4Exception("ScintillatorResponse::Load", "FileNotFound", FatalException,
+                ("Cannot open response table " + fFileName + ", run " +
+                 fDirectory + "mode calibrate first")
+                    .c_str());
+    return;
+  }
+
+  G4String material;
+  G4double radius = 0., halfLength = 0.;
+  G4String line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#')
+      continue;
+    std::istringstream fields(line);
+    G4String tag;
+    fields >> tag;
+    if (tag == "material") {
+      fields >> material;
+    } else if (tag == "radius") {
+      fields >> radius;
+    } else if (tag == "halfLength") {
+      fields >> halfLength;
+    } else if (tag == "S") {
+      ResponseSample sample;
+      fields >> sample.face >> sample.energy >> sample.cosTheta >>
+          sample.position >> sample.deposit;
+      fSamples.push_back(sample);
+    }
+  }
+
+  if (material != fMaterial || std::abs(radius - fRadius) > 1e-6 ||
+      std::abs(halfLength - fHalfLength) > 1e-6) {
+    std::ostringstream message;
+    message << fFileName << " was calibrated for a " << radius / mm << " x "
+            << 2 * halfLength / mm << " mm " << material
+            << " crystal, not the " << fRadius / mm << " x "
+            << 2 * fHalfLength / mm << " mm " << fMaterial << " one";
+    G4Exception("ScintillatorResponse::Load", "GeometryMismatch",
+                FatalException, message.str().c_str());
+  }
+
+  // stored as deposited fractions so a sample serves its whole energy bin
+  fFractions.assign(2 * kEnergyBins * kCosBins * kPositionBins,
+                    std::vector<G4double>());
+  for (const ResponseSample &sample : fSamples) {
+    G4int bin =
+        Bin(sample.face, sample.energy, sample.cosTheta, sample.position);
+    if (bin >= 0)
+      fFractions[bin].push_back(sample.deposit / sample.energy);
+  }
+  G4cout << "Loaded " << fSamples.size() << " scintillator response samples "
+         << "from " << fFileName << G4endl;
+  fSamples.clear();
+}
+
+void ScintillatorResponse::Write() const {
+  std::ofstream file(fFileName);
+  file.precision(10);
+  file << "# scintillator response, energies in MeV, lengths in mm\n";
+  file << "# S face energy cosTheta position deposit\n";
+  file << "material " << fMaterial << "\n";
+  file << "radius " << fRadius << "\n";
+  file << "halfLength " << fHalfLength << "\n";
+
+  std::size_t full = 0;
+  for (const ResponseSample &sample : fSamples) {
+    file << "S " << sample.face << " " << sample.energy << " "
+         << sample.cosTheta << " " << sample.position << " "
+         << sample.deposit << "\n";
+    if (sample.deposit > (1. - 1e-6) * sample.energy)
+      full++;
+  }
+  G4cout << "Wrote " << fSamples.size() << " scintillator response samples "
+         << "to " << fFileName << ", " << full << " fully absorbed"
+         << G4endl;
+}
+
+ResponseRecorder::ResponseRecorder(ScintillatorResponse *response)
+    : fResponse(response) {}
+
+void ResponseRecorder::Record(const G4Step *step) {
+  if (fResponse->GetMode() != ScintillatorResponse::kCalibrate)
+    return;
+  G4LogicalVolume *crystal = fResponse->GetCrystal();
+
+  // a secondary belongs to the entry of its parent
+  G4Track *track = step->GetTrack();
+  if (track->GetCurrentStepNumber() == 1) {
+    auto parent = fTrackSample.find(track->GetParentID());
+    if (parent != fTrackSample.end())
+      fTrackSample[track->GetTrackID()] = parent->second;
+  }
+
+  G4StepPoint *preStep = step->GetPreStepPoint();
+  G4StepPoint *postStep = step->GetPostStepPoint();
+  G4VPhysicalVolume *postVolume = postStep->GetPhysicalVolume();
+  G4bool preInside = preStep->GetPhysicalVolume()->GetLogicalVolume() ==
+                     crystal;
+  G4bool postInside =
+      postVolume && postVolume->GetLogicalVolume() == crystal;
+
+  if (preInside) {
+    auto entry = fTrackSample.find(track->GetTrackID());
+    if (entry != fTrackSample.end())
+      fSamples[entry->second].deposit += step->GetTotalEnergyDeposit();
+  }
+
+  // a gamma coming back after escaping stays part of its first entry
+  if (!preInside && postInside &&
+      track->GetDefinition() == G4Gamma::Definition() &&
+      !fTrackSample.count(track->GetTrackID())) {
+    const G4AffineTransform &toLocal =
+        postStep->GetTouchableHandle()->GetHistory()->GetTopTransform();
+    ResponseSample sample;
+    sample.energy = postStep->GetKineticEnergy();
+    sample.deposit = 0.;
+    if (ScintillatorResponse::EntryCoordinates(
+            static_cast<const G4Tubs *>(crystal->GetSolid()),
+            toLocal.TransformPoint(postStep->GetPosition()),
+            toLocal.TransformAxis(postStep->GetMomentumDirection()),
+            sample.face, sample.cosTheta, sample.position)) {
+      fSamples.push_back(sample);
+      fTrackSample[track->GetTrackID()] = fSamples.size() - 1;
+    }
+  }
+}
+
+void ResponseRecorder::Flush() {
+  if (!fSamples.empty())
+    fResponse->AddSamples(fSamples);
+  fSamples.clear();
+  fTrackSample.clear();
+}
+
+ScintillatorFastSim::ScintillatorFastSim(G4String name, G4Region *region,
+                                         const ScintillatorResponse *response)
+    : G4VFastSimulationModel(name, region), fResponse(response),
+      fDeposit(0.) {}
+
+ScintillatorFastSim::~ScintillatorFastSim() {}
+
+G4bool
+ScintillatorFastSim::IsApplicable(const G4ParticleDefinition &particle) {
+  return &particle == G4Gamma::Definition();
+}
+
+G4bool ScintillatorFastSim::ModelTrigger(const G4FastTrack &fastTrack) {
+  if (fResponse->GetMode() != ScintillatorResponse::kFast)
+    return false;
+
+  const G4Tubs *crystal =
+      dynamic_cast<const G4Tubs *>(fastTrack.GetEnvelopeSolid());
+  if (!crystal)
+    return false;
+  G4int face;
+  G4double cosTheta, entry;
+  if (!ScintillatorResponse::EntryCoordinates(
+          crystal, fastTrack.GetPrimaryTrackLocalPosition(),
+          fastTrack.GetPrimaryTrackLocalDirection(), face, cosTheta, entry))
+    return false;
+
+  return fResponse->SampleDeposit(
+      face, fastTrack.GetPrimaryTrack()->GetKineticEnergy(), cosTheta, entry,
+      fDeposit);
+}
+
+void ScintillatorFastSim::DoIt(const G4FastTrack &, G4FastStep &fastStep) {
+  // the stepping action scores this step like any other deposit in the
+  // crystal, at the entry time
+  fastStep.KillPrimaryTrack();
+  fastStep.ProposePrimaryTrackPathLength(0.);
+  fastStep.ProposeTotalEnergyDeposited(fDeposit);
+}
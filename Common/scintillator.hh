@@ -0,0 +1,122 @@
+#ifndef SCINTILLATOR_HH
+#define SCINTILLATOR_HH
+
+#include "G4FastStep.hh"
+#include "G4FastTrack.hh"
+#include "G4GenericMessenger.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Step.hh"
+#include "G4String.hh"
+#include "G4ThreeVector.hh"
+#include "G4Threading.hh"
+#include "G4Tubs.hh"
+#include "G4Types.hh"
+#include "G4VFastSimulationModel.hh"
+#include <atomic>
+#include <map>
+#include <vector>
+
+// A gamma entering the scintillator and the energy that it and everything
+// it produced deposited in the crystal
+struct ResponseSample {
+  G4int face;        // 0 end cap, 1 side
+  G4double energy;
+  G4double cosTheta; // against the inward surface normal
+  G4double position; // r/R on an end cap, along the axis on the side
+  G4double deposit;
+};
+
+// Tabulated full-absorption response of a cylindrical scintillator,
+// indexed by entry face, energy, angle and position. A calibration run with
+// full physics collects samples from every worker; a fast run loads them
+// and draws the deposited fraction for gammas entering the crystal.
+// One per crystal, owned by the detector construction, set up with
+// /<name>/fastsim/ and configured by the master run action.
+class ScintillatorResponse {
+public:
+  enum Mode { kOff, kCalibrate, kFast };
+
+  // commands under /<directory>/fastsim/, table <directory>.response
+  ScintillatorResponse(const G4String &directory);
+  ~ScintillatorResponse();
+
+  // from Construct once the crystal, a G4Tubs, is built
+  void SetCrystal(G4LogicalVolume *crystal) { fCrystal = crystal; }
+  G4LogicalVolume *GetCrystal() const { return fCrystal; }
+
+  // master, at the start and the end of each run
+  void Configure();
+  void Finish();
+
+  Mode GetMode() const { return fMode.load(); }
+
+  void AddSamples(const std::vector<ResponseSample> &samples);
+  G4bool SampleDeposit(G4int face, G4double energy, G4double cosTheta,
+                       G4double position, G4double &deposit) const;
+
+  // Entry coordinates of a gamma on the crystal surface, in the crystal
+  // frame; false when it is not on the surface heading inwards
+  static G4bool EntryCoordinates(const G4Tubs *crystal,
+                                 const G4ThreeVector &position,
+                                 const G4ThreeVector &direction, G4int &face,
+                                 G4double &cosTheta, G4double &entry);
+
+private:
+  G4int Bin(G4int face, G4double energy, G4double cosTheta,
+            G4double position) const;
+  void Load();
+  void Write() const;
+
+  G4GenericMessenger *fMessenger;
+  G4String fDirectory;
+  G4String fModeName;
+  G4String fFileName;
+  G4int fMinSamples;
+  G4LogicalVolume *fCrystal;
+
+  G4Mutex fMutex;
+  std::atomic<Mode> fMode;
+  G4String fMaterial;
+  G4double fRadius, fHalfLength;
+
+  std::vector<ResponseSample> fSamples;
+  std::vector<std::vector<G4double>> fFractions;
+};
+
+// Calibration bookkeeping of one worker: follows every gamma entering the
+// crystal, adds what it and its secondaries deposit there to its sample
+// and hands the samples of each event to the response. Idle unless the
+// response is calibrating.
+class ResponseRecorder {
+public:
+  ResponseRecorder(ScintillatorResponse *response);
+
+  // every step of the event
+  void Record(const G4Step *step);
+  // at the end of each event
+  void Flush();
+
+private:
+  ScintillatorResponse *fResponse;
+  std::vector<ResponseSample> fSamples;
+  std::map<G4int, std::size_t> fTrackSample;
+};
+
+// Deposits the energy of a gamma entering the scintillator in one step,
+// drawn from the calibrated response table, and kills it. Gammas without
+// enough calibration samples for their entry are transported in full.
+class ScintillatorFastSim : public G4VFastSimulationModel {
+public:
+  ScintillatorFastSim(G4String, G4Region *, const ScintillatorResponse *);
+  ~ScintillatorFastSim();
+
+  virtual G4bool IsApplicable(const G4ParticleDefinition &);
+  virtual G4bool ModelTrigger(const G4FastTrack &);
+  virtual void DoIt(const G4FastTrack &, G4FastStep &);
+
+private:
+  const ScintillatorResponse *fResponse;
+  G4double fDeposit;
+};
+
+#endif
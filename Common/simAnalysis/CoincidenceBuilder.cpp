@@ -0,0 +1,277 @@
+#include <ROOT/RDataFrame.hxx>
+#include <ROOT/TSeq.hxx>
+#include <TFile.h>
+#include <TH1D.h>
+#include <TH2D.h>
+#include <THnSparse.h>
+#include <TROOT.h>
+#include <TThreadExecutor.h>
+#include <TTree.h>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Sort-merge coincidence builder for the per-detector (fEDep, fTime)
+// ntuples. Every event adds one row to each detector ntuple, so the entry
+// number is the event index and only hits with the same index are paired.
+// All hits of all detectors are sorted by event and time once, then every hit
+// looks at its neighbours of the same event within +-window with two pointers
+// that only move forward, so the sweep is linear in the number of hits. The
+// sorted hits are cut in chunks that are swept in parallel; a chunk reads past
+// its own edges so no coincidence is lost at the boundaries.
+//
+// Writes, per detector, the spectrum of hits with at least minMultiplicity
+// detectors firing within the window (<det>_coincidence) and of hits with no
+// other detector firing (<det>_anticoincidence), and for every detector pair
+// a sparse energy-energy matrix (<detA>_vs_<detB>). Hits are filled with
+// the event weight when the ntuples have an fWeight column (biased runs).
+//
+// Shared by the simulations with coincidence ntuples; each includes this
+// from its simAnalysis/Coincidence.cpp with its own detectors and binning.
+struct CoincidenceHit {
+  ULong64_t event;
+  double time;
+  double energy;
+  double weight;
+  int detector;
+  bool operator<(const CoincidenceHit &other) const {
+    if (event != other.event)
+      return event < other.event;
+    return time < other.time;
+  }
+};
+
+struct CoincidenceConfig {
+  std::vector<std::string> detectors;
+  double window = 0.1; // ns
+  int minMultiplicity = 2;
+  int nbins = 100;
+  double energyMin = 0.; // MeV
+  double energyMax = 1.;
+  // use the digitized energy when the ntuples have it
+  bool broadened = true;
+};
+
+struct CoincidenceResult {
+  std::vector<TH1D *> coincidence;
+  std::vector<TH1D *> antiCoincidence;
+  std::vector<THnSparseD *> matrices;
+  std::vector<std::pair<int, int>> pairs;
+};
+
+std::vector<CoincidenceHit> LoadHits(TFile *file,
+                                     const CoincidenceConfig &config) {
+  std::vector<CoincidenceHit> hits;
+  for (size_t d = 0; d < config.detectors.size(); ++d) {
+    TTree *tree = nullptr;
+    file->GetObject(config.detectors[d].c_str(), tree);
+    if (!tree) {
+      std::cerr << "Error: " << config.detectors[d] << " tree not found in "
+                << file->GetName() << "!" << std::endl;
+      continue;
+    }
+    std::string energyColumn =
+        config.broadened && tree->GetBranch("fEDepBroad") ? "fEDepBroad"
+                                                          : "fEDep";
+    // events without a hit in this detector are stored with time -1
+    ROOT::RDataFrame frame(*tree);
+    auto hitFrame = frame.Filter(
+        [](double time, double edep) { return time >= 0 && edep > 0; },
+        {"fTime", "fEDep"});
+    auto energies = hitFrame.Take<double>(energyColumn);
+    auto times = hitFrame.Take<double>("fTime");
+    auto events = hitFrame.Take<ULong64_t>("rdfentry_");
+    bool weighted = tree->GetBranch("fWeight");
+    auto weights = weighted ? hitFrame.Take<double>("fWeight")
+                            : hitFrame.Define("one", [] { return 1.; })
+                                  .Take<double>("one");
+    for (size_t i = 0; i < times->size(); ++i) {
+      hits.push_back({(*events)[i], (*times)[i], (*energies)[i], (*weights)[i],
+                      (int)d});
+    }
+    std::cout << config.detectors[d] << ": " << times->size() << " hits ("
+              << energyColumn << ")" << std::endl;
+  }
+  return hits;
+}
+
+CoincidenceResult MakeResult(const CoincidenceConfig &config,
+                             const std::string &suffix) {
+  CoincidenceResult result;
+  size_t nDetectors = config.detectors.size();
+  for (size_t d = 0; d < nDetectors; ++d) {
+    const std::string &name = config.detectors[d];
+    TH1D *coincidence = new TH1D(
+        (name + "_coincidence" + suffix).c_str(),
+        (name + " in coincidence;Energy (MeV);Counts").c_str(), config.nbins,
+        config.energyMin, config.energyMax);
+    TH1D *antiCoincidence = new TH1D(
+        (name + "_anticoincidence" + suffix).c_str(),
+        (name + " in anti-coincidence;Energy (MeV);Counts").c_str(),
+        config.nbins, config.energyMin, config.energyMax);
+    coincidence->SetDirectory(nullptr);
+    antiCoincidence->SetDirectory(nullptr);
+    coincidence->Sumw2();
+    antiCoincidence->Sumw2();
+    result.coincidence.push_back(coincidence);
+    result.antiCoincidence.push_back(antiCoincidence);
+  }
+  for (size_t a = 0; a < nDetectors; ++a) {
+    for (size_t b = a + 1; b < nDetectors; ++b) {
+      std::string name =
+          config.detectors[a] + "_vs_" + config.detectors[b] + suffix;
+      Int_t bins[2] = {config.nbins, config.nbins};
+      Double_t mins[2] = {config.energyMin, config.energyMin};
+      Double_t maxs[2] = {config.energyMax, config.energyMax};
+      THnSparseD *matrix =
+          new THnSparseD(name.c_str(), name.c_str(), 2, bins, mins, maxs);
+      matrix->Sumw2();
+      result.matrices.push_back(matrix);
+      result.pairs.push_back({(int)a, (int)b});
+    }
+  }
+  return result;
+}
+
+int PairIndex(const CoincidenceResult &result, int a, int b) {
+  for (size_t p = 0; p < result.pairs.size(); ++p) {
+    if (result.pairs[p].first == a && result.pairs[p].second == b)
+      return p;
+  }
+  return -1;
+}
+
+void SweepChunk(const std::vector<CoincidenceHit> &hits, size_t first,
+                size_t last, const CoincidenceConfig &config,
+                CoincidenceResult &result) {
+  size_t nDetectors = config.detectors.size();
+  std::vector<char> fired(nDetectors);
+  size_t low = first;
+  size_t high = first;
+  for (size_t i = first; i < last; ++i) {
+    const CoincidenceHit &hit = hits[i];
+    // low may have to move back once at the start of a chunk
+    while (low > 0 && hits[low - 1].event == hit.event &&
+           hits[low - 1].time >= hit.time - config.window)
+      --low;
+    while (hits[low].event != hit.event ||
+           hits[low].time < hit.time - config.window)
+      ++low;
+    if (high < i)
+      high = i;
+    while (high + 1 < hits.size() && hits[high + 1].event == hit.event &&
+           hits[high + 1].time <= hit.time + config.window)
+      ++high;
+
+    std::fill(fired.begin(), fired.end(), 0);
+    fired[hit.detector] = 1;
+    for (size_t j = low; j <= high; ++j) {
+      if (j == i || hits[j].detector == hit.detector)
+        continue;
+      fired[hits[j].detector] = 1;
+      // every pair is filled once, from its earlier hit (or lower index)
+      if (j > i) {
+        int a = std::min(hit.detector, hits[j].detector);
+        int b = std::max(hit.detector, hits[j].detector);
+        Double_t energies[2];
+        energies[0] = hit.detector == a ? hit.energy : hits[j].energy;
+        energies[1] = hit.detector == a ? hits[j].energy : hit.energy;
+        result.matrices[PairIndex(result, a, b)]->Fill(energies, hit.weight);
+      }
+    }
+    int multiplicity = std::count(fired.begin(), fired.end(), 1);
+    if (multiplicity == 1)
+      result.antiCoincidence[hit.detector]->Fill(hit.energy, hit.weight);
+    if (multiplicity >= config.minMultiplicity)
+      result.coincidence[hit.detector]->Fill(hit.energy, hit.weight);
+  }
+}
+
+CoincidenceResult BuildCoincidences(const char *fileName,
+                                    const CoincidenceConfig &config) {
+  CoincidenceResult result = MakeResult(config, "");
+  TFile *file = TFile::Open(fileName);
+  if (!file || file->IsZombie()) {
+    std::cerr << "Error opening file " << fileName << "!" << std::endl;
+    delete file;
+    return result;
+  }
+  std::vector<CoincidenceHit> hits = LoadHits(file, config);
+  file->Close();
+  delete file;
+  if (hits.empty())
+    return result;
+  std::sort(hits.begin(), hits.end());
+
+  ROOT::EnableThreadSafety();
+  ROOT::TThreadExecutor pool;
+  size_t nChunks = std::min<size_t>(hits.size(), 4 * pool.GetPoolSize());
+  std::vector<CoincidenceResult> partials;
+  for (size_t c = 0; c < nChunks; ++c) {
+    partials.push_back(MakeResult(config, "_" + std::to_string(c)));
+  }
+  pool.Foreach(
+      [&](size_t c) {
+        size_t first = hits.size() * c / nChunks;
+        size_t last = hits.size() * (c + 1) / nChunks;
+        SweepChunk(hits, first, last, config, partials[c]);
+      },
+      ROOT::TSeqUL(nChunks));
+
+  for (CoincidenceResult &partial : partials) {
+    for (size_t d = 0; d < config.detectors.size(); ++d) {
+      result.coincidence[d]->Add(partial.coincidence[d]);
+      result.antiCoincidence[d]->Add(partial.antiCoincidence[d]);
+      delete partial.coincidence[d];
+      delete partial.antiCoincidence[d];
+    }
+    for (size_t p = 0; p < result.matrices.size(); ++p) {
+      result.matrices[p]->Add(partial.matrices[p]);
+      delete partial.matrices[p];
+    }
+  }
+  return result;
+}
+
+void WriteCoincidences(const CoincidenceResult &result,
+                       const char *outputName) {
+  TFile *output = TFile::Open(outputName, "RECREATE");
+  if (!output || !output->IsOpen()) {
+    std::cerr << "Error creating " << outputName << "!" << std::endl;
+    delete output;
+    return;
+  }
+  for (size_t d = 0; d < result.coincidence.size(); ++d) {
+    result.coincidence[d]->Write();
+    result.antiCoincidence[d]->Write();
+    std::cout << result.coincidence[d]->GetName() << ": "
+              << result.coincidence[d]->GetEntries() << ", "
+              << result.antiCoincidence[d]->GetName() << ": "
+              << result.antiCoincidence[d]->GetEntries() << std::endl;
+  }
+  for (THnSparseD *matrix : result.matrices) {
+    matrix->Write();
+    // projection for a quick look in a TBrowser
+    TH2D *projection = matrix->Projection(1, 0);
+    projection->SetName(TString(matrix->GetName()) + "_2D");
+    projection->Write();
+    delete projection;
+  }
+  output->Close();
+  delete output;
+  std::cout << "Wrote " << outputName << std::endl;
+}
+
+void RunCoincidence(const char *fileName, const CoincidenceConfig &config,
+                    const char *outputName) {
+  CoincidenceResult result = BuildCoincidences(fileName, config);
+  WriteCoincidences(result, outputName);
+  for (size_t d = 0; d < result.coincidence.size(); ++d) {
+    delete result.coincidence[d];
+    delete result.antiCoincidence[d];
+  }
+  for (THnSparseD *matrix : result.matrices) {
+    delete matrix;
+  }
+}
@@ -1,9 +1,98 @@
 #include "construction.hh"
+
+#include "G4UImanager.hh"
+#include <sstream>
+
 // Define the static member
 DetectorConstruction::DetectorConstruction(G4double thick, G4double len_wid)
-    : fThick(thick), fLen_wid(len_wid) {}
+    : fThick(thick), fLen_wid(len_wid), logicGe(nullptr),
+      logicAirLayer(nullptr) {
+  DefineCommands();
+}
+
+DetectorConstruction::~DetectorConstruction() { delete fMessenger; }
+
+void DetectorConstruction::DefineCommands() {
+  // the geometry is shared, only the master may change it
+  fMessenger =
+      new G4GenericMessenger(this, "/detector/", "Germanium sample size");
+  fMessenger
+      ->DeclareMethodWithUnit("thickness", "cm",
+                              &DetectorConstruction::SetThickness,
+                              "Full thickness of the sample")
+      .SetToBeBroadcasted(false);
+  fMessenger
+      ->DeclareMethodWithUnit("lengthWidth", "cm",
+                              &DetectorConstruction::SetLengthWidth,
+                              "Full length and width of the sample")
+      .SetToBeBroadcasted(false);
+  // one parameter per field, a generic method only gets the first word
+  G4UIcommand *point = fCommands.Declare(
+      "/detector/point",
+      {{"thickness", 'd'}, {"length", 'd'}, {"events", 'i'}},
+      [this](const G4String &args) { RunPoint(args); },
+      "<thickness> <length> <events>: one run of a sweep point in cm, "
+      "written to t<thickness>_l<length>");
+  point->AvailableForStates(G4State_Idle);
+  point->SetToBeBroadcasted(false);
+}
+
+void DetectorConstruction::SetThickness(G4double thickness) {
+  if (thickness <= 0.) {
+    G4Exception("DetectorConstruction::SetThickness", "BadSize",
+                JustWarning, "The thickness has to be positive, ignored");
+    return;
+  }
+  fThick = thickness / 2;
+  Rebuild();
+}
+
+void DetectorConstruction::SetLengthWidth(G4double lengthWidth) {
+  if (lengthWidth <= 0.) {
+    G4Exception("DetectorConstruction::SetLengthWidth", "BadSize",
+                JustWarning, "The length has to be positive, ignored");
+    return;
+  }
+  fLen_wid = lengthWidth / 2;
+  Rebuild();
+}
 
-DetectorConstruction::~DetectorConstruction() {}
+void DetectorConstruction::Rebuild() {
+  // before /run/initialize the sizes are simply used by Construct
+  if (!logicGe)
+    return;
+  // only the sizes change, the materials and so the physics tables (and
+  // the cache entry) stay the same
+  G4RunManager::GetRunManager()->ReinitializeGeometry(true);
+}
+
+void DetectorConstruction::RunPoint(const G4String &args) {
+  std::istringstream fields(args);
+  G4double thickness = 0., length = 0.;
+  G4int events = 0;
+  fields >> thickness >> length >> events;
+  if (fields.fail() || thickness <= 0. || length <= 0. || events < 0) {
+    G4Exception("DetectorConstruction::RunPoint", "BadPoint", JustWarning,
+                ("Expected '<thickness> <length> <events>', got '" + args +
+                 "'")
+                    .c_str());
+    return;
+  }
+
+  // one rebuild for both sizes, none if the point is the current geometry
+  if (thickness / 2 * cm != fThick || length / 2 * cm != fLen_wid) {
+    fThick = thickness / 2 * cm;
+    fLen_wid = length / 2 * cm;
+    Rebuild();
+  }
+  std::ostringstream name;
+  name << "t" << thickness << "_l" << length;
+  fOutputName = name.str();
+  std::ostringstream beamOn;
+  beamOn << "/run/beamOn " << events;
+  G4UImanager::GetUIpointer()->ApplyCommand(beamOn.str());
+  fOutputName = "";
+}
 
 G4VPhysicalVolume *DetectorConstruction::Construct() {
   G4NistManager *nist = G4NistManager::Instance();
@@ -80,9 +169,22 @@ G4VPhysicalVolume *DetectorConstruction::Construct() {
 }
 
 void DetectorConstruction::ConstructSDandField() {
-  SensitiveDetector *sensDet = new SensitiveDetector("Germanium");
+  // called again on every thread after a rebuild, the detectors of the
+  // thread are reused
+  G4SDManager *sdManager = G4SDManager::GetSDMpointer();
+  G4VSensitiveDetector *sensDet =
+      sdManager->FindSensitiveDetector("Germanium", false);
+  if (!sensDet) {
+    sensDet = new SensitiveDetector("Germanium");
+    sdManager->AddNewDetector(sensDet);
+  }
   logicGe->SetSensitiveDetector(sensDet);
 
-  SensitiveDetector *sensDetAir = new SensitiveDetector("Air");
+  G4VSensitiveDetector *sensDetAir =
+      sdManager->FindSensitiveDetector("Air", false);
+  if (!sensDetAir) {
+    sensDetAir = new SensitiveDetector("Air");
+    sdManager->AddNewDetector(sensDetAir);
+  }
   logicAirLayer->SetSensitiveDetector(sensDetAir);
 }
@@ -3,6 +3,7 @@
 
 #include "G4Box.hh"
 #include "G4Exception.hh"
+#include "G4GenericMessenger.hh"
 #include "G4LatticeLogical.hh"
 #include "G4LatticeManager.hh"
 #include "G4LatticePhysical.hh"
@@ -11,6 +12,7 @@
 #include "G4PVPlacement.hh"
 #include "G4RotationMatrix.hh"
 #include "G4RunManager.hh"
+#include "G4SDManager.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4Tubs.hh"
 #include "G4VPhysicalVolume.hh"
@@ -19,6 +21,7 @@
 #include "action.hh"
 #include "cmath"
 #include "detector.hh"
+#include "messenger.hh"
 
 class DetectorConstruction : public G4VUserDetectorConstruction {
 public:
@@ -27,7 +30,22 @@ public:
 
   virtual G4VPhysicalVolume *Construct();
 
+  // run output name set by /detector/point, empty for output<run>
+  const G4String &GetOutputName() const { return fOutputName; }
+
+  // full sizes, rebuild the geometry when called after /run/initialize
+  void SetThickness(G4double thickness);
+  void SetLengthWidth(G4double lengthWidth);
+  // "<thickness> <length> <events>", sizes in cm
+  void RunPoint(const G4String &args);
+
 private:
+  void DefineCommands();
+  void Rebuild();
+
+  G4GenericMessenger *fMessenger;
+  ArgumentMessenger fCommands;
+  G4String fOutputName;
   G4double fThick;
   G4double fLen_wid;
   G4LogicalVolume *logicGe;
@@ -30,6 +30,8 @@ G4bool SensitiveDetector::ProcessHits(G4Step *aStep,
         man->AddNtupleRow(0);
         man->FillNtupleIColumn(1, 0, 1); // Identifier for detected gamma
         man->AddNtupleRow(1);
+        *G4AccumulableManager::Instance()->GetAccumulable<G4int>(
+            "Detected") += 1;
       }
     }
   } else if (volumeName == "physAirLayer") {
@@ -39,6 +41,8 @@ G4bool SensitiveDetector::ProcessHits(G4Step *aStep,
         G4AnalysisManager *man = G4AnalysisManager::Instance();
         man->FillNtupleIColumn(2, 0, 1); // Marked as escaped
         man->AddNtupleRow(2);
+        *G4AccumulableManager::Instance()->GetAccumulable<G4int>(
+            "Escaped") += 1;
       }
     }
   }
@@ -1,6 +1,7 @@
 #ifndef DETECTOR_HH
 #define DETECTOR_HH
 
+#include "G4AccumulableManager.hh"
 #include "G4AnalysisManager.hh"
 #include "G4Gamma.hh"
 #include "G4RunManager.hh"
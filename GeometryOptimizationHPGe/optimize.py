@@ -0,0 +1,285 @@
+import argparse
+import csv
+import os
+import sys
+from concurrent.futures import ThreadPoolExecutor
+
+import numpy as np
+from scipy.optimize import minimize
+from scipy.stats import norm
+
+import sweep
+
+# Bayesian optimization of the germanium sample size for the detected
+# fraction of 68.75 keV gammas. Run from GeometryOptimizationHPGe after
+# building in build/. A Gaussian process is fitted to the fractions measured
+# so far, with their binomial variances as noise. Every iteration runs the
+# --batch points of highest expected improvement, with as many events as the
+# surrogate is uncertain there. The points go through sweep.run_batch, so
+# every process initializes once and shares the physics table cache.
+# Stops when no point is expected to improve the best by more than
+# --tolerance or the event budget is spent.
+
+
+class GaussianProcess:
+    # Matern 5/2 on inputs scaled to [0, 1], known per-point noise
+
+    def __init__(self, x, y, noise):
+        self.x = x
+        self.mean = y.mean()
+        self.scale = y.std() if y.std() > 0 else 1.
+        self.y = (y - self.mean) / self.scale
+        self.noise = noise / self.scale**2
+        self.theta = self.fit()
+        self.factorize()
+
+    def kernel(self, a, b, theta=None):
+        variance, *lengths = np.exp(self.theta if theta is None else theta)
+        d = np.sqrt(((a[:, None, :] - b[None, :, :])**2 /
+                     np.square(lengths)).sum(axis=2))
+        r = np.sqrt(5.) * d
+        return variance * (1. + r + r * r / 3.) * np.exp(-r)
+
+    def negative_log_likelihood(self, theta):
+        k = self.kernel(self.x, self.x, theta) + np.diag(self.noise + 1e-9)
+        try:
+            chol = np.linalg.cholesky(k)
+        except np.linalg.LinAlgError:
+            return 1e10
+        alpha = np.linalg.solve(chol.T, np.linalg.solve(chol, self.y))
+        return 0.5 * self.y @ alpha + np.log(np.diag(chol)).sum()
+
+    def fit(self):
+        # log signal variance and log length scales, a few restarts
+        bounds = [(-4., 4.), (np.log(0.05), np.log(5.)),
+                  (np.log(0.05), np.log(5.))]
+        rng = np.random.default_rng(len(self.y))
+        best = None
+        for start in [np.zeros(3)] + [rng.uniform(*zip(*bounds))
+                                      for _ in range(4)]:
+            result = minimize(self.negative_log_likelihood, start,
+                              method='L-BFGS-B', bounds=bounds)
+            if best is None or result.fun < best.fun:
+                best = result
+        return best.x
+
+    def factorize(self):
+        k = self.kernel(self.x, self.x) + np.diag(self.noise + 1e-9)
+        self.chol = np.linalg.cholesky(k)
+        self.alpha = np.linalg.solve(self.chol.T,
+                                     np.linalg.solve(self.chol, self.y))
+
+    def predict(self, x):
+        k = self.kernel(x, self.x)
+        mean = k @ self.alpha
+        v = np.linalg.solve(self.chol, k.T)
+        variance = np.exp(self.theta[0]) - (v * v).sum(axis=0)
+        std = np.sqrt(np.maximum(variance, 1e-12))
+        return self.mean + self.scale * mean, self.scale * std
+
+    def add_liar(self, x, y):
+        # constant liar for batches: pretend the point was measured at the
+        # predicted mean, keep the hyperparameters
+        self.x = np.vstack([self.x, x])
+        self.y = np.append(self.y, (y - self.mean) / self.scale)
+        self.noise = np.append(self.noise, 1e-6)
+        self.factorize()
+
+
+def expected_improvement(mean, std, best):
+    z = (mean - best) / std
+    return (mean - best) * norm.cdf(z) + std * norm.pdf(z)
+
+
+class Optimizer:
+
+    def __init__(self, args):
+        self.args = args
+        self.low = np.array([args.thickness[0], args.length[0]])
+        self.high = np.array([args.thickness[1], args.length[1]])
+        # counts pooled per point, (thickness, length) -> [events, detected]
+        self.counts = {}
+        self.history = []
+        self.events_used = 0
+        self.rng = np.random.default_rng(args.seed)
+
+    def scale(self, points):
+        return (np.asarray(points) - self.low) / (self.high - self.low)
+
+    def snap(self, x):
+        # points on a --resolution grid so repeats pool their counts
+        point = self.low + x * (self.high - self.low)
+        point = np.round(point / self.args.resolution) * self.args.resolution
+        return tuple(float(f'{v:g}') for v in
+                     np.clip(point, self.low, self.high))
+
+    def data(self):
+        points = list(self.counts)
+        events = np.array([self.counts[p][0] for p in points], dtype=float)
+        detected = np.array([self.counts[p][1] for p in points], dtype=float)
+        fraction = detected / events
+        # a point that saw nothing still has a variance of about 1/events^2
+        variance = np.maximum(fraction * (1. - fraction), 1. / events) / events
+        return points, fraction, variance
+
+    def run(self, iteration, batch):
+        # batch of (thickness, length, events)
+        jobs = max(1, min(self.args.cores // self.args.threads, len(batch)))
+        batches = sweep.split_points(batch, jobs)
+        rows = []
+        with ThreadPoolExecutor(max_workers=len(batches)) as pool:
+            names = [f'optimize{iteration}_{j}' for j in range(len(batches))]
+            for result in pool.map(
+                    lambda b: sweep.run_batch(self.args, *b),
+                    zip(names, batches)):
+                rows.extend(result)
+        for point, events, detected, _ in rows:
+            key = (point[0], point[1])
+            pooled = self.counts.setdefault(key, [0, 0])
+            pooled[0] += events
+            pooled[1] += detected
+            self.events_used += events
+            self.history.append((iteration, key[0], key[1], events, detected))
+        return len(rows)
+
+    def initial_design(self):
+        # Latin hypercube over the bounds
+        n = self.args.initial
+        x = np.column_stack([(self.rng.permutation(n) +
+                              self.rng.uniform(size=n)) / n
+                             for _ in range(2)])
+        points = {self.snap(xi) for xi in x}
+        return [(t, l, self.args.min_events) for t, l in points]
+
+    def events_for(self, fraction, std):
+        # measure about as well as the surrogate is uncertain there, so no
+        # events are spent below what the model can tell apart anyway
+        target = max(self.args.noise_ratio * std,
+                     self.args.tolerance * max(fraction, 1e-6))
+        p = min(max(fraction, 1e-6), 1. - 1e-6)
+        events = int(np.ceil(p * (1. - p) / target**2 / 1000.)) * 1000
+        return int(np.clip(events, self.args.min_events,
+                           self.args.max_events))
+
+    def propose(self, gp, best):
+        candidates = self.rng.uniform(size=(self.args.candidates, 2))
+        # and some around the points measured so far
+        points, fraction, _ = self.data()
+        incumbent = self.scale(points[int(np.argmax(fraction))])
+        local = incumbent + 0.05 * self.rng.standard_normal(
+            (self.args.candidates // 4, 2))
+        candidates = np.clip(np.vstack([candidates, local]), 0., 1.)
+
+        batch = []
+        best_ei = 0.
+        for _ in range(self.args.batch):
+            mean, std = gp.predict(candidates)
+            ei = expected_improvement(mean, std, best)
+            order = np.argsort(ei)[::-1]
+            for i in order:
+                point = self.snap(candidates[i])
+                if point not in [(t, l) for t, l, _ in batch]:
+                    break
+            if not batch:
+                best_ei = ei[i]
+            batch.append(point + (self.events_for(mean[i], std[i]),))
+            gp.add_liar(self.scale(point)[None, :], mean[i])
+        return batch, best_ei
+
+    def write(self):
+        with open(self.args.output, 'w', newline='') as f:
+            writer = csv.writer(f)
+            writer.writerow(['iteration', 'thickness_cm', 'length_cm',
+                             'events', 'detected', 'detected_err'])
+            for iteration, t, l, events, detected in self.history:
+                writer.writerow([iteration, t, l, events, detected,
+                                 sweep.binomial_error(detected, events)])
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Optimize the germanium sample size with a Gaussian '
+                    'process surrogate')
+    parser.add_argument('--thickness', type=float, nargs=2,
+                        default=[0.1, 3.], help='range in cm')
+    parser.add_argument('--length', type=float, nargs=2, default=[1., 10.],
+                        help='range of the length and width in cm')
+    parser.add_argument('--resolution', type=float, default=0.05,
+                        help='cm, smallest size step worth telling apart')
+    parser.add_argument('--initial', type=int, default=8,
+                        help='points of the initial design')
+    parser.add_argument('--batch', type=int, default=4,
+                        help='points per iteration')
+    parser.add_argument('--iterations', type=int, default=20)
+    parser.add_argument('--min-events', type=int, default=100000)
+    parser.add_argument('--max-events', type=int, default=10000000)
+    parser.add_argument('--budget', type=float, default=2e8,
+                        help='total events')
+    parser.add_argument('--noise-ratio', type=float, default=0.5,
+                        help='measurement error per point relative to the '
+                             'surrogate uncertainty there')
+    parser.add_argument('--tolerance', type=float, default=0.005,
+                        help='stop when the expected improvement is below '
+                             'this fraction of the best')
+    parser.add_argument('--candidates', type=int, default=2000)
+    parser.add_argument('--cores', type=int, default=os.cpu_count())
+    parser.add_argument('--threads', type=int, default=4,
+                        help='threads per process')
+    parser.add_argument('--grid-events', type=int, default=1000000,
+                        help='events per point of the grid to compare with')
+    parser.add_argument('--seed', type=int, default=1)
+    parser.add_argument('--output', default='optimize.csv')
+    args = parser.parse_args()
+    # sweep.write_macro falls back to args.events, every point here has its
+    # own
+    args.events = args.min_events
+
+    if not os.path.exists(os.path.join('build', 'sim')):
+        sys.exit('build/sim not found, build GeometryOptimizationHPGe first')
+
+    optimizer = Optimizer(args)
+    if optimizer.run(0, optimizer.initial_design()) < 2:
+        sys.exit('Not enough points of the initial design ran')
+
+    print(f"{'iter':>4} {'thick':>6} {'length':>6} {'fraction':>10} "
+          f"{'error':>9} {'max EI':>9} {'events':>10}")
+    for iteration in range(1, args.iterations + 1):
+        points, fraction, variance = optimizer.data()
+        gp = GaussianProcess(optimizer.scale(points), fraction, variance)
+        mean, _ = gp.predict(optimizer.scale(points))
+        best = mean.max()
+        incumbent = points[int(np.argmax(mean))]
+        events, detected = optimizer.counts[incumbent]
+        print(f'{iteration - 1:4d} {incumbent[0]:6g} {incumbent[1]:6g} '
+              f'{detected / events:10.4g} '
+              f'{sweep.binomial_error(detected, events) / events:9.2g}',
+              end='')
+
+        batch, best_ei = optimizer.propose(gp, best)
+        print(f' {best_ei:9.2g} {optimizer.events_used:10d}')
+        if best_ei < args.tolerance * best:
+            print('Expected improvement below tolerance')
+            break
+        if optimizer.events_used + sum(e for _, _, e in batch) > args.budget:
+            print('Event budget spent')
+            break
+        optimizer.run(iteration, batch)
+
+    optimizer.write()
+    points, fraction, variance = optimizer.data()
+    gp = GaussianProcess(optimizer.scale(points), fraction, variance)
+    mean, std = gp.predict(optimizer.scale(points))
+    i = int(np.argmax(mean))
+    print(f'Best: thickness {points[i][0]:g} cm, length {points[i][1]:g} cm,'
+          f' fraction {mean[i]:.4g} +- {std[i]:.2g} (surrogate)')
+
+    # the grid over the same bounds and resolution at --grid-events each
+    cells = np.floor((optimizer.high - optimizer.low) / args.resolution) + 1
+    grid = int(cells.prod()) * args.grid_events
+    print(f'Used {optimizer.events_used:.3g} events, the '
+          f'{int(cells[0])}x{int(cells[1])} grid would take {grid:.3g} '
+          f'({optimizer.events_used / grid:.1%})')
+
+
+if __name__ == '__main__':
+    main()
@@ -1,6 +1,6 @@
 #include "run.hh"
 
-RunAction::RunAction() {
+RunAction::RunAction() : fDetected("Detected", 0), fEscaped("Escaped", 0) {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
 
   man->CreateNtuple("Energy", "Energy");
@@ -18,17 +18,55 @@ RunAction::RunAction() {
   man->CreateNtuple("Counts Escaped", "Counts Escaped");
   man->CreateNtupleIColumn("Escaped");
   man->FinishNtuple(2);
+
+  G4AccumulableManager *accumulables = G4AccumulableManager::Instance();
+  accumulables->RegisterAccumulable(fDetected);
+  accumulables->RegisterAccumulable(fEscaped);
+
+  DefineCacheCommands();
+}
+RunAction::~RunAction() { delete fCacheMessenger; }
+
+void RunAction::DefineCacheCommands() {
+  // the tables are looked up during /run/initialize, so these have to come
+  // before it in the macro
+  fCacheMessenger =
+      new G4GenericMessenger(PhysicsTableCache::Instance(), "/physics/cache/",
+                             "Cache of the built physics tables");
+  fCacheMessenger->DeclareMethod("enable", &PhysicsTableCache::SetEnabled,
+                                 "Retrieve and store physics tables, off "
+                                 "by default");
+  fCacheMessenger->DeclareMethod(
+      "directory", &PhysicsTableCache::SetDirectory,
+      "Cache directory, shared by all jobs of a scan");
 }
-RunAction::~RunAction() {}
 void RunAction::BeginOfRunAction(const G4Run *run) {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
+  // the tables were built or retrieved just before this
+  if (IsMaster())
+    PhysicsTableCache::Instance()->Store();
+  G4AccumulableManager::Instance()->Reset();
   std::string runnumber = std::to_string(run->GetRunID());
-  G4String fileName = "output" + runnumber + ".root";
-  man->OpenFile(fileName);
+  // a /detector/point names the output after the point
+  const DetectorConstruction *detectorConstruction =
+      static_cast<const DetectorConstruction *>(
+          G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  fOutputName = detectorConstruction->GetOutputName();
+  if (fOutputName.empty())
+    fOutputName = "output" + runnumber;
+  man->OpenFile(fOutputName + ".root");
 }
-void RunAction::EndOfRunAction(const G4Run *) {
+void RunAction::EndOfRunAction(const G4Run *run) {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
 
   man->Write();
   man->CloseFile("output.root");
+
+  G4AccumulableManager::Instance()->Merge();
+  if (IsMaster()) {
+    // read by sweep.py
+    G4cout << "Counts " << fOutputName << ": "
+           << run->GetNumberOfEvent() << " events, " << fDetected.GetValue()
+           << " detected, " << fEscaped.GetValue() << " escaped" << G4endl;
+  }
 }
@@ -1,9 +1,14 @@
 #ifndef RUN_HH
 #define RUN_HH
 
+#include "G4Accumulable.hh"
+#include "G4AccumulableManager.hh"
 #include "G4AnalysisManager.hh"
+#include "G4GenericMessenger.hh"
 #include "G4Run.hh"
 #include "G4UserRunAction.hh"
+#include "cache.hh"
+#include "construction.hh"
 
 class RunAction : public G4UserRunAction {
 public:
@@ -12,6 +17,16 @@ public:
 
   virtual void BeginOfRunAction(const G4Run *);
   virtual void EndOfRunAction(const G4Run *);
+
+private:
+  void DefineCacheCommands();
+
+  G4GenericMessenger *fCacheMessenger;
+  G4String fOutputName;
+  // 68.75 keV gammas in the germanium and in the air around it, the same
+  // rows as the Counts ntuples, merged for the run summary
+  G4Accumulable<G4int> fDetected;
+  G4Accumulable<G4int> fEscaped;
 };
 
 #endif
@@ -2,7 +2,7 @@
 #include "construction.hh"
 
 // include physics files
-#include "physics.hh"
+#include "cache.hh"
 
 // include actions
 #include "action.hh"
@@ -17,6 +17,9 @@
 
 int main(int argc, char **argv) {
 
+  // -p <physics> picks the physics list, see physicslist.hh
+  G4String physicsConfig = TakePhysicsOption(argc, argv);
+
 #ifdef G4MULTITHREADED
   G4MTRunManager *runManager = new G4MTRunManager();
 #else
@@ -30,7 +33,8 @@ int main(int argc, char **argv) {
     thick = std::stod(argv[1]) / 2 * cm;
     len_wid = std::stod(argv[2]) / 2 * cm;
   }
-  runManager->SetUserInitialization(new PhysicsList());
+  runManager->SetUserInitialization(
+      new CachedPhysicsList(physicsConfig, "hpge"));
   runManager->SetUserInitialization(new DetectorConstruction(thick, len_wid));
   runManager->SetUserInitialization(new ActionInitialization());
 
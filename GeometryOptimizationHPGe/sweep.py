@@ -0,0 +1,141 @@
+import argparse
+import csv
+import itertools
+import math
+import os
+import re
+import subprocess
+import sys
+from concurrent.futures import ThreadPoolExecutor
+
+# Sweep of the germanium sample size. Run from GeometryOptimizationHPGe after
+# building in build/. The (thickness, length) points are dealt out to
+# --cores / --threads processes of --threads threads each; every process
+# initializes once and runs its points with /detector/point, which only
+# rebuilds the geometry. Processes share the physics table cache in build/.
+# The detected and escaped 68.75 keV counts of every point go to one CSV;
+# the ROOT outputs are left in build/ as t<thickness>_l<length>_t<i>.root.
+
+COUNTS = re.compile(r'Counts (\S+): (\d+) events, (\d+) detected, '
+                    r'(\d+) escaped')
+
+
+def point_name(point):
+    # same formatting as DetectorConstruction::RunPoint
+    return f't{point[0]:g}_l{point[1]:g}'
+
+
+def read_points(args):
+    if args.points:
+        points = []
+        with open(args.points) as f:
+            for line in f:
+                fields = line.split('#')[0].split()
+                if fields:
+                    points.append((float(fields[0]), float(fields[1])))
+        return points
+    return list(itertools.product(args.thickness, args.length))
+
+
+def split_points(points, jobs):
+    # sort by sample volume and deal round-robin, so every process gets a
+    # similar mix of small and large samples
+    ordered = sorted(points, key=lambda p: p[0] * p[1] * p[1])
+    batches = [ordered[i::jobs] for i in range(jobs)]
+    return [batch for batch in batches if batch]
+
+
+def write_macro(path, args, batch):
+    with open(path, 'w') as f:
+        f.write(f'/run/numberOfThreads {args.threads}\n')
+        f.write('/physics/cache/enable true\n')
+        f.write('/run/initialize\n')
+        f.write('/process/had/rdm/thresholdForVeryLongDecayTime '
+                '1.0e+60 year\n')
+        for point in batch:
+            # a third entry overrides the events of the point
+            events = point[2] if len(point) > 2 else args.events
+            f.write(f'/detector/point {point[0]:g} {point[1]:g} '
+                    f'{events}\n')
+
+
+def run_batch(args, name, batch):
+    # build/<name>.mac and build/<name>.log
+    macro = f'{name}.mac'
+    log_file = os.path.join('build', f'{name}.log')
+    write_macro(os.path.join('build', macro), args, batch)
+    # start from the first point so it needs no rebuild
+    command = ['./sim', f'{batch[0][0]:g}', f'{batch[0][1]:g}', macro]
+    with open(log_file, 'w') as log:
+        result = subprocess.run(command, cwd='build', stdout=log,
+                                stderr=subprocess.STDOUT)
+    with open(log_file) as log:
+        counts = {m.group(1): m.groups()[1:] for m in COUNTS.finditer(
+            log.read())}
+    if result.returncode != 0:
+        print(f'{name} exited with {result.returncode}, see {log_file}')
+    rows = []
+    for point in batch:
+        if point_name(point) not in counts:
+            print(f'No counts for {point_name(point)}, see {log_file}')
+            continue
+        events, detected, escaped = (int(v) for v in
+                                     counts[point_name(point)])
+        rows.append((point, events, detected, escaped))
+    print(f'{name} done, {len(rows)} of {len(batch)} points')
+    return rows
+
+
+def binomial_error(count, events):
+    if events == 0:
+        return 0.
+    p = count / events
+    return math.sqrt(events * p * max(1. - p, 0.))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Sweep the germanium sample size')
+    parser.add_argument('--thickness', type=float, nargs='+',
+                        default=[0.5], help='cm')
+    parser.add_argument('--length', type=float, nargs='+', default=[10.],
+                        help='length and width, cm')
+    parser.add_argument('--points', default=None,
+                        help='file of "thickness length" lines in cm '
+                             'instead of the grid')
+    parser.add_argument('--events', type=int, default=1000000)
+    parser.add_argument('--cores', type=int, default=os.cpu_count())
+    parser.add_argument('--threads', type=int, default=4,
+                        help='threads per process')
+    parser.add_argument('--output', default='sweep.csv')
+    args = parser.parse_args()
+
+    if not os.path.exists(os.path.join('build', 'sim')):
+        sys.exit('build/sim not found, build GeometryOptimizationHPGe first')
+
+    points = read_points(args)
+    jobs = max(1, min(args.cores // args.threads, len(points)))
+    batches = split_points(points, jobs)
+    print(f'{len(points)} points on {len(batches)} processes of '
+          f'{args.threads} threads')
+
+    with ThreadPoolExecutor(max_workers=len(batches)) as pool:
+        results = pool.map(lambda b: run_batch(args, f'sweep{b[0]}', b[1]),
+                           enumerate(batches))
+        rows = sorted(itertools.chain.from_iterable(results))
+
+    with open(args.output, 'w', newline='') as f:
+        writer = csv.writer(f)
+        writer.writerow(['thickness_cm', 'length_cm', 'events', 'detected',
+                         'detected_err', 'escaped', 'escaped_err'])
+        for (thickness, length), events, detected, escaped in rows:
+            writer.writerow([thickness, length, events,
+                             detected, binomial_error(detected, events),
+                             escaped, binomial_error(escaped, events)])
+    print(f'Wrote {len(rows)} points to {args.output}')
+    if len(rows) != len(points):
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -15,6 +15,9 @@ void ActionInitialization::Build() const {
 
   SteppingAction *steppingAction = new SteppingAction(eventAction);
   SetUserAction(steppingAction);
+
+  StackingAction *stackingAction = new StackingAction();
+  SetUserAction(stackingAction);
 }
 
 void ActionInitialization::BuildForMaster() const {
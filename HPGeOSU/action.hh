@@ -5,6 +5,7 @@
 #include "event.hh"
 #include "generator.hh"
 #include "run.hh"
+#include "stacking.hh"
 #include "stepping.hh"
 
 class ActionInitialization : public G4VUserActionInitialization {
@@ -4,10 +4,12 @@ import sys
 
 def combine_root_files(output_file, input_files):
     energy_chain = ROOT.TChain("Energy")
+    undecayed_chain = ROOT.TChain("Undecayed")
         
     # Add files to the chains
     for file_name in input_files:
         energy_chain.Add(file_name)
+        undecayed_chain.Add(file_name)
             
         
     # Create the output file
@@ -16,10 +18,12 @@ def combine_root_files(output_file, input_files):
     # Merge the chains into the output file
     output.cd()
     energy_tree = energy_chain.CloneTree(-1, "fast")
+    undecayed_tree = undecayed_chain.CloneTree(-1, "fast")
    
     
     # Write the trees to the output file
     energy_tree.Write()
+    undecayed_tree.Write()
 
     # Close the output file
     output.Close()
@@ -0,0 +1,90 @@
+#include "filter.hh"
+
+#include "G4AnalysisManager.hh"
+#include "G4AutoLock.hh"
+#include "G4DecayProcessType.hh"
+#include "G4Ions.hh"
+#include "G4LogicalVolume.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VProcess.hh"
+
+DecayFilter *DecayFilter::Instance() {
+  static DecayFilter instance;
+  return &instance;
+}
+
+DecayFilter::DecayFilter() : fMaxLifetime(0.) {}
+
+void DecayFilter::AddVolume(const G4String &volume) {
+  G4AutoLock lock(&fMutex);
+  fVolumes.insert(volume);
+}
+
+void DecayFilter::ClearVolumes() {
+  G4AutoLock lock(&fMutex);
+  fVolumes.clear();
+}
+
+void DecayFilter::AddNuclide(const G4String &nuclide) {
+  G4AutoLock lock(&fMutex);
+  fNuclides.insert(nuclide);
+}
+
+void DecayFilter::ClearNuclides() {
+  G4AutoLock lock(&fMutex);
+  fNuclides.clear();
+}
+
+void DecayFilter::SetMaxLifetime(G4double lifetime) {
+  G4AutoLock lock(&fMutex);
+  fMaxLifetime = lifetime;
+}
+
+G4bool DecayFilter::Suppress(const G4Track *track) const {
+  const G4ParticleDefinition *particle = track->GetDefinition();
+  if (particle->GetParticleType() != "nucleus" || particle->GetPDGStable() ||
+      particle->GetBaryonNumber() < 2)
+    return false;
+
+  if (fMaxLifetime > 0. && particle->GetPDGLifeTime() > fMaxLifetime)
+    return true;
+
+  // the parent of a decay product passed the nuclide and volume selections,
+  // so e.g. the As75 levels fed by a selected Ge75 still de-excite
+  const G4VProcess *creator = track->GetCreatorProcess();
+  if (creator && creator->GetProcessType() == fDecay &&
+      creator->GetProcessSubType() == DECAY_Radioactive)
+    return false;
+
+  if (!fNuclides.empty()) {
+    // "Ge71" selects the ground state and every level, "Ge73[66.725]" one
+    const G4String &name = particle->GetParticleName();
+    G4String groundState = name.substr(0, name.find('['));
+    if (!fNuclides.count(name) && !fNuclides.count(groundState))
+      return true;
+  }
+
+  if (!fVolumes.empty()) {
+    const G4VPhysicalVolume *volume = track->GetVolume();
+    if (!volume || !fVolumes.count(volume->GetLogicalVolume()->GetName()))
+      return true;
+  }
+  return false;
+}
+
+void DecayFilter::Tally(const G4Track *track) {
+  const G4Ions *ion = static_cast<const G4Ions *>(track->GetDefinition());
+  const G4VPhysicalVolume *volume = track->GetVolume();
+
+  G4AnalysisManager *man = G4AnalysisManager::Instance();
+  man->FillNtupleIColumn(1, 0, ion->GetAtomicNumber());
+  man->FillNtupleIColumn(1, 1, ion->GetAtomicMass());
+  man->FillNtupleDColumn(1, 2, ion->GetExcitationEnergy() / keV);
+  man->FillNtupleDColumn(1, 3, ion->GetPDGLifeTime() / s);
+  man->FillNtupleDColumn(1, 4, track->GetGlobalTime() / s);
+  man->FillNtupleSColumn(1, 5,
+                         volume ? volume->GetLogicalVolume()->GetName()
+                                : G4String("none"));
+  man->AddNtupleRow(1);
+}
@@ -0,0 +1,40 @@
+#ifndef FILTER_HH
+#define FILTER_HH
+
+#include "G4String.hh"
+#include "G4Threading.hh"
+#include "G4Track.hh"
+#include "G4Types.hh"
+#include <set>
+
+// Limits which nuclei are left to radioactive decay: only in the selected
+// volumes, only listed nuclides and only below a maximum mean life. Each
+// empty selection lets everything through. The products of an allowed decay
+// are only held to the mean life limit. Nuclei that are stopped without
+// decaying go to the Undecayed ntuple. Configured by the master run action
+// messenger between runs and read by the workers during them.
+class DecayFilter {
+public:
+  static DecayFilter *Instance();
+
+  void AddVolume(const G4String &volume);
+  void ClearVolumes();
+  void AddNuclide(const G4String &nuclide);
+  void ClearNuclides();
+  void SetMaxLifetime(G4double lifetime);
+
+  // Unstable nucleus that the filter would not let decay
+  G4bool Suppress(const G4Track *track) const;
+  static void Tally(const G4Track *track);
+
+private:
+  DecayFilter();
+  ~DecayFilter() {}
+
+  G4Mutex fMutex;
+  std::set<G4String> fVolumes;
+  std::set<G4String> fNuclides;
+  G4double fMaxLifetime;
+};
+
+#endif
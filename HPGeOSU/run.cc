@@ -5,8 +5,47 @@ RunAction::RunAction() {
   man->CreateNtuple("Energy", "Energy");
   man->CreateNtupleDColumn("fEdep");
   man->FinishNtuple(0);
+
+  // nuclei the decay filter stopped before they could decay
+  man->CreateNtuple("Undecayed", "Undecayed");
+  man->CreateNtupleIColumn("fZ");
+  man->CreateNtupleIColumn("fA");
+  man->CreateNtupleDColumn("fExcitation");
+  man->CreateNtupleDColumn("fLifetime");
+  man->CreateNtupleDColumn("fTime");
+  man->CreateNtupleSColumn("fVolume");
+  man->FinishNtuple(1);
+
+  // the filter is shared, only the master messenger may change it
+  fDecayMessenger = nullptr;
+  if (!G4Threading::IsMasterThread())
+    return;
+  DecayFilter *filter = DecayFilter::Instance();
+  fDecayMessenger = new G4GenericMessenger(
+      filter, "/rdm/filter/", "Which nuclei are left to radioactive decay");
+  fDecayMessenger
+      ->DeclareMethod("addVolume", &DecayFilter::AddVolume,
+                      "Decay only in this logical volume")
+      .SetToBeBroadcasted(false);
+  fDecayMessenger
+      ->DeclareMethod("clearVolumes", &DecayFilter::ClearVolumes,
+                      "Decay in every volume")
+      .SetToBeBroadcasted(false);
+  fDecayMessenger
+      ->DeclareMethod("addNuclide", &DecayFilter::AddNuclide,
+                      "Decay only this nuclide, e.g. Ge75 or Ge73[66.725]")
+      .SetToBeBroadcasted(false);
+  fDecayMessenger
+      ->DeclareMethod("clearNuclides", &DecayFilter::ClearNuclides,
+                      "Decay every nuclide")
+      .SetToBeBroadcasted(false);
+  fDecayMessenger
+      ->DeclareMethodWithUnit(
+          "maxLifetime", "s", &DecayFilter::SetMaxLifetime,
+          "Do not decay nuclei with a longer mean life, 0 for no limit")
+      .SetToBeBroadcasted(false);
 }
-RunAction::~RunAction() {}
+RunAction::~RunAction() { delete fDecayMessenger; }
 void RunAction::BeginOfRunAction(const G4Run *run) {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
   G4int runNumber = run->GetRunID();
@@ -0,0 +1,18 @@
+#include "stacking.hh"
+
+StackingAction::StackingAction() {}
+
+StackingAction::~StackingAction() {}
+
+G4ClassificationOfNewTrack
+StackingAction::ClassifyNewTrack(const G4Track *track) {
+  // nuclei produced at rest would decay on their first step, before the
+  // stepping action sees them; moving ones are stopped there instead so
+  // their recoil energy is still deposited
+  if (track->GetKineticEnergy() <= 0. &&
+      DecayFilter::Instance()->Suppress(track)) {
+    DecayFilter::Tally(track);
+    return fKill;
+  }
+  return fUrgent;
+}
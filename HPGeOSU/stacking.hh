@@ -0,0 +1,16 @@
+#ifndef STACKING_HH
+#define STACKING_HH
+
+#include "G4Track.hh"
+#include "G4UserStackingAction.hh"
+#include "filter.hh"
+
+class StackingAction : public G4UserStackingAction {
+public:
+  StackingAction();
+  ~StackingAction();
+
+  virtual G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track *);
+};
+
+#endif
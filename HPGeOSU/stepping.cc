@@ -7,6 +7,14 @@ SteppingAction::SteppingAction(EventAction *eventAction) {
 SteppingAction::~SteppingAction() {}
 
 void SteppingAction::UserSteppingAction(const G4Step *step) {
+  // a nucleus that just stopped decays at rest on its next step
+  G4Track *track = step->GetTrack();
+  if (track->GetTrackStatus() == fStopButAlive &&
+      DecayFilter::Instance()->Suppress(track)) {
+    DecayFilter::Tally(track);
+    track->SetTrackStatus(fStopAndKill);
+  }
+
   G4LogicalVolume *volume = step->GetPreStepPoint()
                                 ->GetTouchableHandle()
                                 ->GetVolume()
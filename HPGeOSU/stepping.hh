@@ -6,6 +6,7 @@
 
 #include "construction.hh"
 #include "event.hh"
+#include "filter.hh"
 
 class SteppingAction : public G4UserSteppingAction {
 public:
@@ -0,0 +1,149 @@
+#include "columnar.hh"
+
+#include "G4Exception.hh"
+#include <sstream>
+
+namespace {
+// magic + version + header length + padded dictionary, a multiple of 64 bytes
+// so it can be rewritten in place with the final row count on Close()
+const std::size_t kHeaderSize = 128;
+} // namespace
+
+ColumnarWriter::ColumnarWriter()
+    : fOpen(false), fRowGroupSize(65536), fRowsWritten(0) {}
+
+ColumnarWriter::~ColumnarWriter() { Close(); }
+
+G4int ColumnarWriter::AddDetector(const G4String &name) {
+  for (std::size_t i = 0; i < fDetectors.size(); ++i) {
+    if (fDetectors[i] == name)
+      return i;
+  }
+  fDetectors.push_back(name);
+  return fDetectors.size() - 1;
+}
+
+void ColumnarWriter::Open(const G4String &baseName) {
+  Close();
+  fBaseName = baseName;
+  fRowsWritten = 0;
+  fRowGroups.clear();
+
+  OpenColumn(fEventColumn, "fEventID", "<i8");
+  OpenColumn(fDetectorColumn, "fDetector", "|u1");
+  OpenColumn(fEdepColumn, "fEDep", "<f8");
+  OpenColumn(fEdepBroadColumn, "fEDepBroad", "<f8");
+  OpenColumn(fTimeColumn, "fTime", "<f8");
+  OpenColumn(fWeightColumn, "fWeight", "<f8");
+
+  fEventBuffer.reserve(fRowGroupSize);
+  fDetectorBuffer.reserve(fRowGroupSize);
+  fEdepBuffer.reserve(fRowGroupSize);
+  fEdepBroadBuffer.reserve(fRowGroupSize);
+  fTimeBuffer.reserve(fRowGroupSize);
+  fWeightBuffer.reserve(fRowGroupSize);
+  fOpen = true;
+}
+
+void ColumnarWriter::OpenColumn(Column &column, const G4String &name,
+                                const G4String &descr) {
+  G4String fileName = fBaseName + "." + name + ".npy";
+  column.descr = descr;
+  column.file.open(fileName, std::ios::binary | std::ios::out |
+                                 std::ios::trunc);
+  if (!column.file.is_open()) {
+    G4Exception("ColumnarWriter::OpenColumn", "FileNotOpened", FatalException,
+                ("Cannot open " + fileName).c_str());
+  }
+  WriteHeader(column, 0);
+}
+
+void ColumnarWriter::WriteHeader(Column &column, std::uint64_t rows) {
+  std::ostringstream dict;
+  dict << "{'descr': '" << column.descr
+       << "', 'fortran_order': False, 'shape': (" << rows << ",), }";
+  std::string header = dict.str();
+  header.resize(kHeaderSize - 10 - 1, ' ');
+  header += '\n';
+
+  std::uint16_t headerLength = header.size();
+  column.file.seekp(0);
+  column.file.write("\x93NUMPY\x01\x00", 8);
+  column.file.write(reinterpret_cast<const char *>(&headerLength), 2);
+  column.file.write(header.data(), header.size());
+}
+
+void ColumnarWriter::AddRow(G4int eventID, G4int detector, G4double edep,
+                            G4double edepBroad, G4double time,
+                            G4double weight) {
+  if (!fOpen)
+    return;
+  fEventBuffer.push_back(eventID);
+  fDetectorBuffer.push_back(detector);
+  fEdepBuffer.push_back(edep);
+  fEdepBroadBuffer.push_back(edepBroad);
+  fTimeBuffer.push_back(time);
+  fWeightBuffer.push_back(weight);
+  if ((G4int)fEdepBuffer.size() >= fRowGroupSize)
+    Flush();
+}
+
+void ColumnarWriter::Flush() {
+  if (!fOpen || fEdepBuffer.empty())
+    return;
+
+  std::size_t rows = fEdepBuffer.size();
+  fEventColumn.file.write(reinterpret_cast<const char *>(fEventBuffer.data()),
+                          rows * sizeof(std::int64_t));
+  fDetectorColumn.file.write(
+      reinterpret_cast<const char *>(fDetectorBuffer.data()),
+      rows * sizeof(std::uint8_t));
+  fEdepColumn.file.write(reinterpret_cast<const char *>(fEdepBuffer.data()),
+                         rows * sizeof(G4double));
+  fEdepBroadColumn.file.write(
+      reinterpret_cast<const char *>(fEdepBroadBuffer.data()),
+      rows * sizeof(G4double));
+  fTimeColumn.file.write(reinterpret_cast<const char *>(fTimeBuffer.data()),
+                         rows * sizeof(G4double));
+  fWeightColumn.file.write(
+      reinterpret_cast<const char *>(fWeightBuffer.data()),
+      rows * sizeof(G4double));
+
+  fRowsWritten += rows;
+  fRowGroups.push_back(rows);
+
+  fEventBuffer.clear();
+  fDetectorBuffer.clear();
+  fEdepBuffer.clear();
+  fEdepBroadBuffer.clear();
+  fTimeBuffer.clear();
+  fWeightBuffer.clear();
+}
+
+void ColumnarWriter::WriteMetadata() {
+  std::ofstream meta(fBaseName + ".meta.json");
+  meta << "{\n  \"rows\": " << fRowsWritten << ",\n  \"row_groups\": [";
+  for (std::size_t i = 0; i < fRowGroups.size(); ++i) {
+    meta << (i ? ", " : "") << fRowGroups[i];
+  }
+  meta << "],\n  \"fDetector\": [";
+  for (std::size_t i = 0; i < fDetectors.size(); ++i) {
+    meta << (i ? ", " : "") << "\"" << fDetectors[i] << "\"";
+  }
+  meta << "]\n}\n";
+}
+
+void ColumnarWriter::Close() {
+  if (!fOpen)
+    return;
+  Flush();
+
+  Column *columns[] = {&fEventColumn, &fDetectorColumn, &fEdepColumn,
+                       &fEdepBroadColumn, &fTimeColumn, &fWeightColumn};
+  for (Column *column : columns) {
+    WriteHeader(*column, fRowsWritten);
+    column->file.close();
+  }
+  WriteMetadata();
+  fOpen = false;
+}
@@ -0,0 +1,57 @@
+#ifndef COLUMNAR_HH
+#define COLUMNAR_HH
+
+#include "G4String.hh"
+#include "G4Types.hh"
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+// Writes the detector ntuples as uncompressed NumPy (.npy) columns so the
+// Python scripts can np.load(..., mmap_mode='r') them without any conversion.
+// One file per column per thread; every Flush() appends one row group.
+class ColumnarWriter {
+public:
+  ColumnarWriter();
+  ~ColumnarWriter();
+
+  void Open(const G4String &baseName);
+  void Close();
+  G4bool IsOpen() const { return fOpen; }
+
+  // dictionary encoding of the detector name, codes are assigned in order
+  G4int AddDetector(const G4String &name);
+
+  void AddRow(G4int eventID, G4int detector, G4double edep,
+              G4double edepBroad, G4double time, G4double weight = 1.);
+  void Flush();
+
+  void SetRowGroupSize(G4int rows) { fRowGroupSize = rows; }
+
+private:
+  struct Column {
+    std::ofstream file;
+    G4String descr;
+  };
+
+  void OpenColumn(Column &column, const G4String &name, const G4String &descr);
+  void WriteHeader(Column &column, std::uint64_t rows);
+  void WriteMetadata();
+
+  G4String fBaseName;
+  G4bool fOpen;
+  G4int fRowGroupSize;
+  std::uint64_t fRowsWritten;
+
+  std::vector<G4String> fDetectors;
+  std::vector<std::uint64_t> fRowGroups;
+
+  Column fEventColumn, fDetectorColumn, fEdepColumn, fEdepBroadColumn;
+  Column fTimeColumn, fWeightColumn;
+  std::vector<std::int64_t> fEventBuffer;
+  std::vector<std::uint8_t> fDetectorBuffer;
+  std::vector<G4double> fEdepBuffer, fEdepBroadBuffer, fTimeBuffer;
+  std::vector<G4double> fWeightBuffer;
+};
+
+#endif
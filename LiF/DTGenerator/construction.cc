@@ -1,9 +1,14 @@
 #include "construction.hh"
 #include "G4UnitsTable.hh"
 
-DetectorConstruction::DetectorConstruction() {}
+DetectorConstruction::DetectorConstruction()
+    : fLaBr3Response(new ScintillatorResponse("labr3")),
+      fCeBr3Response(new ScintillatorResponse("cebr3")) {}
 
-DetectorConstruction::~DetectorConstruction() {}
+DetectorConstruction::~DetectorConstruction() {
+  delete fLaBr3Response;
+  delete fCeBr3Response;
+}
 
 G4VPhysicalVolume *DetectorConstruction::Construct() {
   G4NistManager *nist = G4NistManager::Instance();
@@ -26,6 +31,7 @@ G4VPhysicalVolume *DetectorConstruction::Construct() {
 
   G4Box *solidLiF = new G4Box("LiF", 0.5 * cm, 0.5 * cm, 0.5 * cm);
   G4LogicalVolume *logicLiF = new G4LogicalVolume(solidLiF, LiF, "LiF");
+  fLiFVolume = logicLiF;
 
   G4Material *LaBr3 = new G4Material("LaBr3Ce", 5.08 * g / cm3, 3);
   LaBr3->AddElement(nist->FindOrBuildElement("Br"), 0.640569);
@@ -36,6 +42,10 @@ G4VPhysicalVolume *DetectorConstruction::Construct() {
       new G4Tubs("LaBr3", 0, 1.5 * inch / 2, 1.5 * inch / 2, 0, 360 * deg);
 
   fScoringVolumeLaBr3 = new G4LogicalVolume(solidLaBr3, LaBr3, "LaBr3");
+  // regions for the fast scintillator response models
+  fLaBr3Region = new G4Region("LaBr3");
+  fLaBr3Region->AddRootLogicalVolume(fScoringVolumeLaBr3);
+  fLaBr3Response->SetCrystal(fScoringVolumeLaBr3);
 
   G4Material *CeBr3 = new G4Material("CeBr3", 5.2 * g / cm3, 2);
   CeBr3->AddElement(nist->FindOrBuildElement("Ce"), 0.36893); // 36.893% cerium
@@ -44,6 +54,9 @@ G4VPhysicalVolume *DetectorConstruction::Construct() {
   G4Tubs *solidCeBr3 =
       new G4Tubs("CeBr3", 0, 1 * inch / 2, 1 * inch / 2, 0, 360 * deg);
   fScoringVolumeCeBr3 = new G4LogicalVolume(solidCeBr3, CeBr3, "CeBr3");
+  fCeBr3Region = new G4Region("CeBr3");
+  fCeBr3Region->AddRootLogicalVolume(fScoringVolumeCeBr3);
+  fCeBr3Response->SetCrystal(fScoringVolumeCeBr3);
 
   G4double halfcm = 0.5 * cm;
   // Place LiF after the lead wall
@@ -80,4 +93,12 @@ void DetectorConstruction::ConstructSDandField() {
   // LaBr3 sensitive detector
   SensitiveDetector *CeBr3SD = new SensitiveDetector("CeBr3");
   fScoringVolumeCeBr3->SetSensitiveDetector(CeBr3SD);
+
+  // one operator per thread, scaled with /bias/capture/factor
+  CaptureBiasing *captureBiasing = new CaptureBiasing();
+  captureBiasing->AttachTo(fLiFVolume);
+
+  // idle unless /labr3/fastsim/mode or /cebr3/fastsim/mode fast
+  new ScintillatorFastSim("LaBr3Response", fLaBr3Region, fLaBr3Response);
+  new ScintillatorFastSim("CeBr3Response", fCeBr3Region, fCeBr3Response);
 }
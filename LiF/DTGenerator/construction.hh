@@ -5,6 +5,7 @@
 #include "G4LogicalVolume.hh"
 #include "G4NistManager.hh"
 #include "G4PVPlacement.hh"
+#include "G4Region.hh"
 #include "G4RotationMatrix.hh"
 #include "G4SubtractionSolid.hh"
 #include "G4SystemOfUnits.hh"
@@ -12,8 +13,10 @@
 #include "G4VPhysicalVolume.hh"
 #include "G4VUserDetectorConstruction.hh"
 #include "G4VisAttributes.hh"
+#include "bias.hh"
 #include "cmath"
 #include "detector.hh"
+#include "scintillator.hh"
 
 class DetectorConstruction : public G4VUserDetectorConstruction {
 public:
@@ -25,11 +28,18 @@ public:
   G4LogicalVolume *GetScoringVolumeCeBr3() const {
     return fScoringVolumeCeBr3;
   };
+  ScintillatorResponse *GetLaBr3Response() const { return fLaBr3Response; }
+  ScintillatorResponse *GetCeBr3Response() const { return fCeBr3Response; }
   virtual G4VPhysicalVolume *Construct();
 
 private:
+  G4LogicalVolume *fLiFVolume;
   G4LogicalVolume *fScoringVolumeLaBr3;
   G4LogicalVolume *fScoringVolumeCeBr3;
+  G4Region *fLaBr3Region;
+  G4Region *fCeBr3Region;
+  ScintillatorResponse *fLaBr3Response;
+  ScintillatorResponse *fCeBr3Response;
   virtual void ConstructSDandField();
 };
 
@@ -1,14 +1,27 @@
 #include "event.hh"
 
-EventAction::EventAction(RunAction *) {
+#include "bias.hh"
+
+EventAction::EventAction(RunAction *runAction)
+    : fRunAction(runAction),
+      fLaBr3Recorder(static_cast<const DetectorConstruction *>(
+                         G4RunManager::GetRunManager()
+                             ->GetUserDetectorConstruction())
+                         ->GetLaBr3Response()),
+      fCeBr3Recorder(static_cast<const DetectorConstruction *>(
+                         G4RunManager::GetRunManager()
+                             ->GetUserDetectorConstruction())
+                         ->GetCeBr3Response()) {
   fEdepLaBr3 = fEdepCeBr3 = 0.;
   fTimeLaBr3 = fTimeCeBr3 = -1.;
+  fWeight = 1.;
 }
 EventAction::~EventAction() {}
 
 void EventAction::BeginOfEventAction(const G4Event *) {
   fEdepLaBr3 = fEdepCeBr3 = 0.;
   fTimeLaBr3 = fTimeCeBr3 = -1.;
+  fWeight = 1.;
 }
 
 void EventAction::AddEdepLaBr3(G4double edep, G4double time) {
@@ -23,18 +36,40 @@ void EventAction::AddEdepCeBr3(G4double edep, G4double time) {
     fTimeCeBr3 = time;
 }
 
-void EventAction::EndOfEventAction(const G4Event *) {
+void EventAction::EndOfEventAction(const G4Event *event) {
+  CaptureBiasing::CheckEventWeight(fWeight);
+  fLaBr3Recorder.Flush();
+  fCeBr3Recorder.Flush();
   G4AnalysisManager *man = G4AnalysisManager::Instance();
   if (fEdepLaBr3 > 1e-7 || fEdepCeBr3 > 1e-7) {
+    const Digitizer *digitizer = fRunAction->GetDigitizer();
+    G4double edepBroadLaBr3 = digitizer->Digitize("LaBr3", fEdepLaBr3);
+    G4double edepBroadCeBr3 = digitizer->Digitize("CeBr3", fEdepCeBr3);
+
     // Column 0: LaBr3 Edep
     man->FillNtupleDColumn(0, 0, fEdepLaBr3 / MeV);
     // Column 1: LaBr3 Time
     man->FillNtupleDColumn(0, 1, fTimeLaBr3 / ns);
+    // LaBr3 broadened Edep
+    man->FillNtupleDColumn(0, 2, edepBroadLaBr3 / MeV);
+    man->FillNtupleDColumn(0, 3, fWeight);
     man->AddNtupleRow(0);
     // Column 2: CeBr3 Edep
     man->FillNtupleDColumn(1, 0, fEdepCeBr3 / MeV);
     // Column 3: CeBr3 Time
     man->FillNtupleDColumn(1, 1, fTimeCeBr3 / ns);
+    // CeBr3 broadened Edep
+    man->FillNtupleDColumn(1, 2, edepBroadCeBr3 / MeV);
+    man->FillNtupleDColumn(1, 3, fWeight);
     man->AddNtupleRow(1);
+
+    ColumnarWriter *columnar = fRunAction->GetColumnarWriter();
+    if (columnar) {
+      G4int eventID = event->GetEventID();
+      columnar->AddRow(eventID, fRunAction->GetLaBr3Code(), fEdepLaBr3 / MeV,
+                       edepBroadLaBr3 / MeV, fTimeLaBr3 / ns, fWeight);
+      columnar->AddRow(eventID, fRunAction->GetCeBr3Code(), fEdepCeBr3 / MeV,
+                       edepBroadCeBr3 / MeV, fTimeCeBr3 / ns, fWeight);
+    }
   }
 }
@@ -7,7 +7,9 @@
 #include "G4SystemOfUnits.hh"
 #include "G4UserEventAction.hh"
 #include "Randomize.hh"
+#include "construction.hh"
 #include "run.hh"
+#include "scintillator.hh"
 
 class EventAction : public G4UserEventAction {
 public:
@@ -19,10 +21,24 @@ public:
 
   void AddEdepLaBr3(G4double edep, G4double time);
   void AddEdepCeBr3(G4double edep, G4double time);
+  // change of a track weight over a step, see fWeight
+  void ScaleWeight(G4double ratio) { fWeight *= ratio; }
+  // LaBr3 and CeBr3 response calibration, see ScintillatorResponse
+  void RecordResponse(const G4Step *step) {
+    fLaBr3Recorder.Record(step);
+    fCeBr3Recorder.Record(step);
+  }
 
 private:
+  RunAction *fRunAction;
   G4double fEdepLaBr3, fEdepCeBr3;
   G4double fTimeLaBr3, fTimeCeBr3;
+  // weight of the history, the product of the weight changes of all its
+  // tracks. A secondary starts with the weight of its parent at that
+  // point, so only its own changes count. 1 without biasing
+  G4double fWeight;
+  ResponseRecorder fLaBr3Recorder;
+  ResponseRecorder fCeBr3Recorder;
 };
 
 #endif
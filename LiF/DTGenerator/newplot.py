@@ -1,4 +1,7 @@
 
+import glob
+import json
+import sys
 import uproot
 import matplotlib.pyplot as plt
 import numpy as np
@@ -167,24 +170,60 @@ def plot_coincidence_hist(data1, data2, times1, times2, title, xlabel, ylabel):
     else:
         print(f"No coincident events found for {title}")
 
+# Load detector data written with /output/columnar true (output0_t*.npy).
+# The columns are memory-mapped, so nothing is decompressed; the rows of
+# the detector are copied out of them.
+def load_columnar_data(base_pattern, detector_name):
+    energies, broadened, times = [], [], []
+    for meta_path in sorted(glob.glob(base_pattern + ".meta.json")):
+        base = meta_path[:-len(".meta.json")]
+        with open(meta_path) as meta_file:
+            code = json.load(meta_file)["fDetector"].index(detector_name)
+        mask = np.load(base + ".fDetector.npy", mmap_mode="r") == code
+        energies.append(np.load(base + ".fEDep.npy", mmap_mode="r")[mask])
+        broadened.append(np.load(base + ".fEDepBroad.npy", mmap_mode="r")[mask])
+        times.append(np.load(base + ".fTime.npy", mmap_mode="r")[mask])
+    return {
+        "energy": np.concatenate(energies),
+        "energy_broad": np.concatenate(broadened),
+        "time": np.concatenate(times)
+    }
+
 # Load detector data function
-def load_detector_data(file_path, detector_name):
+def load_detector_data(file_path, columnar_pattern, detector_name):
+    if glob.glob(columnar_pattern + ".meta.json"):
+        return load_columnar_data(columnar_pattern, detector_name)
     root_file = uproot.open(file_path)
-    return {
-        "energy": root_file[detector_name]["fEDep"].array(library="np"),
-        "time": root_file[detector_name]["fTime"].array(library="np")
+    tree = root_file[detector_name]
+    data = {
+        "energy": tree["fEDep"].array(library="np"),
+        "time": tree["fTime"].array(library="np")
     }
+    # Energy broadened by the digitizer during the run (/digitizer/...)
+    if "fEDepBroad" in tree.keys():
+        data["energy_broad"] = tree["fEDepBroad"].array(library="np")
+    return data
+
+def broadened_energy(data, resolution_function):
+    if "energy_broad" in data:
+        return data["energy_broad"]
+    return apply_energy_broadening(data["energy"], resolution_function)
+
+# python newplot.py [ROOT file] [columnar base], the columnar files of the
+# base (output<run>[_t<thread>] written in build/) are used when present
+root_path = sys.argv[1] if len(sys.argv) > 1 else "antitest.root"
+columnar_pattern = sys.argv[2] if len(sys.argv) > 2 else "build/output0*"
 
 # Load data for both detectors
 print("Loading data...")
-labr3_data = load_detector_data("antitest.root", "LaBr3")
-cebr3_data = load_detector_data("antitest.root", "CeBr3")
+labr3_data = load_detector_data(root_path, columnar_pattern, "LaBr3")
+cebr3_data = load_detector_data(root_path, columnar_pattern, "CeBr3")
 print(f"Loaded {len(labr3_data['energy'])} LaBr3 events and {len(cebr3_data['energy'])} CeBr3 events")
 
 # Apply energy broadening
 print("Applying energy broadening...")
-broadened_edep_labr3 = apply_energy_broadening(labr3_data["energy"], labr3_resolution)
-broadened_edep_cebr3 = apply_energy_broadening(cebr3_data["energy"], labr3_resolution)
+broadened_edep_labr3 = broadened_energy(labr3_data, labr3_resolution)
+broadened_edep_cebr3 = broadened_energy(cebr3_data, labr3_resolution)
 
 # Plot original LaBr3 spectrum with broadening
 print("Plotting original LaBr3 spectrum...")
@@ -1,29 +1,107 @@
 #include "run.hh"
 
-RunAction::RunAction() {
+#include "G4RunManager.hh"
+#include "construction.hh"
+
+#include <cmath>
+
+RunAction::RunAction()
+    : fWriteColumnar(false), fRowGroupSize(65536), fBiasFactor(1.) {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
 
   man->CreateNtuple("LaBr3", "LaBr3");
   man->CreateNtupleDColumn("fEDep");
   man->CreateNtupleDColumn("fTime");
+  man->CreateNtupleDColumn("fEDepBroad");
+  man->CreateNtupleDColumn("fWeight");
   man->FinishNtuple(0);
 
   man->CreateNtuple("CeBr3", "CeBr3");
   man->CreateNtupleDColumn("fEDep");
   man->CreateNtupleDColumn("fTime");
+  man->CreateNtupleDColumn("fEDepBroad");
+  man->CreateNtupleDColumn("fWeight");
   man->FinishNtuple(1);
+
+  // wall time of the run, filled by the master, for the figure of merit
+  man->CreateH1("RunTime", "Run time (s)", 1, 0., 1.);
+
+  fLaBr3Code = fColumnar.AddDetector("LaBr3");
+  fCeBr3Code = fColumnar.AddDetector("CeBr3");
+
+  // LaBr3 resolution previously applied in newplot.py (sigma/E there, so
+  // scaled to FWHM/E), also used for the CeBr3
+  const G4double fwhm = 2. * std::sqrt(2. * std::log(2.));
+  fDigitizer.SetSqrt("LaBr3", fwhm * 0.00671, fwhm * 0.00895,
+                     fwhm * 0.00000213);
+  fDigitizer.SetSqrt("CeBr3", fwhm * 0.00671, fwhm * 0.00895,
+                     fwhm * 0.00000213);
+
+  fMessenger = new G4GenericMessenger(this, "/output/", "Output control");
+  fMessenger
+      ->DeclareProperty("columnar", fWriteColumnar,
+                        "Also write the ntuples as NumPy columns")
+      .SetDefaultValue("true");
+  fMessenger
+      ->DeclareProperty("rowGroupSize", fRowGroupSize,
+                        "Rows buffered per thread before each flush")
+      .SetParameterName("rows", false)
+      .SetRange("rows>0");
+
+  fBiasMessenger =
+      new G4GenericMessenger(this, "/bias/capture/", "LiF capture biasing");
+  fBiasMessenger
+      ->DeclareProperty("factor", fBiasFactor,
+                        "Scale of the neutron capture and inelastic cross "
+                        "sections in the LiF, 1 for analog transport")
+      .SetParameterName("factor", false)
+      .SetRange("factor>0");
+}
+RunAction::~RunAction() {
+  delete fMessenger;
+  delete fBiasMessenger;
 }
-RunAction::~RunAction() {}
 void RunAction::BeginOfRunAction(const G4Run *run) {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
   G4int runNumber = run->GetRunID();
   std::stringstream strRunID;
   strRunID << runNumber;
   man->OpenFile("output" + strRunID.str() + ".root");
+
+  CaptureBiasing::SetFactor(fBiasFactor);
+  if (IsMaster()) {
+    const DetectorConstruction *detectorConstruction =
+        static_cast<const DetectorConstruction *>(
+            G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+    detectorConstruction->GetLaBr3Response()->Configure();
+    detectorConstruction->GetCeBr3Response()->Configure();
+    fTimer.Start();
+  }
+
+  // in MT mode the master never fills, so only the workers get columnar files
+  G4bool fills = !(IsMaster() && G4Threading::IsMultithreadedApplication());
+  if (fWriteColumnar && fills) {
+    std::stringstream baseName;
+    baseName << "output" << runNumber;
+    if (G4Threading::IsWorkerThread())
+      baseName << "_t" << G4Threading::G4GetThreadId();
+    fColumnar.SetRowGroupSize(fRowGroupSize);
+    fColumnar.Open(baseName.str());
+  }
 }
 void RunAction::EndOfRunAction(const G4Run *) {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
 
+  if (IsMaster()) {
+    const DetectorConstruction *detectorConstruction =
+        static_cast<const DetectorConstruction *>(
+            G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+    detectorConstruction->GetLaBr3Response()->Finish();
+    detectorConstruction->GetCeBr3Response()->Finish();
+    fTimer.Stop();
+    man->FillH1(0, 0.5, fTimer.GetRealElapsed());
+  }
   man->Write();
   man->CloseFile("output.root");
+  fColumnar.Close();
 }
@@ -2,8 +2,14 @@
 #define RUN_HH
 
 #include "G4AnalysisManager.hh"
+#include "G4GenericMessenger.hh"
 #include "G4Run.hh"
+#include "G4Threading.hh"
+#include "G4Timer.hh"
 #include "G4UserRunAction.hh"
+#include "bias.hh"
+#include "columnar.hh"
+#include "digitizer.hh"
 
 class RunAction : public G4UserRunAction {
 public:
@@ -12,6 +18,24 @@ public:
 
   virtual void BeginOfRunAction(const G4Run *);
   virtual void EndOfRunAction(const G4Run *);
+
+  ColumnarWriter *GetColumnarWriter() {
+    return fColumnar.IsOpen() ? &fColumnar : nullptr;
+  }
+  G4int GetLaBr3Code() const { return fLaBr3Code; }
+  G4int GetCeBr3Code() const { return fCeBr3Code; }
+  const Digitizer *GetDigitizer() const { return &fDigitizer; }
+
+private:
+  G4GenericMessenger *fMessenger;
+  G4bool fWriteColumnar;
+  G4int fRowGroupSize;
+  ColumnarWriter fColumnar;
+  G4int fLaBr3Code, fCeBr3Code;
+  Digitizer fDigitizer;
+  G4GenericMessenger *fBiasMessenger;
+  G4double fBiasFactor;
+  G4Timer fTimer;
 };
 
 #endif
@@ -2,8 +2,10 @@
 #include "construction.hh"
 
 // include physics files
+#include "G4FastSimulationPhysics.hh"
+#include "G4GenericBiasingPhysics.hh"
 #include "QGSP_BIC_HP.hh"
-#include "physics.hh"
+#include "physicslist.hh"
 // include actions
 #include "action.hh"
 
@@ -17,13 +19,26 @@
 
 int main(int argc, char **argv) {
 
+  // -p <physics> picks the physics list, see physicslist.hh
+  G4String physicsConfig = TakePhysicsOption(argc, argv);
+
 #ifdef G4MULTITHREADED
   G4MTRunManager *runManager = new G4MTRunManager();
 #else
   G4RunManager *runManager = new G4RunManager();
 #endif
   runManager->SetUserInitialization(new DetectorConstruction());
-  runManager->SetUserInitialization(new PhysicsList());
+  PhysicsList *physicsList = new PhysicsList(physicsConfig, "neutron");
+  // lets CaptureBiasing change the neutron cross sections in the LiF
+  G4GenericBiasingPhysics *biasingPhysics = new G4GenericBiasingPhysics();
+  biasingPhysics->Bias("neutron");
+  physicsList->RegisterPhysics(biasingPhysics);
+  // lets the LaBr3 and CeBr3 response models take over gammas
+  G4FastSimulationPhysics *fastSimulationPhysics =
+      new G4FastSimulationPhysics();
+  fastSimulationPhysics->ActivateFastSimulation("gamma");
+  physicsList->RegisterPhysics(fastSimulationPhysics);
+  runManager->SetUserInitialization(physicsList);
   runManager->SetUserInitialization(new ActionInitialization());
 
   G4UIExecutive *ui = 0;
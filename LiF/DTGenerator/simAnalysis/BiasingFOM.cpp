@@ -0,0 +1,91 @@
+#include "Coincidence.cpp"
+
+#include <TH1D.h>
+#include <cmath>
+#include <cstdio>
+
+// Figure of merit FOM = 1 / (R^2 T) of the LaBr3/CeBr3 coincidence counts
+// in an energy window, for an analog run and a /bias/capture/factor run
+// with the same source and number of events. R is the relative error of the
+// weighted counts and T the run time the master stored in RunTime, so the
+// gain is the speed-up at equal precision. Both files come from
+// combineoutputs.py.
+//
+//   root -l -b -q 'BiasingFOM.cpp+("../analog.root", "../biased.root")'
+struct WindowCounts {
+  double counts;
+  double error;
+  double seconds;
+};
+
+double RunSeconds(const char *fileName) {
+  TFile *file = TFile::Open(fileName);
+  TH1D *runTime = nullptr;
+  if (file && !file->IsZombie())
+    file->GetObject("RunTime", runTime);
+  double seconds = runTime ? runTime->GetBinContent(1) : 0.;
+  if (seconds <= 0.)
+    std::cerr << "No RunTime in " << fileName << "!" << std::endl;
+  delete file;
+  return seconds;
+}
+
+std::vector<WindowCounts> CountWindow(const char *fileName,
+                                      const CoincidenceConfig &config,
+                                      double emin, double emax) {
+  std::vector<WindowCounts> counts;
+  CoincidenceResult result = BuildCoincidences(fileName, config);
+  double seconds = RunSeconds(fileName);
+  for (TH1D *hist : result.coincidence) {
+    int low = hist->FindFixBin(emin);
+    int high = hist->FindFixBin(emax);
+    double error = 0.;
+    double sum = hist->IntegralAndError(low, high, error);
+    counts.push_back({sum, error, seconds});
+    delete hist;
+  }
+  for (TH1D *hist : result.antiCoincidence)
+    delete hist;
+  for (THnSparseD *matrix : result.matrices)
+    delete matrix;
+  return counts;
+}
+
+double FigureOfMerit(const WindowCounts &counts) {
+  if (counts.counts <= 0. || counts.seconds <= 0.)
+    return 0.;
+  double relative = counts.error / counts.counts;
+  return 1. / (relative * relative * counts.seconds);
+}
+
+void BiasingFOM(const char *analogFile = "../analog.root",
+                const char *biasedFile = "../biased.root", double emin = 0.05,
+                double emax = 2.5, double window = 0.1) {
+  CoincidenceConfig config = DetectorConfig();
+  config.window = window;
+  std::vector<WindowCounts> analog = CountWindow(analogFile, config, emin,
+                                                 emax);
+  std::vector<WindowCounts> biased = CountWindow(biasedFile, config, emin,
+                                                 emax);
+  if (analog.size() != config.detectors.size() ||
+      biased.size() != config.detectors.size())
+    return;
+
+  printf("Coincidences in %.3f-%.3f MeV\n", emin, emax);
+  printf("%-8s %22s %22s %12s %12s %8s\n", "", "analog", "biased",
+         "FOM analog", "FOM biased", "gain");
+  for (size_t d = 0; d < config.detectors.size(); ++d) {
+    double fomAnalog = FigureOfMerit(analog[d]);
+    double fomBiased = FigureOfMerit(biased[d]);
+    printf("%-8s %10.4g +- %8.3g %10.4g +- %8.3g %12.4g %12.4g %8.2f\n",
+           config.detectors[d].c_str(), analog[d].counts, analog[d].error,
+           biased[d].counts, biased[d].error, fomAnalog, fomBiased,
+           fomAnalog > 0. ? fomBiased / fomAnalog : 0.);
+    // the weighted counts estimate the same quantity as the analog ones
+    double difference = biased[d].counts - analog[d].counts;
+    double sigma = std::hypot(analog[d].error, biased[d].error);
+    if (sigma > 0. && std::abs(difference) > 3. * sigma)
+      std::cerr << config.detectors[d] << ": biased and analog counts differ "
+                << "by " << difference / sigma << " sigma" << std::endl;
+  }
+}
@@ -0,0 +1,21 @@
+#include "../../../Common/simAnalysis/CoincidenceBuilder.cpp"
+
+// LaBr3 and CeBr3 of the DT generator setup, see CoincidenceBuilder.cpp
+CoincidenceConfig DetectorConfig() {
+  CoincidenceConfig config;
+  config.detectors = {"LaBr3", "CeBr3"};
+  config.nbins = 100;
+  config.energyMin = 5e-2; // MeV
+  config.energyMax = 2.5;
+  return config;
+}
+
+//   root -l -b -q 'Coincidence.cpp+("../antitest.root")'
+void Coincidence(const char *fileName = "../antitest.root",
+                 double window = 0.1, int minMultiplicity = 2,
+                 const char *outputName = "coincidence.root") {
+  CoincidenceConfig config = DetectorConfig();
+  config.window = window;
+  config.minMultiplicity = minMultiplicity;
+  RunCoincidence(fileName, config, outputName);
+}
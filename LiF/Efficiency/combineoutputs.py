@@ -31,8 +31,12 @@ def combine_root_files(output_file, input_files):
     output.Close()
     print(f"Combined {len(input_files)} ROOT files into {output_file}")
 
+# python combineoutputs.py [output] [run], the run being the output file
+# of the simulation without .root, build/output0 by default
+prefix = sys.argv[2] if len(sys.argv) > 2 else 'build/output0'
+
 # List of input ROOT files (one for each thread)
-input_files = [f'build/output0_t{i}.root' for i in range(32)]
+input_files = [f'{prefix}_t{i}.root' for i in range(32)]
 
 # Output ROOT file
 if (len(sys.argv) != 1):
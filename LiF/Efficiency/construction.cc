@@ -20,6 +20,7 @@ G4VPhysicalVolume *DetectorConstruction::Construct() {
 
   G4Box *solidLiF = new G4Box("LiF", 0.5 * cm, 0.5 * cm, 0.5 * cm);
   G4LogicalVolume *logicLiF = new G4LogicalVolume(solidLiF, LiF, "LiF");
+  fLiFVolume = logicLiF;
 
   G4Box *solidShell = new G4Box("AirShell",
                                 0.5 * cm + 1 * mm,  // X half-length
@@ -75,4 +76,8 @@ void DetectorConstruction::ConstructSDandField() {
   // NaI sensitive detector
   SensitiveDetector *naiSD = new SensitiveDetector("NaI");
   fScoringVolumeNaI->SetSensitiveDetector(naiSD);
+
+  // one operator per thread, scaled with /bias/capture/factor
+  CaptureBiasing *captureBiasing = new CaptureBiasing();
+  captureBiasing->AttachTo(fLiFVolume);
 }
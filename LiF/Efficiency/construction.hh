@@ -12,6 +12,7 @@
 #include "G4VPhysicalVolume.hh"
 #include "G4VUserDetectorConstruction.hh"
 #include "G4VisAttributes.hh"
+#include "bias.hh"
 #include "cmath"
 #include "detector.hh"
 
@@ -23,6 +24,7 @@ public:
   virtual G4VPhysicalVolume *Construct();
 
 private:
+  G4LogicalVolume *fLiFVolume;
   G4LogicalVolume *fScoringVolumeShell;
   G4LogicalVolume *fScoringVolumeNaI;
   virtual void ConstructSDandField();
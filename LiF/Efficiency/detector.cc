@@ -22,6 +22,7 @@ G4bool SensitiveDetector::ProcessHits(G4Step *aStep,
       } else {
         man->FillNtupleDColumn(0, 1, kineticEnergy);
       }
+      man->FillNtupleDColumn(0, 2, track->GetWeight());
       man->AddNtupleRow(0);
     }
   }
@@ -32,6 +33,7 @@ G4bool SensitiveDetector::ProcessHits(G4Step *aStep,
     } else {
       man->FillNtupleDColumn(2, 1, kineticEnergy);
     }
+    man->FillNtupleDColumn(2, 2, track->GetWeight());
     man->AddNtupleRow(2);
   }
   return true;
@@ -1,14 +1,24 @@
 #include "event.hh"
 
-EventAction::EventAction(RunAction *) { fEdep = 0.; }
+#include "bias.hh"
+
+EventAction::EventAction(RunAction *) {
+  fEdep = 0.;
+  fWeight = 1.;
+}
 EventAction::~EventAction() {}
 
-void EventAction::BeginOfEventAction(const G4Event *) { fEdep = 0.; }
+void EventAction::BeginOfEventAction(const G4Event *) {
+  fEdep = 0.;
+  fWeight = 1.;
+}
 
 void EventAction::EndOfEventAction(const G4Event *event) {
+  CaptureBiasing::CheckEventWeight(fWeight);
 
   G4AnalysisManager *man = G4AnalysisManager::Instance();
 
   man->FillNtupleDColumn(1, 0, fEdep / MeV);
+  man->FillNtupleDColumn(1, 1, fWeight);
   man->AddNtupleRow(1);
 }
@@ -18,9 +18,14 @@ public:
   virtual void EndOfEventAction(const G4Event *);
 
   void AddEdep(G4double edep) { fEdep += edep; }
+  // change of a track weight over a step, see fWeight
+  void ScaleWeight(G4double ratio) { fWeight *= ratio; }
 
 private:
   G4double fEdep;
+  // weight of the history, the product of the weight changes of all its
+  // tracks; 1 without biasing
+  G4double fWeight;
 };
 
 #endif
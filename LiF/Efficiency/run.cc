@@ -1,29 +1,43 @@
 #include "run.hh"
 
-RunAction::RunAction() {
+RunAction::RunAction() : fBiasFactor(1.) {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
 
   man->CreateNtuple("PreEnergy", "PreEnergy");
   man->CreateNtupleDColumn("GammaEnergies");
   man->CreateNtupleDColumn("OtherEnergies");
+  man->CreateNtupleDColumn("Weight");
   man->FinishNtuple(0);
 
   man->CreateNtuple("NaI", "NaI");
   man->CreateNtupleDColumn("TotalEdep");
+  man->CreateNtupleDColumn("Weight");
   man->FinishNtuple(1);
 
   man->CreateNtuple("NaIEntries", "NaIEntries");
   man->CreateNtupleDColumn("GammaEnergies");
   man->CreateNtupleDColumn("OtherEnergies");
+  man->CreateNtupleDColumn("Weight");
   man->FinishNtuple(2);
+
+  fBiasMessenger =
+      new G4GenericMessenger(this, "/bias/capture/", "LiF capture biasing");
+  fBiasMessenger
+      ->DeclareProperty("factor", fBiasFactor,
+                        "Scale of the neutron capture and inelastic cross "
+                        "sections in the LiF, 1 for analog transport")
+      .SetParameterName("factor", false)
+      .SetRange("factor>0");
 }
-RunAction::~RunAction() {}
+RunAction::~RunAction() { delete fBiasMessenger; }
 void RunAction::BeginOfRunAction(const G4Run *run) {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
   G4int runNumber = run->GetRunID();
   std::stringstream strRunID;
   strRunID << runNumber;
   man->OpenFile("output" + strRunID.str() + ".root");
+
+  CaptureBiasing::SetFactor(fBiasFactor);
 }
 void RunAction::EndOfRunAction(const G4Run *) {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
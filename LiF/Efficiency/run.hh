@@ -2,8 +2,10 @@
 #define RUN_HH
 
 #include "G4AnalysisManager.hh"
+#include "G4GenericMessenger.hh"
 #include "G4Run.hh"
 #include "G4UserRunAction.hh"
+#include "bias.hh"
 
 class RunAction : public G4UserRunAction {
 public:
@@ -12,6 +14,10 @@ public:
 
   virtual void BeginOfRunAction(const G4Run *);
   virtual void EndOfRunAction(const G4Run *);
+
+private:
+  G4GenericMessenger *fBiasMessenger;
+  G4double fBiasFactor;
 };
 
 #endif
@@ -7,6 +7,12 @@ SteppingAction::SteppingAction(EventAction *eventAction) {
 SteppingAction::~SteppingAction() {}
 
 void SteppingAction::UserSteppingAction(const G4Step *step) {
+  // every weight change is a factor of the history weight
+  G4double preWeight = step->GetPreStepPoint()->GetWeight();
+  G4double postWeight = step->GetPostStepPoint()->GetWeight();
+  if (postWeight != preWeight && preWeight > 0.)
+    fEventAction->ScaleWeight(postWeight / preWeight);
+
   G4LogicalVolume *volume = step->GetPreStepPoint()
                                 ->GetTouchableHandle()
                                 ->GetVolume()
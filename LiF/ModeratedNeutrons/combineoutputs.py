@@ -2,7 +2,7 @@ import ROOT
 import os
 import sys
 
-def combine_root_files(output_file, input_files):
+def combine_root_files(output_file, input_files, master_file):
     # Create a TChain for each tree type
     LaBr3_chain = ROOT.TChain("LaBr3")
     CeBr3_chain = ROOT.TChain("CeBr3")
@@ -21,12 +21,26 @@ def combine_root_files(output_file, input_files):
     # Write the trees to the output file
     LaBr3_tree.Write()
     CeBr3_tree.Write()
+
+    # Run time is filled by the master, for simAnalysis/BiasingFOM.cpp
+    master = ROOT.TFile.Open(master_file)
+    if master and not master.IsZombie():
+        run_time = master.Get('RunTime')
+        if run_time:
+            output.cd()
+            run_time.Write('RunTime')
+        master.Close()
+
     # Close the output file
     output.Close()
     print(f"Combined {len(input_files)} ROOT files into {output_file}")
 
+# python combineoutputs.py [output] [run], the run being the output file
+# of the simulation without .root, build/output0 by default
+prefix = sys.argv[2] if len(sys.argv) > 2 else 'build/output0'
+
 # List of input ROOT files (one for each thread)
-input_files = [f'build/output0_t{i}.root' for i in range(32)]
+input_files = [f'{prefix}_t{i}.root' for i in range(32)]
 
 # Output ROOT file
 if (len(sys.argv) != 1):
@@ -34,4 +48,4 @@ if (len(sys.argv) != 1):
 else: output_file = 'combined_output.root'
 
 # Combine the files
-combine_root_files(output_file, input_files)
+combine_root_files(output_file, input_files, prefix + '.root')
@@ -1,9 +1,14 @@
 #include "construction.hh"
 #include "G4UnitsTable.hh"
 
-DetectorConstruction::DetectorConstruction() {}
+DetectorConstruction::DetectorConstruction()
+    : fLaBr3Response(new ScintillatorResponse("labr3")),
+      fCeBr3Response(new ScintillatorResponse("cebr3")) {}
 
-DetectorConstruction::~DetectorConstruction() {}
+DetectorConstruction::~DetectorConstruction() {
+  delete fLaBr3Response;
+  delete fCeBr3Response;
+}
 
 G4VPhysicalVolume *DetectorConstruction::Construct() {
   G4NistManager *nist = G4NistManager::Instance();
@@ -49,32 +54,16 @@ G4VPhysicalVolume *DetectorConstruction::Construct() {
   // Position of the lead wall - right after the moderator
   G4double leadWallPosZ = modBoxHalfZ * 2 + offset + leadWallHalfZ;
 
-  // Create the lead wall with a hole
-  // First create a solid lead wall
-  G4Box *solidLeadWall =
-      new G4Box("LeadWall", leadWallHalfX, leadWallHalfY, leadWallHalfZ);
-
-  // Create a cylinder for the hole
-  G4Tubs *solidHole =
-      new G4Tubs("Hole", 0, holeRadius, leadWallHalfZ + 1 * mm, 0, 360 * deg);
-
-  // Subtract the hole from the lead wall
-  G4SubtractionSolid *leadWallWithHole =
-      new G4SubtractionSolid("LeadWallWithHole", solidLeadWall, solidHole);
-
-  // Create logical volume for the lead wall with hole
-  G4LogicalVolume *logicLeadWall =
-      new G4LogicalVolume(leadWallWithHole, leadMaterial, "LeadWall");
-
   // Set visual attributes for the lead wall
   G4VisAttributes *leadVisAttr =
       new G4VisAttributes(G4Colour(0.5, 0.5, 0.5)); // Gray
-  logicLeadWall->SetVisAttributes(leadVisAttr);
 
-  // Place the lead wall in the world volume
-  G4VPhysicalVolume *physLeadWall =
-      new G4PVPlacement(0, G4ThreeVector(0., 0., leadWallPosZ), logicLeadWall,
-                        "LeadWall", logicWorld, false, 0, true);
+  // Create the lead wall with a hole and place it in the world volume, by
+  // default the hole is an air daughter of a plain lead box rather than a
+  // subtraction solid, see /geometry/builder/mode
+  fBuilder.DrilledBox("LeadWall", leadMaterial, worldMat, leadWallHalfX,
+                      leadWallHalfY, leadWallHalfZ, holeRadius, leadVisAttr,
+                      0, G4ThreeVector(0., 0., leadWallPosZ), logicWorld);
 
   // Calculate new position offset for detectors (after the lead wall)
   G4double newOffset = leadWallPosZ + leadWallHalfZ;
@@ -89,6 +78,7 @@ G4VPhysicalVolume *DetectorConstruction::Construct() {
 
   G4Box *solidLiF = new G4Box("LiF", 0.5 * cm, 0.5 * cm, 0.5 * cm);
   G4LogicalVolume *logicLiF = new G4LogicalVolume(solidLiF, LiF, "LiF");
+  fLiFVolume = logicLiF;
 
   G4Material *LaBr3 = new G4Material("LaBr3Ce", 5.08 * g / cm3, 3);
   LaBr3->AddElement(nist->FindOrBuildElement("Br"), 0.640569);
@@ -99,6 +89,10 @@ G4VPhysicalVolume *DetectorConstruction::Construct() {
       new G4Tubs("LaBr3", 0, 1.5 * inch / 2, 1.5 * inch / 2, 0, 360 * deg);
 
   fScoringVolumeLaBr3 = new G4LogicalVolume(solidLaBr3, LaBr3, "LaBr3");
+  // regions for the fast scintillator response models
+  fLaBr3Region = new G4Region("LaBr3");
+  fLaBr3Region->AddRootLogicalVolume(fScoringVolumeLaBr3);
+  fLaBr3Response->SetCrystal(fScoringVolumeLaBr3);
 
   G4Material *CeBr3 = new G4Material("CeBr3", 5.2 * g / cm3, 2);
   CeBr3->AddElement(nist->FindOrBuildElement("Ce"), 0.36893); // 36.893% cerium
@@ -107,6 +101,9 @@ G4VPhysicalVolume *DetectorConstruction::Construct() {
   G4Tubs *solidCeBr3 =
       new G4Tubs("CeBr3", 0, 1 * inch / 2, 1 * inch / 2, 0, 360 * deg);
   fScoringVolumeCeBr3 = new G4LogicalVolume(solidCeBr3, CeBr3, "CeBr3");
+  fCeBr3Region = new G4Region("CeBr3");
+  fCeBr3Region->AddRootLogicalVolume(fScoringVolumeCeBr3);
+  fCeBr3Response->SetCrystal(fScoringVolumeCeBr3);
 
   G4double halfcm = 0.5 * cm;
   // Place LiF after the lead wall
@@ -133,6 +130,8 @@ G4VPhysicalVolume *DetectorConstruction::Construct() {
       new G4VisAttributes(G4Colour(0.8, 0.8, 0.0)); // Yellow
   logicLiF->SetVisAttributes(liFVis);
 
+  fBuilder.ApplySmartless();
+
   return physWorld;
 }
 
@@ -143,4 +142,12 @@ void DetectorConstruction::ConstructSDandField() {
   // LaBr3 sensitive detector
   SensitiveDetector *CeBr3SD = new SensitiveDetector("CeBr3");
   fScoringVolumeCeBr3->SetSensitiveDetector(CeBr3SD);
+
+  // one operator per thread, scaled with /bias/capture/factor
+  CaptureBiasing *captureBiasing = new CaptureBiasing();
+  captureBiasing->AttachTo(fLiFVolume);
+
+  // idle unless /labr3/fastsim/mode or /cebr3/fastsim/mode fast
+  new ScintillatorFastSim("LaBr3Response", fLaBr3Region, fLaBr3Response);
+  new ScintillatorFastSim("CeBr3Response", fCeBr3Region, fCeBr3Response);
 }
@@ -1,14 +1,29 @@
 #include "event.hh"
 
-EventAction::EventAction(RunAction *) {
+#include "bias.hh"
+
+EventAction::EventAction(RunAction *runAction)
+    : fRunAction(runAction),
+      fLaBr3Recorder(static_cast<const DetectorConstruction *>(
+                         G4RunManager::GetRunManager()
+                             ->GetUserDetectorConstruction())
+                         ->GetLaBr3Response()),
+      fCeBr3Recorder(static_cast<const DetectorConstruction *>(
+                         G4RunManager::GetRunManager()
+                             ->GetUserDetectorConstruction())
+                         ->GetCeBr3Response()) {
   fEdepLaBr3 = fEdepCeBr3 = 0.;
   fTimeLaBr3 = fTimeCeBr3 = -1.;
+  fWeight = 1.;
+  fSteps = 0;
 }
 EventAction::~EventAction() {}
 
 void EventAction::BeginOfEventAction(const G4Event *) {
   fEdepLaBr3 = fEdepCeBr3 = 0.;
   fTimeLaBr3 = fTimeCeBr3 = -1.;
+  fWeight = 1.;
+  fSteps = 0;
 }
 
 void EventAction::AddEdepLaBr3(G4double edep, G4double time) {
@@ -24,17 +39,23 @@ void EventAction::AddEdepCeBr3(G4double edep, G4double time) {
 }
 
 void EventAction::EndOfEventAction(const G4Event *) {
+  fRunAction->AddSteps(fSteps);
+  CaptureBiasing::CheckEventWeight(fWeight);
+  fLaBr3Recorder.Flush();
+  fCeBr3Recorder.Flush();
   G4AnalysisManager *man = G4AnalysisManager::Instance();
   if (fEdepLaBr3 > 1e-7 || fEdepCeBr3 > 1e-7) {
     // Column 0: LaBr3 Edep
     man->FillNtupleDColumn(0, 0, fEdepLaBr3 / MeV);
     // Column 1: LaBr3 Time
     man->FillNtupleDColumn(0, 1, fTimeLaBr3 / ns);
+    man->FillNtupleDColumn(0, 2, fWeight);
     man->AddNtupleRow(0);
     // Column 2: CeBr3 Edep
     man->FillNtupleDColumn(1, 0, fEdepCeBr3 / MeV);
     // Column 3: CeBr3 Time
     man->FillNtupleDColumn(1, 1, fTimeCeBr3 / ns);
+    man->FillNtupleDColumn(1, 2, fWeight);
     man->AddNtupleRow(1);
   }
 }
@@ -1,29 +1,76 @@
 #include "run.hh"
 
-RunAction::RunAction() {
+#include "G4RunManager.hh"
+#include "construction.hh"
+
+RunAction::RunAction() : fBiasFactor(1.), fSteps("Steps", 0.) {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
 
   man->CreateNtuple("LaBr3", "LaBr3");
   man->CreateNtupleDColumn("fEDep");
   man->CreateNtupleDColumn("fTime");
+  man->CreateNtupleDColumn("fWeight");
   man->FinishNtuple(0);
 
   man->CreateNtuple("CeBr3", "CeBr3");
   man->CreateNtupleDColumn("fEDep");
   man->CreateNtupleDColumn("fTime");
+  man->CreateNtupleDColumn("fWeight");
   man->FinishNtuple(1);
+
+  // wall time of the run, filled by the master, for the figure of merit
+  man->CreateH1("RunTime", "Run time (s)", 1, 0., 1.);
+
+  fBiasMessenger =
+      new G4GenericMessenger(this, "/bias/capture/", "LiF capture biasing");
+  fBiasMessenger
+      ->DeclareProperty("factor", fBiasFactor,
+                        "Scale of the neutron capture and inelastic cross "
+                        "sections in the LiF, 1 for analog transport")
+      .SetParameterName("factor", false)
+      .SetRange("factor>0");
+
+  G4AccumulableManager::Instance()->RegisterAccumulable(fSteps);
 }
-RunAction::~RunAction() {}
+RunAction::~RunAction() { delete fBiasMessenger; }
 void RunAction::BeginOfRunAction(const G4Run *run) {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
   G4int runNumber = run->GetRunID();
   std::stringstream strRunID;
   strRunID << runNumber;
   man->OpenFile("output" + strRunID.str() + ".root");
+
+  CaptureBiasing::SetFactor(fBiasFactor);
+  G4AccumulableManager::Instance()->Reset();
+  if (IsMaster()) {
+    const DetectorConstruction *detectorConstruction =
+        static_cast<const DetectorConstruction *>(
+            G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+    detectorConstruction->GetLaBr3Response()->Configure();
+    detectorConstruction->GetCeBr3Response()->Configure();
+    fTimer.Start();
+  }
 }
-void RunAction::EndOfRunAction(const G4Run *) {
+void RunAction::EndOfRunAction(const G4Run *run) {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
 
+  if (IsMaster()) {
+    const DetectorConstruction *detectorConstruction =
+        static_cast<const DetectorConstruction *>(
+            G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+    detectorConstruction->GetLaBr3Response()->Finish();
+    detectorConstruction->GetCeBr3Response()->Finish();
+    fTimer.Stop();
+    man->FillH1(0, 0.5, fTimer.GetRealElapsed());
+  }
   man->Write();
   man->CloseFile("output.root");
+
+  G4AccumulableManager::Instance()->Merge();
+  G4int events = run->GetNumberOfEvent();
+  if (IsMaster() && events > 0)
+    G4cout << "Navigation: " << events << " events, "
+           << fSteps.GetValue() / events << " steps/event, "
+           << 1000. * fTimer.GetRealElapsed() / events << " ms/event"
+           << G4endl;
 }
@@ -1,9 +1,14 @@
 #ifndef RUN_HH
 #define RUN_HH
 
+#include "G4Accumulable.hh"
+#include "G4AccumulableManager.hh"
 #include "G4AnalysisManager.hh"
+#include "G4GenericMessenger.hh"
 #include "G4Run.hh"
+#include "G4Timer.hh"
 #include "G4UserRunAction.hh"
+#include "bias.hh"
 
 class RunAction : public G4UserRunAction {
 public:
@@ -12,6 +17,15 @@ public:
 
   virtual void BeginOfRunAction(const G4Run *);
   virtual void EndOfRunAction(const G4Run *);
+
+  void AddSteps(G4double steps) { fSteps += steps; }
+
+private:
+  G4GenericMessenger *fBiasMessenger;
+  G4double fBiasFactor;
+  G4Timer fTimer;
+  // steps per event, read by navigation_benchmark.py
+  G4Accumulable<G4double> fSteps;
 };
 
 #endif
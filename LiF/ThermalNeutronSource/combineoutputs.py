@@ -1,4 +1,5 @@
 import ROOT
+import glob
 import os
 import sys
 
@@ -27,6 +28,15 @@ def combine_root_files(output_file, input_files):
     output.Close()
     print(f"Combined {len(input_files)} ROOT files into {output_file}")
 
+# A /moderator/sweep leaves build/<point>.root and build/<point>_t<i>.root
+# for every point, e.g. Poly8cm; --sweep combines each into <point>.root
+if len(sys.argv) == 2 and sys.argv[1] == '--sweep':
+    for master_file in sorted(glob.glob('build/*cm.root')):
+        point = os.path.basename(master_file)[:-len('.root')]
+        input_files = [f'build/{point}_t{i}.root' for i in range(32)]
+        combine_root_files(point + '.root', input_files)
+    sys.exit()
+
 # List of input ROOT files (one for each thread)
 input_files = [f'build/output0_t{i}.root' for i in range(32)]
 
@@ -1,8 +1,13 @@
 #include "construction.hh"
 
-DetectorConstruction::DetectorConstruction() {}
+DetectorConstruction::DetectorConstruction()
+    : fModerator(new ModeratorSlab("G4_POLYETHYLENE", 8. * cm)) {
+  // importance cells of the moderator, built after the mass world
+  fImportanceWorld = new ImportanceWorld(fModerator);
+  RegisterParallelWorld(fImportanceWorld);
+}
 
-DetectorConstruction::~DetectorConstruction() {}
+DetectorConstruction::~DetectorConstruction() { delete fModerator; }
 
 G4VPhysicalVolume *DetectorConstruction::Construct() {
   G4NistManager *nist = G4NistManager::Instance();
@@ -15,11 +20,13 @@ G4VPhysicalVolume *DetectorConstruction::Construct() {
   G4VPhysicalVolume *physWorld = new G4PVPlacement(
       0, G4ThreeVector(0., 0., 0.), logicWorld, "physWorld", 0, false, 0, true);
 
-  // Define moderator material
-  G4Material *moderatorMaterial = nist->FindOrBuildMaterial("G4_POLYETHYLENE");
+  // Define moderator material, /moderator/material
+  G4Material *moderatorMaterial =
+      nist->FindOrBuildMaterial(fModerator->GetMaterial());
+  // Define dimensions of the moderator slab, /moderator/thickness
   G4double modBoxHalfX = 50 * cm;
   G4double modBoxHalfY = 50 * cm;
-  G4double modBoxHalfZ = (8.0 / 2) * cm;
+  G4double modBoxHalfZ = fModerator->GetThickness() / 2;
 
   G4double offset = 10 * cm;
 
@@ -31,6 +38,7 @@ G4VPhysicalVolume *DetectorConstruction::Construct() {
   G4VisAttributes *moderatorVisAttr =
       new G4VisAttributes(G4Colour(0.0, 1.0, 0.0)); // Green
   logicModBox->SetVisAttributes(moderatorVisAttr);
+  fModerator->SetBuilt(logicModBox, offset, modBoxHalfZ);
   // Place the moderator box in the world volume
   G4VPhysicalVolume *physModBox =
       new G4PVPlacement(0, G4ThreeVector(0., 0., modBoxHalfZ + offset),
@@ -64,8 +72,21 @@ G4VPhysicalVolume *DetectorConstruction::Construct() {
 }
 
 void DetectorConstruction::ConstructSDandField() {
-  SensitiveDetector *sensDetWrapPost = new SensitiveDetector("WrapPost");
+  // called again on every thread after a rebuild, the detectors of the
+  // thread are reused
+  G4SDManager *sdManager = G4SDManager::GetSDMpointer();
+  G4VSensitiveDetector *sensDetWrapPost =
+      sdManager->FindSensitiveDetector("WrapPost", false);
+  if (!sensDetWrapPost) {
+    sensDetWrapPost = new SensitiveDetector("WrapPost");
+    sdManager->AddNewDetector(sensDetWrapPost);
+  }
   fScoringVolumeWrapPost->SetSensitiveDetector(sensDetWrapPost);
-  SensitiveDetector *sensDetWrapPre = new SensitiveDetector("WrapPre");
+  G4VSensitiveDetector *sensDetWrapPre =
+      sdManager->FindSensitiveDetector("WrapPre", false);
+  if (!sensDetWrapPre) {
+    sensDetWrapPre = new SensitiveDetector("WrapPre");
+    sdManager->AddNewDetector(sensDetWrapPre);
+  }
   fScoringVolumeWrapPre->SetSensitiveDetector(sensDetWrapPre);
 }
@@ -6,6 +6,8 @@
 #include "G4NistManager.hh"
 #include "G4PVPlacement.hh"
 #include "G4RotationMatrix.hh"
+#include "G4RunManager.hh"
+#include "G4SDManager.hh"
 #include "G4SubtractionSolid.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4VPhysicalVolume.hh"
@@ -13,6 +15,8 @@
 #include "G4VisAttributes.hh"
 #include "cmath"
 #include "detector.hh"
+#include "importance.hh"
+#include "moderator.hh"
 
 class DetectorConstruction : public G4VUserDetectorConstruction {
 public:
@@ -21,7 +25,21 @@ public:
 
   virtual G4VPhysicalVolume *Construct();
 
+  G4LogicalVolume *GetModeratorVolume() const {
+    return fModerator->GetVolume();
+  }
+  G4double GetModeratorHalfZ() const { return fModerator->GetHalfZ(); }
+  G4double GetModeratorFrontZ() const { return fModerator->GetFrontZ(); }
+  ImportanceWorld *GetImportanceWorld() const { return fImportanceWorld; }
+  // run output name set by a sweep, empty for output<run>
+  const G4String &GetOutputName() const {
+    return fModerator->GetOutputName();
+  }
+
 private:
+  // /moderator/ material, thickness and sweeps
+  ModeratorSlab *fModerator;
+  ImportanceWorld *fImportanceWorld;
   G4LogicalVolume *fScoringVolumeWrapPre;
   G4LogicalVolume *fScoringVolumeWrapPost;
   virtual void ConstructSDandField();
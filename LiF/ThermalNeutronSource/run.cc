@@ -5,6 +5,7 @@ RunAction::RunAction() {
 
   man->CreateNtuple("PreEnergy", "PreEnergy");
   man->CreateNtupleDColumn("fPreEnergy");
+  man->CreateNtupleDColumn("fPreWeight");
   man->FinishNtuple(0);
 
   man->CreateNtuple("PostEnergy", "PostEnergy");
@@ -18,14 +19,25 @@ RunAction::RunAction() {
   man->CreateNtupleDColumn("fPostMomX");
   man->CreateNtupleDColumn("fPostMomY");
   man->CreateNtupleDColumn("fPostMomZ");
+  // track weight, not 1 with /moderator/importance
+  man->CreateNtupleDColumn("fPostWeight");
 }
 RunAction::~RunAction() {}
+
 void RunAction::BeginOfRunAction(const G4Run *run) {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
+  const DetectorConstruction *detectorConstruction =
+      static_cast<const DetectorConstruction *>(
+          G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  detectorConstruction->GetImportanceWorld()->FillStore();
   G4int runNumber = run->GetRunID();
   std::stringstream strRunID;
   strRunID << runNumber;
-  man->OpenFile("output" + strRunID.str() + ".root");
+  // a /moderator/sweep names the output after the point
+  G4String outputName = detectorConstruction->GetOutputName();
+  if (outputName.empty())
+    outputName = "output" + strRunID.str();
+  man->OpenFile(outputName + ".root");
 }
 void RunAction::EndOfRunAction(const G4Run *) {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
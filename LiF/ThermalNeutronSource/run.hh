@@ -3,7 +3,9 @@
 
 #include "G4AnalysisManager.hh"
 #include "G4Run.hh"
+#include "G4RunManager.hh"
 #include "G4UserRunAction.hh"
+#include "construction.hh"
 
 class RunAction : public G4UserRunAction {
 public:
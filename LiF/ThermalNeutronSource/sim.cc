@@ -2,8 +2,12 @@
 #include "construction.hh"
 
 // include physics files
+#include "G4GeometrySampler.hh"
+#include "G4ImportanceBiasing.hh"
+#include "G4ParallelWorldPhysics.hh"
 #include "QGSP_BIC_HP.hh"
-#include "physics.hh"
+#include "importance.hh"
+#include "physicslist.hh"
 // include actions
 #include "action.hh"
 
@@ -17,13 +21,25 @@
 
 int main(int argc, char **argv) {
 
+  // -p <physics> picks the physics list, see physicslist.hh
+  G4String physicsConfig = TakePhysicsOption(argc, argv);
+
 #ifdef G4MULTITHREADED
   G4MTRunManager *runManager = new G4MTRunManager();
 #else
   G4RunManager *runManager = new G4RunManager();
 #endif
   runManager->SetUserInitialization(new DetectorConstruction());
-  runManager->SetUserInitialization(new PhysicsList());
+  PhysicsList *physicsList = new PhysicsList(physicsConfig, "neutronhp");
+  // splitting and roulette at the moderator importance cells, the sampler
+  // finds the parallel world by name once it is built
+  G4GeometrySampler *sampler = new G4GeometrySampler(nullptr, "neutron");
+  sampler->SetParallel(true);
+  physicsList->RegisterPhysics(
+      new G4ImportanceBiasing(sampler, ImportanceWorld::kWorldName));
+  physicsList->RegisterPhysics(
+      new G4ParallelWorldPhysics(ImportanceWorld::kWorldName));
+  runManager->SetUserInitialization(physicsList);
   runManager->SetUserInitialization(new ActionInitialization());
 
   G4UIExecutive *ui = 0;
@@ -35,6 +35,12 @@ thermal_energy_upper = 0.030 * 1e-6  # 0.05 eV in MeV
 thicknesses = []
 poly_thermal_counts = []
 
+# Track weights, all 1 in outputs written before the weight column
+def post_weights(tree, post_energies):
+    if "fPostWeight" in tree.keys():
+        return tree["fPostWeight"].array(library="np")
+    return np.ones_like(post_energies)
+
 # Function to process ROOT files and extract thermal counts
 def process_files(material, thermal_counts):
     for thickness in range(5, 13):
@@ -54,8 +60,9 @@ def process_files(material, thermal_counts):
 
             # Extract branch values
             post_energies = tree["fPostEnergy"].array(library="np")
-            # Count thermal neutrons
-            thermal_count = np.sum((post_energies >= thermal_energy_lower) & (post_energies <= thermal_energy_upper))
+            weights = post_weights(tree, post_energies)
+            # Count thermal neutrons, weighted with /moderator/importance
+            thermal_count = np.sum(weights[(post_energies >= thermal_energy_lower) & (post_energies <= thermal_energy_upper)])
             # Normalize the count
             normalized_thermal_count = thermal_count / 1e6
 
@@ -90,13 +97,16 @@ if not os.path.exists(filename):
     print(f"Error: file {filename} does not exist!")
     
 selected_energies=[]
+selected_weights=[]
 with uproot.open(filename) as file:
     tree = file.get("PostEnergy")
     if tree is None:
         print(f"Error: PostEnergy tree not found in {filename}!")
     post_energies = tree["fPostEnergy"].array(library="np") * 1e6  # Convert to eV
-    selected_energies = post_energies[(post_energies >= 0.0001) & (post_energies <= 0.15)]
-energy_hist, bins = np.histogram(selected_energies, bins=250, range=(0, 0.15))
+    selected = (post_energies >= 0.0001) & (post_energies <= 0.15)
+    selected_energies = post_energies[selected]
+    selected_weights = post_weights(tree, post_energies)[selected]
+energy_hist, bins = np.histogram(selected_energies, bins=250, range=(0, 0.15), weights=selected_weights)
 energy_hist = energy_hist/energy_hist.sum()
 # Plot the energy histogram
 plt.figure()
@@ -2,7 +2,7 @@
 #include "construction.hh"
 
 // include physics files
-#include "physics.hh"
+#include "physicslist.hh"
 
 // include actions
 #include "action.hh"
@@ -16,13 +16,16 @@
 #include "G4VisManager.hh"
 
 int main(int argc, char **argv) {
+
+  // -p <physics> picks the physics list, see physicslist.hh
+  G4String physicsConfig = TakePhysicsOption(argc, argv);
 #ifdef G4MULTITHREADED
   G4MTRunManager *runManager = new G4MTRunManager();
 #else
   G4RunManager *runManager = new G4RunManager();
 #endif
   runManager->SetUserInitialization(new DetectorConstruction());
-  runManager->SetUserInitialization(new PhysicsList());
+  runManager->SetUserInitialization(new PhysicsList(physicsConfig, "alpha"));
   runManager->SetUserInitialization(new ActionInitialization());
 
   G4UIExecutive *ui = 0;
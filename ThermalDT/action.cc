@@ -9,6 +9,12 @@ void ActionInitialization::Build() const {
   SetUserAction(generator);
   RunAction *runAction = new RunAction();
   SetUserAction(runAction);
+
+  EventAction *eventAction = new EventAction();
+  SetUserAction(eventAction);
+
+  SteppingAction *steppingAction = new SteppingAction(eventAction);
+  SetUserAction(steppingAction);
 }
 
 void ActionInitialization::BuildForMaster() const {
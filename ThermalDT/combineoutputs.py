@@ -1,8 +1,9 @@
 import ROOT
+import glob
 import os
 import sys
 
-def combine_root_files(output_file, input_files):
+def combine_root_files(output_file, input_files, master_file):
     # Create a TChain for each tree type
     preenergy_chain = ROOT.TChain("PreEnergy")
     postenergy_chain = ROOT.TChain("PostEnergy")
@@ -23,12 +24,31 @@ def combine_root_files(output_file, input_files):
     # Write the trees to the output file
     preenergy_tree.Write()
     postenergy_tree.Write()
+
+    # Histograms are merged by Geant4 into the master file
+    master = ROOT.TFile.Open(master_file)
+    if master and not master.IsZombie():
+        tally = master.Get("PostEnergyThermal")
+        if tally:
+            output.cd()
+            tally.Write()
+        master.Close()
     # Close the output file
     output.Close()
     print(f"Combined {len(input_files)} ROOT files into {output_file}")
 
+# A /moderator/sweep leaves build/<point>.root and build/<point>_t<i>.root
+# for every point, e.g. Water10cm; --sweep combines each into <point>.root
+if len(sys.argv) == 2 and sys.argv[1] == '--sweep':
+    for master_file in sorted(glob.glob('build/*cm.root')):
+        point = os.path.basename(master_file)[:-len('.root')]
+        input_files = [f'build/{point}_t{i}.root' for i in range(16)]
+        combine_root_files(point + '.root', input_files, master_file)
+    sys.exit()
+
 # List of input ROOT files (one for each thread)
 input_files = [f'build/output0_t{i}.root' for i in range(16)]
+master_file = 'build/output0.root'
 
 # Output ROOT file
 if (len(sys.argv) != 1):
@@ -36,4 +56,4 @@ if (len(sys.argv) != 1):
 else: output_file = 'combined_output.root'
 
 # Combine the files
-combine_root_files(output_file, input_files)
+combine_root_files(output_file, input_files, master_file)
@@ -5,6 +5,9 @@
 #include "G4LogicalVolume.hh"
 #include "G4NistManager.hh"
 #include "G4PVPlacement.hh"
+#include "G4Region.hh"
+#include "G4RunManager.hh"
+#include "G4SDManager.hh"
 #include "G4RotationMatrix.hh"
 #include "G4SubtractionSolid.hh"
 #include "G4SystemOfUnits.hh"
@@ -12,7 +15,11 @@
 #include "G4VUserDetectorConstruction.hh"
 #include "G4VisAttributes.hh"
 #include "cmath"
+#include "cache.hh"
 #include "detector.hh"
+#include "fastsim.hh"
+#include "weightwindow.hh"
+#include "moderator.hh"
 
 class DetectorConstruction : public G4VUserDetectorConstruction {
 public:
@@ -21,7 +28,22 @@ public:
 
   virtual G4VPhysicalVolume *Construct();
 
+  G4LogicalVolume *GetModeratorVolume() const {
+    return fModerator->GetVolume();
+  }
+  G4double GetModeratorHalfZ() const { return fModerator->GetHalfZ(); }
+  G4double GetModeratorFrontZ() const { return fModerator->GetFrontZ(); }
+  ImportanceWorld *GetImportanceWorld() const { return fImportanceWorld; }
+  // run output name set by a sweep, empty for output<run>
+  const G4String &GetOutputName() const {
+    return fModerator->GetOutputName();
+  }
+
 private:
+  // /moderator/ material, thickness and sweeps
+  ModeratorSlab *fModerator;
+  G4Region *fModeratorRegion;
+  ImportanceWorld *fImportanceWorld;
   G4LogicalVolume *fScoringVolumeWrapPre;
   G4LogicalVolume *fScoringVolumeWrapPost;
   virtual void ConstructSDandField();
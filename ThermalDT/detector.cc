@@ -8,6 +8,7 @@ G4bool SensitiveDetector::ProcessHits(G4Step *aStep,
   G4Track *track = aStep->GetTrack();
   G4String particleName = track->GetParticleDefinition()->GetParticleName();
   G4double kineticEnergy = track->GetKineticEnergy();
+  G4double weight = track->GetWeight();
   G4AnalysisManager *man = G4AnalysisManager::Instance();
   // Storing neutron energies
   if (particleName == "neutron") {
@@ -25,11 +26,13 @@ G4bool SensitiveDetector::ProcessHits(G4Step *aStep,
       man->FillNtupleDColumn(1, 4, momentum.x());
       man->FillNtupleDColumn(1, 5, momentum.y());
       man->FillNtupleDColumn(1, 6, momentum.z());
+      man->FillNtupleDColumn(1, 7, weight);
       man->AddNtupleRow(1);
-      man->AddNtupleRow(1);
+      man->FillH1(0, kineticEnergy, weight);
 
     } else if (fDetectorName == "WrapPre") {
       man->FillNtupleDColumn(0, 0, kineticEnergy);
+      man->FillNtupleDColumn(0, 1, weight);
       man->AddNtupleRow(0); // Adding row for PreEnergy ntuple
     }
   }
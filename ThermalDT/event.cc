@@ -0,0 +1,95 @@
+#include "event.hh"
+
+EventAction::EventAction() : fTally(0.) {}
+EventAction::~EventAction() {}
+
+void EventAction::BeginOfEventAction(const G4Event *) {
+  fHistories.clear();
+  fEntries.clear();
+  fTrackHistory.clear();
+  fCellEntries.clear();
+  fTrackCells.clear();
+  fTally = 0.;
+}
+
+void EventAction::EndOfEventAction(const G4Event *) {
+  if (!fHistories.empty())
+    ModeratorKernel::Instance()->AddHistories(fHistories);
+
+  WeightWindow *windows = WeightWindow::Instance();
+  if (fCellEntries.empty() && fTally == 0.)
+    return;
+  std::vector<G4double> entered, score;
+  if (windows->IsGenerating()) {
+    entered.assign(windows->Bins(), 0.);
+    score.assign(windows->Bins(), 0.);
+    for (const CellEntry &entry : fCellEntries) {
+      entered[entry.bin] += entry.weight;
+      score[entry.bin] += entry.score;
+    }
+  }
+  windows->AddEvent(entered, score, fTally);
+}
+
+void EventAction::EnterModerator(G4int trackID, G4double energy,
+                                 const G4ThreeVector &position,
+                                 const G4ThreeVector &direction,
+                                 G4double time) {
+  KernelHistory history;
+  history.energy = energy;
+  history.cosTheta = direction.z();
+  fHistories.push_back(history);
+  fEntries.push_back(
+      {position, ModeratorKernel::EntryAzimuth(direction), time});
+  fTrackHistory[trackID] = fHistories.size() - 1;
+}
+
+void EventAction::InheritHistory(G4int trackID, G4int parentID) {
+  // neutrons produced inside the slab, e.g. by (n,2n), leave as part of
+  // the history their parent entered with
+  auto parent = fTrackHistory.find(parentID);
+  if (parent != fTrackHistory.end())
+    fTrackHistory[trackID] = parent->second;
+}
+
+void EventAction::LeaveModerator(G4int trackID, G4double energy,
+                                 const G4ThreeVector &position,
+                                 const G4ThreeVector &direction,
+                                 G4double time, G4double halfZ) {
+  auto track = fTrackHistory.find(trackID);
+  if (track == fTrackHistory.end())
+    return;
+  const Entry &entry = fEntries[track->second];
+  fHistories[track->second].exits.push_back(ModeratorKernel::MakeExit(
+      entry.position, entry.azimuth, position, direction, energy,
+      time - entry.time, halfZ));
+  // a reflected neutron coming back starts a new history
+  fTrackHistory.erase(track);
+}
+
+void EventAction::EnterCell(const G4Track *track, G4int bin,
+                            G4double weight) {
+  fCellEntries.push_back({bin, weight, 0.});
+  fTrackCells[track].push_back(fCellEntries.size() - 1);
+}
+
+void EventAction::InheritCells(const G4Track *parent,
+                               const G4Track *secondary) {
+  auto cells = fTrackCells.find(parent);
+  if (cells != fTrackCells.end())
+    fTrackCells[secondary] = cells->second;
+}
+
+void EventAction::ScoreTally(const G4Track *track, G4double weight) {
+  fTally += weight;
+  auto cells = fTrackCells.find(track);
+  if (cells == fTrackCells.end())
+    return;
+  for (std::size_t entry : cells->second)
+    fCellEntries[entry].score += weight;
+}
+
+void EventAction::ForgetTrack(const G4Track *track) {
+  // the track object may be reused for a later secondary
+  fTrackCells.erase(track);
+}
@@ -0,0 +1,61 @@
+#ifndef EVENT_HH
+#define EVENT_HH
+
+#include "G4Event.hh"
+#include "G4ThreeVector.hh"
+#include "G4Track.hh"
+#include "G4UserEventAction.hh"
+#include "kernel.hh"
+#include "weightwindow.hh"
+#include <map>
+#include <vector>
+
+// Collects the moderator histories of one event during a kernel
+// calibration run and hands them to the ModeratorKernel at its end. Also
+// keeps the weight window tally of the event and, while generating, the
+// cells every neutron entered on its way to it.
+class EventAction : public G4UserEventAction {
+public:
+  EventAction();
+  ~EventAction();
+
+  virtual void BeginOfEventAction(const G4Event *);
+  virtual void EndOfEventAction(const G4Event *);
+
+  void EnterModerator(G4int trackID, G4double energy,
+                      const G4ThreeVector &position,
+                      const G4ThreeVector &direction, G4double time);
+  void InheritHistory(G4int trackID, G4int parentID);
+  void LeaveModerator(G4int trackID, G4double energy,
+                      const G4ThreeVector &position,
+                      const G4ThreeVector &direction, G4double time,
+                      G4double halfZ);
+
+  // secondaries, including split neutrons, share the entries of their
+  // parent made so far
+  void EnterCell(const G4Track *track, G4int bin, G4double weight);
+  void InheritCells(const G4Track *parent, const G4Track *secondary);
+  void ScoreTally(const G4Track *track, G4double weight);
+  void ForgetTrack(const G4Track *track);
+
+private:
+  struct Entry {
+    G4ThreeVector position;
+    G4double azimuth;
+    G4double time;
+  };
+  std::vector<KernelHistory> fHistories;
+  std::vector<Entry> fEntries;
+  std::map<G4int, std::size_t> fTrackHistory;
+
+  struct CellEntry {
+    G4int bin;
+    G4double weight;
+    G4double score;
+  };
+  std::vector<CellEntry> fCellEntries;
+  std::map<const G4Track *, std::vector<std::size_t>> fTrackCells;
+  G4double fTally;
+};
+
+#endif
@@ -0,0 +1,70 @@
+#include "fastsim.hh"
+
+#include "G4SystemOfUnits.hh"
+
+ModeratorFastSim::ModeratorFastSim(G4String name, G4Region *region)
+    : G4VFastSimulationModel(name, region), fHistory(nullptr) {}
+
+ModeratorFastSim::~ModeratorFastSim() {}
+
+G4bool ModeratorFastSim::IsApplicable(const G4ParticleDefinition &particle) {
+  return &particle == G4Neutron::Definition();
+}
+
+G4bool ModeratorFastSim::ModelTrigger(const G4FastTrack &fastTrack) {
+  ModeratorKernel *kernel = ModeratorKernel::Instance();
+  if (kernel->GetMode() != ModeratorKernel::kFast)
+    return false;
+
+  const G4Box *slab = dynamic_cast<const G4Box *>(fastTrack.GetEnvelopeSolid());
+  if (!slab)
+    return false;
+  G4ThreeVector position = fastTrack.GetPrimaryTrackLocalPosition();
+  G4ThreeVector direction = fastTrack.GetPrimaryTrackLocalDirection();
+  if (std::abs(position.z() + slab->GetZHalfLength()) > 1. * um ||
+      direction.z() <= 0.)
+    return false;
+
+  // the history is picked here so a missing calibration falls back to the
+  // full transport
+  fHistory = kernel->Sample(fastTrack.GetPrimaryTrack()->GetKineticEnergy(),
+                            direction.z());
+  return fHistory != nullptr;
+}
+
+void ModeratorFastSim::DoIt(const G4FastTrack &fastTrack,
+                            G4FastStep &fastStep) {
+  const G4Box *slab = static_cast<const G4Box *>(fastTrack.GetEnvelopeSolid());
+  G4ThreeVector entryPosition = fastTrack.GetPrimaryTrackLocalPosition();
+  G4double entryAzimuth =
+      ModeratorKernel::EntryAzimuth(fastTrack.GetPrimaryTrackLocalDirection());
+  G4double entryTime = fastTrack.GetPrimaryTrack()->GetGlobalTime();
+
+  const std::vector<KernelExit> &exits = fHistory->exits;
+  if (exits.empty()) {
+    fastStep.KillPrimaryTrack();
+    return;
+  }
+
+  G4ThreeVector position, direction;
+  fastStep.SetNumberOfSecondaryTracks(exits.size() - 1);
+  for (std::size_t i = 0; i < exits.size(); i++) {
+    ModeratorKernel::PlaceExit(exits[i], entryPosition, entryAzimuth,
+                               slab->GetXHalfLength(), slab->GetYHalfLength(),
+                               slab->GetZHalfLength(), position, direction);
+    if (i == 0) {
+      // the primary continues as the first neutron of the history
+      fastStep.ProposePrimaryTrackFinalPosition(position);
+      fastStep.ProposePrimaryTrackFinalKineticEnergyAndDirection(
+          exits[i].energy, direction);
+      fastStep.ProposePrimaryTrackFinalTime(entryTime + exits[i].time);
+    } else {
+      G4DynamicParticle neutron(G4Neutron::Definition(), direction,
+                                exits[i].energy);
+      G4Track *secondary = fastStep.CreateSecondaryTrack(
+          neutron, position, entryTime + exits[i].time);
+      // split by the importance cells, keep the weight of the entry
+      secondary->SetWeight(fastTrack.GetPrimaryTrack()->GetWeight());
+    }
+  }
+}
@@ -0,0 +1,27 @@
+#ifndef FASTSIM_HH
+#define FASTSIM_HH
+
+#include "G4Box.hh"
+#include "G4FastStep.hh"
+#include "G4FastTrack.hh"
+#include "G4Neutron.hh"
+#include "G4VFastSimulationModel.hh"
+#include "kernel.hh"
+
+// Replaces the transport of neutrons entering the upstream face of the
+// moderator by a history sampled from the calibrated kernel. Neutrons with
+// no calibrated history for their energy and angle are transported in full.
+class ModeratorFastSim : public G4VFastSimulationModel {
+public:
+  ModeratorFastSim(G4String, G4Region *);
+  ~ModeratorFastSim();
+
+  virtual G4bool IsApplicable(const G4ParticleDefinition &);
+  virtual G4bool ModelTrigger(const G4FastTrack &);
+  virtual void DoIt(const G4FastTrack &, G4FastStep &);
+
+private:
+  const KernelHistory *fHistory;
+};
+
+#endif
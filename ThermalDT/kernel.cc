@@ -0,0 +1,236 @@
+#include "kernel.hh"
+
+#include "G4AutoLock.hh"
+#include "G4Exception.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+// entry binning used to pick a history: 10 bins per decade from 10 ueV to
+// 30 MeV, and 10 bins in the cosine against the slab normal
+static const G4double kLogEnergyMin = -5.;
+static const G4double kLogEnergyMax = 7.5;
+static const G4int kEnergyBins = 125;
+static const G4int kCosBins = 10;
+static const G4double kFaceTolerance = 1. * um;
+
+ModeratorKernel *ModeratorKernel::Instance() {
+  static ModeratorKernel instance;
+  return &instance;
+}
+
+ModeratorKernel::ModeratorKernel() : fMode(kOff), fThickness(0.) {}
+
+void ModeratorKernel::Configure(Mode mode, const G4String &fileName,
+                                const G4String &material,
+                                G4double thickness) {
+  G4AutoLock lock(&fMutex);
+  fFileName = fileName;
+  fMaterial = material;
+  fThickness = thickness;
+  fHistories.clear();
+  fBins.clear();
+  if (mode == kFast)
+    Load();
+  fMode = mode;
+}
+
+void ModeratorKernel::Finish() {
+  G4AutoLock lock(&fMutex);
+  if (fMode == kCalibrate)
+    Write();
+}
+
+void ModeratorKernel::AddHistories(
+    const std::vector<KernelHistory> &histories) {
+  G4AutoLock lock(&fMutex);
+  fHistories.insert(fHistories.end(), histories.begin(), histories.end());
+}
+
+G4int ModeratorKernel::Bin(G4double energy, G4double cosTheta) const {
+  if (energy <= 0.)
+    return -1;
+  G4double logEnergy = std::log10(energy / eV);
+  G4int energyBin = static_cast<G4int>((logEnergy - kLogEnergyMin) /
+                                       (kLogEnergyMax - kLogEnergyMin) *
+                                       kEnergyBins);
+  if (energyBin < 0 || energyBin >= kEnergyBins)
+    return -1;
+  G4int cosBin = std::min(static_cast<G4int>(cosTheta * kCosBins),
+                          kCosBins - 1);
+  if (cosBin < 0)
+    return -1;
+  return energyBin * kCosBins + cosBin;
+}
+
+const KernelHistory *ModeratorKernel::Sample(G4double energy,
+                                             G4double cosTheta) const {
+  G4int bin = Bin(energy, cosTheta);
+  if (bin < 0 || fBins.empty() || fBins[bin].empty())
+    return nullptr;
+  const std::vector<std::size_t> &candidates = fBins[bin];
+  std::size_t pick = static_cast<std::size_t>(G4UniformRand() *
+                                              candidates.size());
+  return &fHistories[candidates[std::min(pick, candidates.size() - 1)]];
+}
+
+G4double ModeratorKernel::EntryAzimuth(const G4ThreeVector &direction) {
+  // at normal incidence the azimuth is arbitrary, pick one at random so
+  // the replayed lateral spread stays symmetric
+  if (direction.perp() < 1e-9)
+    return twopi * G4UniformRand();
+  return direction.phi();
+}
+
+KernelExit ModeratorKernel::MakeExit(const G4ThreeVector &entryPosition,
+                                     G4double entryAzimuth,
+                                     const G4ThreeVector &position,
+                                     const G4ThreeVector &direction,
+                                     G4double energy, G4double time,
+                                     G4double halfZ) {
+  KernelExit exit;
+  exit.energy = energy;
+  exit.time = time;
+  exit.cosTheta = direction.z();
+  exit.w = position.z();
+  if (std::abs(position.z() - halfZ) < kFaceTolerance) {
+    exit.face = 1;
+  } else if (std::abs(position.z() + halfZ) < kFaceTolerance) {
+    exit.face = -1;
+  } else {
+    exit.face = 0;
+  }
+
+  if (exit.face == 0) {
+    exit.u = position.x();
+    exit.v = position.y();
+    exit.phi = direction.phi();
+  } else {
+    G4double c = std::cos(entryAzimuth), s = std::sin(entryAzimuth);
+    G4double dx = position.x() - entryPosition.x();
+    G4double dy = position.y() - entryPosition.y();
+    exit.u = dx * c + dy * s;
+    exit.v = -dx * s + dy * c;
+    exit.phi = direction.phi() - entryAzimuth;
+  }
+  return exit;
+}
+
+void ModeratorKernel::PlaceExit(const KernelExit &exit,
+                                const G4ThreeVector &entryPosition,
+                                G4double entryAzimuth, G4double halfX,
+                                G4double halfY, G4double halfZ,
+                                G4ThreeVector &position,
+                                G4ThreeVector &direction) {
+  G4double sinTheta =
+      std::sqrt(std::max(0., 1. - exit.cosTheta * exit.cosTheta));
+  if (exit.face == 0) {
+    position.set(exit.u, exit.v, exit.w);
+    direction.set(sinTheta * std::cos(exit.phi),
+                  sinTheta * std::sin(exit.phi), exit.cosTheta);
+    return;
+  }
+
+  G4double c = std::cos(entryAzimuth), s = std::sin(entryAzimuth);
+  // the kernel assumes a slab wider than the lateral spread, keep the rare
+  // histories that would leave the face on its edge
+  G4double x = entryPosition.x() + exit.u * c - exit.v * s;
+  G4double y = entryPosition.y() + exit.u * s + exit.v * c;
+  position.set(std::max(-halfX, std::min(halfX, x)),
+               std::max(-halfY, std::min(halfY, y)), exit.face * halfZ);
+  G4double phi = exit.phi + entryAzimuth;
+  direction.set(sinTheta * std::cos(phi), sinTheta * std::sin(phi),
+                exit.cosTheta);
+}
+
+void ModeratorKernel::Load() {
+  std::ifstream file(fFileName);
+  if (!file) {
+    G4Exception("ModeratorKernel::Load", "FileNotFound", FatalException,
+                ("Cannot open moderator kernel " + fFileName +
+                 ", run /moderator/fastsim/mode calibrate first")
+                    .c_str());
+    return;
+  }
+
+  G4String material;
+  G4double thickness = 0.;
+  G4String line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#')
+      continue;
+    std::istringstream fields(line);
+    G4String tag;
+    fields >> tag;
+    if (tag == "material") {
+      fields >> material;
+    } else if (tag == "thickness") {
+      fields >> thickness;
+    } else if (tag == "H") {
+      KernelHistory history;
+      std::size_t nExits = 0;
+      fields >> history.energy >> history.cosTheta >> nExits;
+      history.exits.reserve(nExits);
+      fHistories.push_back(history);
+    } else if (tag == "X" && !fHistories.empty()) {
+      KernelExit exit;
+      fields >> exit.face >> exit.energy >> exit.u >> exit.v >> exit.w >>
+          exit.cosTheta >> exit.phi >> exit.time;
+      fHistories.back().exits.push_back(exit);
+    }
+  }
+
+  if (material != fMaterial || std::abs(thickness - fThickness) > 1e-6) {
+    std::ostringstream message;
+    message << fFileName << " was calibrated for " << thickness / cm
+            << " cm of " << material << " but the moderator is "
+            << fThickness / cm << " cm of " << fMaterial;
+    G4Exception("ModeratorKernel::Load", "GeometryMismatch", FatalException,
+                message.str().c_str());
+  }
+
+  fBins.assign(kEnergyBins * kCosBins, std::vector<std::size_t>());
+  for (std::size_t i = 0; i < fHistories.size(); i++) {
+    G4int bin = Bin(fHistories[i].energy, fHistories[i].cosTheta);
+    if (bin >= 0)
+      fBins[bin].push_back(i);
+  }
+  G4cout << "Loaded " << fHistories.size() << " moderator histories from "
+         << fFileName << G4endl;
+}
+
+void ModeratorKernel::Write() const {
+  std::ofstream file(fFileName);
+  file.precision(10);
+  file << "# ThermalDT moderator kernel, energies in MeV, lengths in mm, "
+          "times in ns\n";
+  file << "# H energy cosTheta exits\n";
+  file << "# X face energy u v w cosTheta phi time\n";
+  file << "material " << fMaterial << "\n";
+  file << "thickness " << fThickness << "\n";
+
+  std::size_t transmitted = 0, reflected = 0, absorbed = 0;
+  for (const KernelHistory &history : fHistories) {
+    file << "H " << history.energy << " " << history.cosTheta << " "
+         << history.exits.size() << "\n";
+    if (history.exits.empty())
+      absorbed++;
+    for (const KernelExit &exit : history.exits) {
+      file << "X " << exit.face << " " << exit.energy << " " << exit.u << " "
+           << exit.v << " " << exit.w << " " << exit.cosTheta << " "
+           << exit.phi << " " << exit.time << "\n";
+      if (exit.face == 1)
+        transmitted++;
+      else if (exit.face == -1)
+        reflected++;
+    }
+  }
+  G4cout << "Wrote " << fHistories.size() << " moderator histories to "
+         << fFileName << ": " << transmitted << " transmitted, " << reflected
+         << " reflected, " << absorbed << " without exit" << G4endl;
+}
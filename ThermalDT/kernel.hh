@@ -0,0 +1,81 @@
+#ifndef KERNEL_HH
+#define KERNEL_HH
+
+#include "G4String.hh"
+#include "G4ThreeVector.hh"
+#include "G4Threading.hh"
+#include "G4Types.hh"
+#include <atomic>
+#include <vector>
+
+// One neutron leaving the moderator, relative to the entry of its history.
+// Face exits are stored in the frame of the entry azimuth so they can be
+// replayed at any entry point; side exits keep their absolute position.
+struct KernelExit {
+  G4int face;        // +1 downstream face, -1 entrance face, 0 side
+  G4double energy;
+  G4double u, v, w;  // lateral displacement along / across the entry azimuth
+  G4double cosTheta; // direction against the slab normal
+  G4double phi;      // azimuth, relative to the entry one for face exits
+  G4double time;     // delay since the entry
+};
+
+// Everything that came out of the slab for one neutron entering the
+// upstream face, including (n,2n) neutrons and absorption (no exits)
+struct KernelHistory {
+  G4double energy;
+  G4double cosTheta;
+  std::vector<KernelExit> exits;
+};
+
+// Transmission and reflection kernels of the moderator slab. A calibration
+// run with full physics collects histories from every worker; a fast run
+// loads them and replays a random history of the matching entry energy and
+// angle. Configured by the master run action.
+class ModeratorKernel {
+public:
+  enum Mode { kOff, kCalibrate, kFast };
+
+  static ModeratorKernel *Instance();
+
+  void Configure(Mode mode, const G4String &fileName,
+                 const G4String &material, G4double thickness);
+  void Finish();
+
+  Mode GetMode() const { return fMode.load(); }
+
+  void AddHistories(const std::vector<KernelHistory> &histories);
+  const KernelHistory *Sample(G4double energy, G4double cosTheta) const;
+
+  // Conversion between the slab frame and the entry frame of a history
+  static G4double EntryAzimuth(const G4ThreeVector &direction);
+  static KernelExit MakeExit(const G4ThreeVector &entryPosition,
+                             G4double entryAzimuth,
+                             const G4ThreeVector &position,
+                             const G4ThreeVector &direction, G4double energy,
+                             G4double time, G4double halfZ);
+  static void PlaceExit(const KernelExit &exit,
+                        const G4ThreeVector &entryPosition,
+                        G4double entryAzimuth, G4double halfX, G4double halfY,
+                        G4double halfZ, G4ThreeVector &position,
+                        G4ThreeVector &direction);
+
+private:
+  ModeratorKernel();
+  ~ModeratorKernel() {}
+
+  G4int Bin(G4double energy, G4double cosTheta) const;
+  void Load();
+  void Write() const;
+
+  G4Mutex fMutex;
+  std::atomic<Mode> fMode;
+  G4String fFileName;
+  G4String fMaterial;
+  G4double fThickness;
+
+  std::vector<KernelHistory> fHistories;
+  std::vector<std::vector<std::size_t>> fBins;
+};
+
+#endif
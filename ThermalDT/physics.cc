@@ -1,9 +1,55 @@
 #include "physics.hh"
 
-PhysicsList::PhysicsList() {
+#include "G4AutoLock.hh"
+#include "G4FastSimulationPhysics.hh"
+#include "G4ParallelWorldPhysics.hh"
+#include "importance.hh"
+#include "weightwindow.hh"
 
-  RegisterPhysics(new G4EmStandardPhysics());
-  RegisterPhysics(new G4HadronPhysicsQGSP_BIC_HP());
-  RegisterPhysics(new G4HadronElasticPhysicsHP());
+ModeratorPhysicsList::ModeratorPhysicsList(const G4String &config)
+    : CachedPhysicsList(config, "neutronhp") {
+  // lets the moderator kernel model take over neutrons
+  G4FastSimulationPhysics *fastSimulationPhysics =
+      new G4FastSimulationPhysics();
+  fastSimulationPhysics->ActivateFastSimulation("neutron");
+  RegisterPhysics(fastSimulationPhysics);
+
+  RegisterPhysics(new ModeratorBiasingPhysics());
+  RegisterPhysics(new G4ParallelWorldPhysics(ImportanceWorld::kWorldName));
+}
+
+ModeratorPhysicsList::~ModeratorPhysicsList() {}
+
+ModeratorBiasingPhysics::ModeratorBiasingPhysics()
+    : G4VPhysicsConstructor("ModeratorBiasing") {
+  // the sampler finds the parallel world by name once it is built
+  fSampler = new G4GeometrySampler(nullptr, "neutron");
+  fSampler->SetParallel(true);
+  fAlgorithm = new G4WeightWindowAlgorithm(WeightWindow::kUpperFactor,
+                                           WeightWindow::kSurvivalFactor,
+                                           WeightWindow::kMaxSplits);
+}
+
+ModeratorBiasingPhysics::~ModeratorBiasingPhysics() {
+  delete fSampler;
+  delete fAlgorithm;
+}
+
+void ModeratorBiasingPhysics::ConstructParticle() {}
+
+void ModeratorBiasingPhysics::ConstructProcess() {
+  G4AutoLock lock(&fMutex);
+  if (WeightWindow::Instance()->IsLoaded()) {
+    G4WeightWindowStore *store =
+        G4WeightWindowStore::GetInstance(ImportanceWorld::kWorldName);
+    fSampler->SetWorld(store->GetParallelWorldVolumePointer());
+    fSampler->PrepareWeightWindow(store, fAlgorithm, onBoundary);
+  } else {
+    G4IStore *store = G4IStore::GetInstance(ImportanceWorld::kWorldName);
+    fSampler->SetWorld(store->GetParallelWorldVolumePointer());
+    fSampler->PrepareImportanceSampling(store, nullptr);
+  }
+  fSampler->Configure();
+  // the processes go to the process managers of the calling thread
+  fSampler->AddProcess();
 }
-PhysicsList::~PhysicsList() {}
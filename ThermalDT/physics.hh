@@ -1,15 +1,36 @@
 #ifndef PHYSICS_HH
 #define PHYSICS_HH
 
-#include "G4EmStandardPhysics.hh"
-#include "G4HadronElasticPhysicsHP.hh"
-#include "G4HadronPhysicsQGSP_BIC_HP.hh"
-#include "G4VModularPhysicsList.hh"
+#include "G4GeometrySampler.hh"
+#include "G4Threading.hh"
+#include "G4VPhysicsConstructor.hh"
+#include "G4WeightWindowAlgorithm.hh"
+#include "cache.hh"
 
-class PhysicsList : public G4VModularPhysicsList {
+// The -p physics plus the moderator kernel fast simulation and the
+// moderator biasing, with the physics tables taken from the cache.
+class ModeratorPhysicsList : public CachedPhysicsList {
 public:
-  PhysicsList();
-  ~PhysicsList();
+  ModeratorPhysicsList(const G4String &config);
+  ~ModeratorPhysicsList();
+};
+
+// Splitting and roulette of neutrons at the moderator cells, from the cell
+// importances or, after /moderator/window/load, from weight windows. The
+// choice is made when the processes are built at /run/initialize.
+class ModeratorBiasingPhysics : public G4VPhysicsConstructor {
+public:
+  ModeratorBiasingPhysics();
+  ~ModeratorBiasingPhysics();
+
+  virtual void ConstructParticle();
+  virtual void ConstructProcess();
+
+private:
+  // shared by the workers, which configure it one at a time
+  G4GeometrySampler *fSampler;
+  G4WeightWindowAlgorithm *fAlgorithm;
+  G4Mutex fMutex;
 };
 
 #endif
@@ -1,15 +1,16 @@
 #include "run.hh"
 
-RunAction::RunAction() {
+RunAction::RunAction()
+    : fFastSimMode("off"), fKernelFile("moderator.kernel") {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
 
   man->CreateNtuple("PreEnergy", "PreEnergy");
   man->CreateNtupleDColumn("fPreEnergy");
+  man->CreateNtupleDColumn("fPreWeight");
   man->FinishNtuple(0);
 
   man->CreateNtuple("PostEnergy", "PostEnergy");
   man->CreateNtupleDColumn("fPostEnergy");
-  man->FinishNtuple(1);
 
   // Additional columns for position (x, y, z) and momentum (px, py, pz)
   man->CreateNtupleDColumn("fPostPosX");
@@ -18,18 +19,133 @@ RunAction::RunAction() {
   man->CreateNtupleDColumn("fPostMomX");
   man->CreateNtupleDColumn("fPostMomY");
   man->CreateNtupleDColumn("fPostMomZ");
+  // track weight, not 1 with /moderator/importance
+  man->CreateNtupleDColumn("fPostWeight");
+  man->FinishNtuple(1);
+
+  // Thermal tally in the simAnalysis window, merged over threads by Geant4
+  // so the thickness scan does not have to read the PostEnergy tree.
+  // Filled with the track weight.
+  man->CreateH1("PostEnergyThermal", "Thermal neutrons leaving the moderator",
+                1, 0.015 * eV, 0.030 * eV, "eV");
+
+  DefineFastSimCommands();
+  DefineCacheCommands();
+  DefineWindowCommands();
+}
+RunAction::~RunAction() {
+  delete fFastSimMessenger;
+  delete fCacheMessenger;
+  delete fWindowMessenger;
+}
+
+void RunAction::DefineFastSimCommands() {
+  fFastSimMessenger = new G4GenericMessenger(
+      this, "/moderator/fastsim/", "Kernel model for the moderator slab");
+  fFastSimMessenger
+      ->DeclareProperty("mode", fFastSimMode,
+                        "off: full transport, calibrate: full transport and "
+                        "record the kernel, fast: replay the kernel")
+      .SetCandidates("off calibrate fast");
+  fFastSimMessenger->DeclareProperty(
+      "kernel", fKernelFile, "Kernel file written by calibrate, read by fast");
+}
+
+void RunAction::DefineCacheCommands() {
+  // the tables are looked up during /run/initialize, so these have to come
+  // before it in the macro
+  fCacheMessenger =
+      new G4GenericMessenger(PhysicsTableCache::Instance(), "/physics/cache/",
+                             "Cache of the built physics tables");
+  fCacheMessenger->DeclareMethod("enable", &PhysicsTableCache::SetEnabled,
+                                 "Retrieve and store physics tables, off "
+                                 "by default");
+  fCacheMessenger->DeclareMethod(
+      "directory", &PhysicsTableCache::SetDirectory,
+      "Cache directory, shared by all jobs of a scan");
+}
+
+void RunAction::DefineWindowCommands() {
+  fWindowMessenger =
+      new G4GenericMessenger(WeightWindow::Instance(), "/moderator/window/",
+                             "Weight windows on the moderator cells");
+  fWindowMessenger
+      ->DeclareMethod("load", &WeightWindow::Load,
+                      "Weight window file to use instead of the cell "
+                      "importances, before /run/initialize")
+      .SetStates(G4State_PreInit)
+      .SetToBeBroadcasted(false);
+  fWindowMessenger
+      ->DeclareMethod("generate", &WeightWindow::Generate,
+                      "Write weight windows for the tally at the end of "
+                      "the run, none to stop")
+      .SetToBeBroadcasted(false);
+  fWindowMessenger
+      ->DeclareMethod("detector", &WeightWindow::SetTallyDetector,
+                      "Detector the tally counts neutrons in")
+      .SetCandidates("WrapPost WrapPre")
+      .SetToBeBroadcasted(false);
+  fWindowMessenger
+      ->DeclareMethodWithUnit("tallyMin", "eV", &WeightWindow::SetTallyMin,
+                              "Lowest neutron energy of the tally")
+      .SetToBeBroadcasted(false);
+  fWindowMessenger
+      ->DeclareMethodWithUnit("tallyMax", "eV", &WeightWindow::SetTallyMax,
+                              "Highest neutron energy of the tally")
+      .SetToBeBroadcasted(false);
+}
+
+void RunAction::ConfigureFastSim() {
+  ModeratorKernel::Mode mode = ModeratorKernel::kOff;
+  if (fFastSimMode == "calibrate") {
+    mode = ModeratorKernel::kCalibrate;
+  } else if (fFastSimMode == "fast") {
+    mode = ModeratorKernel::kFast;
+  }
+
+  const DetectorConstruction *detectorConstruction =
+      static_cast<const DetectorConstruction *>(
+          G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  G4LogicalVolume *moderator = detectorConstruction->GetModeratorVolume();
+  ModeratorKernel::Instance()->Configure(
+      mode, fKernelFile, moderator->GetMaterial()->GetName(),
+      2 * detectorConstruction->GetModeratorHalfZ());
 }
-RunAction::~RunAction() {}
 void RunAction::BeginOfRunAction(const G4Run *run) {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
+  const DetectorConstruction *detectorConstruction =
+      static_cast<const DetectorConstruction *>(
+          G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  if (IsMaster()) {
+    PhysicsTableCache::Instance()->Store();
+    ConfigureFastSim();
+    // loads the weight windows before the workers fill their stores
+    WeightWindow::Instance()->BeginRun(
+        detectorConstruction->GetModeratorVolume()->GetMaterial()->GetName(),
+        2 * detectorConstruction->GetModeratorHalfZ(),
+        detectorConstruction->GetImportanceWorld()->GetLayers());
+    fTimer.Start();
+  }
+  detectorConstruction->GetImportanceWorld()->FillStore();
   G4int runNumber = run->GetRunID();
   std::stringstream strRunID;
   strRunID << runNumber;
-  man->OpenFile("output" + strRunID.str() + ".root");
+  // a /moderator/sweep names the output after the point
+  G4String outputName = detectorConstruction->GetOutputName();
+  if (outputName.empty())
+    outputName = "output" + strRunID.str();
+  man->OpenFile(outputName + ".root");
 }
-void RunAction::EndOfRunAction(const G4Run *) {
+void RunAction::EndOfRunAction(const G4Run *run) {
   G4AnalysisManager *man = G4AnalysisManager::Instance();
 
   man->Write();
   man->CloseFile("output.root");
+
+  if (IsMaster()) {
+    ModeratorKernel::Instance()->Finish();
+    fTimer.Stop();
+    WeightWindow::Instance()->Finish(run->GetNumberOfEvent(),
+                                     fTimer.GetRealElapsed());
+  }
 }
@@ -2,8 +2,15 @@
 #define RUN_HH
 
 #include "G4AnalysisManager.hh"
+#include "G4GenericMessenger.hh"
+#include "G4RunManager.hh"
 #include "G4Run.hh"
+#include "G4Timer.hh"
 #include "G4UserRunAction.hh"
+#include "cache.hh"
+#include "construction.hh"
+#include "kernel.hh"
+#include "weightwindow.hh"
 
 class RunAction : public G4UserRunAction {
 public:
@@ -12,6 +19,19 @@ public:
 
   virtual void BeginOfRunAction(const G4Run *);
   virtual void EndOfRunAction(const G4Run *);
+
+private:
+  void DefineFastSimCommands();
+  void DefineCacheCommands();
+  void DefineWindowCommands();
+  void ConfigureFastSim();
+
+  G4GenericMessenger *fFastSimMessenger;
+  G4GenericMessenger *fCacheMessenger;
+  G4GenericMessenger *fWindowMessenger;
+  G4Timer fTimer;
+  G4String fFastSimMode;
+  G4String fKernelFile;
 };
 
 #endif
@@ -17,13 +17,16 @@
 
 int main(int argc, char **argv) {
 
+  // -p <physics> picks the physics list, see physics.hh
+  G4String physicsConfig = TakePhysicsOption(argc, argv);
+
 #ifdef G4MULTITHREADED
   G4MTRunManager *runManager = new G4MTRunManager();
 #else
   G4RunManager *runManager = new G4RunManager();
 #endif
   runManager->SetUserInitialization(new DetectorConstruction());
-  runManager->SetUserInitialization(new PhysicsList());
+  runManager->SetUserInitialization(new ModeratorPhysicsList(physicsConfig));
   runManager->SetUserInitialization(new ActionInitialization());
 
   G4UIExecutive *ui = 0;
@@ -0,0 +1,157 @@
+#include <ROOT/RDataFrame.hxx>
+#include <ROOT/TSeq.hxx>
+#include <TFile.h>
+#include <TH1.h>
+#include <TMath.h>
+#include <TROOT.h>
+#include <TThreadExecutor.h>
+#include <TTree.h>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Thermal neutron counts for every (material, thickness) output of a
+// moderator scan. All files are processed at the same time, each either from
+// the PostEnergyThermal tally written by the simulation or, when the file
+// has none (or it covers a different window), from a bulk read of the
+// PostEnergy tree. Counts are sums of the track weights, so runs with
+// moderator importance splitting give the same flux with a smaller error.
+//
+// Can be included in a macro or compiled on its own:
+//   root -l -b -q 'ThicknessScan.cpp+'
+struct ScanPoint {
+  std::string material;
+  int thickness;
+  std::string fileName;
+  bool found = false;
+  bool fromTally = false;
+  Long64_t entries = 0;
+  double thermalCount = 0.;
+  double thermalError = 0.;
+  double flux = 0.;
+  double fluxError = 0.;
+};
+
+// Energies in MeV, as stored in fPostEnergy; the tally axis is in eV
+bool CountFromTally(TFile *file, double lower, double upper,
+                    ScanPoint &point) {
+  TH1 *tally = nullptr;
+  file->GetObject("PostEnergyThermal", tally);
+  if (!tally)
+    return false;
+  TAxis *axis = tally->GetXaxis();
+  double tolerance = 1e-3 * (upper - lower) * 1e6;
+  if (TMath::Abs(axis->GetXmin() - lower * 1e6) > tolerance ||
+      TMath::Abs(axis->GetXmax() - upper * 1e6) > tolerance)
+    return false;
+  point.thermalCount =
+      tally->IntegralAndError(1, tally->GetNbinsX(), point.thermalError);
+  point.entries = (Long64_t)tally->GetEntries();
+  point.fromTally = true;
+  return true;
+}
+
+bool CountFromTree(TFile *file, double lower, double upper,
+                   ScanPoint &point) {
+  TTree *tree = nullptr;
+  file->GetObject("PostEnergy", tree);
+  if (!tree) {
+    std::cerr << "Error: PostEnergy tree not found in " << point.fileName
+              << "!" << std::endl;
+    return false;
+  }
+  ROOT::RDataFrame frame(*tree, {"fPostEnergy"});
+  auto entries = frame.Count();
+  // outputs from before the weight column are analog
+  const char *weight = tree->GetBranch("fPostWeight") ? "fPostWeight" : "1.";
+  auto thermal = frame
+                     .Filter([lower, upper](double postEnergy) {
+                       return postEnergy >= lower && postEnergy <= upper;
+                     })
+                     .Define("weight", weight)
+                     .Define("weight2", "weight * weight");
+  auto sum = thermal.Sum<double>("weight");
+  auto sum2 = thermal.Sum<double>("weight2");
+  point.thermalCount = *sum;
+  point.thermalError = TMath::Sqrt(*sum2);
+  point.entries = *entries;
+  return true;
+}
+
+// fileFormat gets the material and the thickness, e.g. "../%s%dcm.root".
+// The flux is the thermal count times normalization, with its statistical
+// error.
+std::vector<ScanPoint>
+ScanThicknesses(const std::vector<std::string> &materials, int firstThickness,
+                int lastThickness, double lower = 0.015 * 1e-6,
+                double upper = 0.030 * 1e-6, double normalization = 100,
+                const char *fileFormat = "../%s%dcm.root") {
+  std::vector<ScanPoint> points;
+  for (const std::string &material : materials) {
+    for (int thickness = firstThickness; thickness <= lastThickness;
+         ++thickness) {
+      ScanPoint point;
+      point.material = material;
+      point.thickness = thickness;
+      char fileName[512];
+      std::snprintf(fileName, sizeof(fileName), fileFormat, material.c_str(),
+                    thickness);
+      point.fileName = fileName;
+      points.push_back(point);
+    }
+  }
+
+  ROOT::EnableThreadSafety();
+  if (!ROOT::IsImplicitMTEnabled())
+    ROOT::EnableImplicitMT();
+
+  auto process = [&](size_t i) {
+    ScanPoint &point = points[i];
+    TFile *file = TFile::Open(point.fileName.c_str());
+    if (!file || file->IsZombie()) {
+      std::cerr << "Error opening file " << point.fileName << "!"
+                << std::endl;
+      delete file;
+      return 0;
+    }
+    point.found = CountFromTally(file, lower, upper, point) ||
+                  CountFromTree(file, lower, upper, point);
+    point.flux = normalization * point.thermalCount;
+    point.fluxError = normalization * point.thermalError;
+    file->Close();
+    delete file;
+    return 0;
+  };
+
+  ROOT::TThreadExecutor pool;
+  pool.Map(process, ROOT::TSeqUL(points.size()));
+  return points;
+}
+
+void PrintScan(const std::vector<ScanPoint> &points,
+               const char *csvName = "ThermalFluxVsThickness.csv") {
+  std::printf("%-8s %10s %14s %14s %14s %12s %6s\n", "Material",
+              "Thickness", "Entries", "Thermal", "Flux (n/s)", "Error",
+              "From");
+  std::ofstream csv(csvName);
+  csv << "material,thickness_cm,entries,thermal_count,flux,flux_error,source"
+      << std::endl;
+  for (const ScanPoint &point : points) {
+    if (!point.found)
+      continue;
+    const char *source = point.fromTally ? "tally" : "tree";
+    std::printf("%-8s %8d cm %14lld %14.6g %14.4g %12.3g %6s\n",
+                point.material.c_str(), point.thickness, point.entries,
+                point.thermalCount, point.flux, point.fluxError, source);
+    csv << point.material << "," << point.thickness << "," << point.entries
+        << "," << point.thermalCount << "," << point.flux << ","
+        << point.fluxError << "," << source << std::endl;
+  }
+  std::cout << "Wrote " << csvName << std::endl;
+}
+
+void ThicknessScan() {
+  PrintScan(ScanThicknesses({"Water", "Poly"}, 10, 17));
+}
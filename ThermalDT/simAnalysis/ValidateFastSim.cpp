@@ -0,0 +1,101 @@
+#include <ROOT/RDataFrame.hxx>
+#include <TCanvas.h>
+#include <TChain.h>
+#include <TH1D.h>
+#include <TLegend.h>
+#include <TMath.h>
+#include <TPad.h>
+#include <TROOT.h>
+#include <iostream>
+#include <vector>
+
+// Compares what reaches WrapPost with the moderator kernel model against
+// full transport, from the outputs of fastsim.mac (run 1 fast, run 2 full).
+// Energies in MeV, as stored in fPostEnergy.
+TH1D *PostSpectrum(const char *pattern, const char *name,
+                   const std::vector<double> &edges, double &thermal,
+                   Long64_t &entries) {
+  TChain chain("PostEnergy");
+  chain.Add(pattern);
+  ROOT::RDataFrame df(chain);
+  auto hist = df.Histo1D({name, ";Energy (MeV);Neutrons per bin",
+                          (int)edges.size() - 1, edges.data()},
+                         "fPostEnergy");
+  auto count =
+      df.Filter("fPostEnergy >= 0.015e-6 && fPostEnergy <= 0.030e-6").Count();
+  thermal = *count;
+  entries = *df.Count();
+  TH1D *result = (TH1D *)hist->Clone(name);
+  result->SetDirectory(nullptr);
+  return result;
+}
+
+void ValidateFastSim(const char *fullPattern = "../build/output2_t*.root",
+                     const char *fastPattern = "../build/output1_t*.root") {
+  gROOT->SetBatch(kTRUE);
+  ROOT::EnableImplicitMT();
+
+  // logarithmic from 1 meV to 20 MeV, 10 bins per decade
+  std::vector<double> edges;
+  for (int i = 0; i <= 100; i++)
+    edges.push_back(1e-9 * TMath::Power(10., i / 10.));
+
+  double fullThermal, fastThermal;
+  Long64_t fullEntries, fastEntries;
+  TH1D *full =
+      PostSpectrum(fullPattern, "FullTransport", edges, fullThermal,
+                   fullEntries);
+  TH1D *fast =
+      PostSpectrum(fastPattern, "KernelModel", edges, fastThermal,
+                   fastEntries);
+
+  // both runs have the same number of primaries, so compare as counts
+  double ratio = fastThermal / fullThermal;
+  double ratioError =
+      ratio * TMath::Sqrt(1. / fastThermal + 1. / fullThermal);
+  std::cout << "Neutrons at WrapPost: full " << fullEntries << ", kernel "
+            << fastEntries << std::endl;
+  std::cout << "Thermal (0.015-0.030 eV): full " << fullThermal
+            << ", kernel " << fastThermal << ", ratio " << ratio << " +/- "
+            << ratioError << std::endl;
+  std::cout << "Chi2 test p-value: " << full->Chi2Test(fast, "UU")
+            << ", Kolmogorov p-value: " << full->KolmogorovTest(fast)
+            << std::endl;
+
+  TCanvas *c1 = new TCanvas("c1", "c1", 2000, 1500);
+  TPad *top = new TPad("top", "", 0, 0.3, 1, 1);
+  TPad *bottom = new TPad("bottom", "", 0, 0, 1, 0.3);
+  top->SetLogx();
+  top->SetLogy();
+  bottom->SetLogx();
+  top->Draw();
+  bottom->Draw();
+
+  top->cd();
+  full->SetLineColor(kBlue);
+  full->SetLineWidth(2);
+  full->Draw("HIST E");
+  fast->SetLineColor(kRed);
+  fast->SetLineWidth(2);
+  fast->Draw("HIST E SAME");
+  TLegend *legend = new TLegend(0.15, 0.75, 0.45, 0.88);
+  legend->AddEntry(full, "Full transport", "l");
+  legend->AddEntry(fast, "Kernel model", "l");
+  legend->Draw();
+
+  bottom->cd();
+  TH1D *ratioHist = (TH1D *)fast->Clone("Ratio");
+  ratioHist->Divide(full);
+  ratioHist->SetTitle(";Energy (MeV);Kernel / Full");
+  ratioHist->SetMinimum(0.5);
+  ratioHist->SetMaximum(1.5);
+  ratioHist->Draw("E");
+
+  c1->Print("FastSimValidation.png");
+
+  delete legend;
+  delete c1;
+  delete ratioHist;
+  delete full;
+  delete fast;
+}
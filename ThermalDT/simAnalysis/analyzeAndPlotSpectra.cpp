@@ -1,8 +1,10 @@
 #include "PlotFunctions.cpp"
+#include "ThicknessScan.cpp"
 #include <TCanvas.h>
 #include <TFile.h>
 #include <TGaxis.h>
 #include <TGraph.h>
+#include <TGraphErrors.h>
 #include <TH1D.h>
 #include <TLegend.h>
 #include <TPaveText.h>
@@ -21,92 +23,36 @@ void analyzeAndPlotSpectra() {
 
   // Arrays to store the thicknesses and corresponding normalized thermal counts
   std::vector<double> thicknesses;
-  std::vector<double> waterThermalCounts;
-  std::vector<double> polyThermalCounts;
-
-  // Function to process ROOT files and extract thermal counts
-  auto processFiles = [&](const std::string &material,
-                          std::vector<double> &thermalCounts) {
-    for (int thickness = 10; thickness <= 17; thickness += 1) {
-      // Create the filename
-      std::ostringstream filename;
-      filename << "../" << material << thickness << "cm.root";
-
-      // Open the ROOT file
-      TFile *file = TFile::Open(filename.str().c_str());
-
-      if (!file || file->IsZombie()) {
-        std::cerr << "Error opening file " << filename.str() << "!"
-                  << std::endl;
-        continue;
-      }
-
-      // Get the ntuple from the file
-      TTree *tree = (TTree *)file->Get("PostEnergy");
-
-      if (!tree) {
-        std::cerr << "Error: PostEnergy tree not found in " << filename.str()
-                  << "!" << std::endl;
-        file->Close();
-        delete file; // ensure file is deleted
-        continue;
-      }
-
-      // Variables to hold the branch values
-      Double_t postEnergy;
-
-      // Set branch addresses
-      tree->SetBranchAddress("fPostEnergy", &postEnergy);
-
-      Int_t nEntries = tree->GetEntries();
-      Int_t thermalCount = 0;
-
-      // Loop over tree entries to count thermal neutrons
-      for (Int_t i = 0; i < nEntries; ++i) {
-        tree->GetEntry(i);
-        if (postEnergy >= thermalEnergyLower &&
-            postEnergy <= thermalEnergyUpper) {
-          ++thermalCount;
-        }
-      }
-
-      // Normalize the thermal count
-      double normalizedThermalCount = static_cast<double>(thermalCount) * 100;
-
-      // Store the results
-      // Only add the thickness once
-      if (material == "Water") {
-        thicknesses.push_back(thickness);
-      }
-      thermalCounts.push_back(normalizedThermalCount);
-
-      // Output results for current file
-      std::cout << material << " File: " << filename.str() << std::endl;
-      std::cout << "  Total entries: " << nEntries << std::endl;
-      std::cout << "  Number of thermal neutrons: " << thermalCount
-                << std::endl;
-      std::cout << "  Normalized number of thermal neutrons: "
-                << normalizedThermalCount << std::endl;
-
-      // Clean up
-      file->Close();
-      delete file;
+  std::vector<double> waterThermalCounts, waterThermalErrors;
+  std::vector<double> polyThermalCounts, polyThermalErrors;
+
+  // All files are counted concurrently, see ThicknessScan.cpp
+  std::vector<ScanPoint> scan =
+      ScanThicknesses({"Water", "Poly"}, 10, 17, thermalEnergyLower,
+                      thermalEnergyUpper, 100);
+  PrintScan(scan);
+  for (const ScanPoint &point : scan) {
+    if (!point.found)
+      continue;
+    if (point.material == "Water") {
+      thicknesses.push_back(point.thickness);
+      waterThermalCounts.push_back(point.flux);
+      waterThermalErrors.push_back(point.fluxError);
+    } else {
+      polyThermalCounts.push_back(point.flux);
+      polyThermalErrors.push_back(point.fluxError);
     }
-  };
-
-  // Process water files
-  processFiles("Water", waterThermalCounts);
-
-  // Process poly files
-  processFiles("Poly", polyThermalCounts);
+  }
+  std::vector<double> thicknessErrors(thicknesses.size(), 0.);
 
   // Create a canvas to plot the thermal neutrons vs. thickness
   TCanvas *c3 =
       new TCanvas("c3", "Thermal Neutrons vs. Moderator Thickness", 2000, 1600);
   // Create the TGraph for poly files
   // Create TGraphs for each material
-  TGraph *graphWater =
-      new TGraph(thicknesses.size(), &thicknesses[0], &waterThermalCounts[0]);
+  TGraphErrors *graphWater = new TGraphErrors(
+      thicknesses.size(), &thicknesses[0], &waterThermalCounts[0],
+      &thicknessErrors[0], &waterThermalErrors[0]);
   graphWater->SetTitle(";Moderator Thickness "
                        "(cm);Estimated Thermal Neutron Flux (n/s)");
   graphWater->SetMarkerStyle(20);
@@ -114,8 +60,9 @@ void analyzeAndPlotSpectra() {
   graphWater->SetMarkerColor(kBlue);
 
   // Create the TGraph for poly files
-  TGraph *graphPoly =
-      new TGraph(thicknesses.size(), &thicknesses[0], &polyThermalCounts[0]);
+  TGraphErrors *graphPoly = new TGraphErrors(
+      thicknesses.size(), &thicknesses[0], &polyThermalCounts[0],
+      &thicknessErrors[0], &polyThermalErrors[0]);
   graphPoly->SetMarkerStyle(21);
   graphPoly->SetMarkerSize(2);
   graphPoly->SetMarkerColor(kRed);
@@ -0,0 +1,104 @@
+#include "stepping.hh"
+
+SteppingAction::SteppingAction(EventAction *eventAction) {
+  fEventAction = eventAction;
+}
+
+SteppingAction::~SteppingAction() {}
+
+void SteppingAction::UserSteppingAction(const G4Step *step) {
+  RecordWeightWindow(step);
+
+  if (ModeratorKernel::Instance()->GetMode() != ModeratorKernel::kCalibrate)
+    return;
+
+  G4Track *track = step->GetTrack();
+  if (track->GetDefinition() != G4Neutron::Definition())
+    return;
+
+  const DetectorConstruction *detectorConstruction =
+      static_cast<const DetectorConstruction *>(
+          G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  G4LogicalVolume *moderator = detectorConstruction->GetModeratorVolume();
+  G4double halfZ = detectorConstruction->GetModeratorHalfZ();
+
+  G4StepPoint *preStep = step->GetPreStepPoint();
+  G4StepPoint *postStep = step->GetPostStepPoint();
+  G4VPhysicalVolume *preVolume = preStep->GetPhysicalVolume();
+  G4VPhysicalVolume *postVolume = postStep->GetPhysicalVolume();
+  G4bool preInside = preVolume && preVolume->GetLogicalVolume() == moderator;
+  G4bool postInside =
+      postVolume && postVolume->GetLogicalVolume() == moderator;
+
+  if (track->GetCurrentStepNumber() == 1 && preInside)
+    fEventAction->InheritHistory(track->GetTrackID(), track->GetParentID());
+
+  if (!preInside && postInside) {
+    // only the upstream face, which is where the fast model triggers
+    const G4AffineTransform &toLocal =
+        postStep->GetTouchableHandle()->GetHistory()->GetTopTransform();
+    G4ThreeVector position = toLocal.TransformPoint(postStep->GetPosition());
+    G4ThreeVector direction =
+        toLocal.TransformAxis(postStep->GetMomentumDirection());
+    if (std::abs(position.z() + halfZ) < 1. * um && direction.z() > 0.) {
+      fEventAction->EnterModerator(track->GetTrackID(),
+                                   postStep->GetKineticEnergy(), position,
+                                   direction, postStep->GetGlobalTime());
+    }
+  } else if (preInside && !postInside) {
+    const G4AffineTransform &toLocal =
+        preStep->GetTouchableHandle()->GetHistory()->GetTopTransform();
+    fEventAction->LeaveModerator(
+        track->GetTrackID(), postStep->GetKineticEnergy(),
+        toLocal.TransformPoint(postStep->GetPosition()),
+        toLocal.TransformAxis(postStep->GetMomentumDirection()),
+        postStep->GetGlobalTime(), halfZ);
+  }
+}
+
+void SteppingAction::RecordWeightWindow(const G4Step *step) {
+  G4Track *track = step->GetTrack();
+  if (track->GetDefinition() != G4Neutron::Definition())
+    return;
+  WeightWindow *windows = WeightWindow::Instance();
+  G4StepPoint *preStep = step->GetPreStepPoint();
+  G4StepPoint *postStep = step->GetPostStepPoint();
+
+  if (windows->IsGenerating()) {
+    const DetectorConstruction *detectorConstruction =
+        static_cast<const DetectorConstruction *>(
+            G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+    ImportanceWorld *world = detectorConstruction->GetImportanceWorld();
+    // a point on a cell boundary belongs to the cell it is heading into
+    auto cellOf = [world](const G4StepPoint *point) {
+      return world->CellAt(point->GetPosition().z() +
+                           point->GetMomentumDirection().z() * nm);
+    };
+    G4int preCell = cellOf(preStep);
+    G4int postCell = cellOf(postStep);
+    // the weight is taken before any splitting or roulette at the boundary
+    if (track->GetParentID() == 0 && track->GetCurrentStepNumber() == 1)
+      fEventAction->EnterCell(
+          track, windows->Bin(preCell, preStep->GetKineticEnergy()),
+          preStep->GetWeight());
+    if (postCell != preCell)
+      fEventAction->EnterCell(
+          track, windows->Bin(postCell, postStep->GetKineticEnergy()),
+          preStep->GetWeight());
+    for (const G4Track *secondary : *step->GetSecondaryInCurrentStep()) {
+      if (secondary->GetDefinition() == G4Neutron::Definition())
+        fEventAction->InheritCells(track, secondary);
+    }
+  }
+
+  // scored like the sensitive detector, every step inside it
+  G4VSensitiveDetector *detector =
+      preStep->GetPhysicalVolume()->GetLogicalVolume()->GetSensitiveDetector();
+  if (detector && detector->GetName() == windows->GetTallyDetector() &&
+      windows->InTally(track->GetKineticEnergy()))
+    fEventAction->ScoreTally(track, track->GetWeight());
+
+  if (track->GetTrackStatus() == fStopAndKill ||
+      track->GetTrackStatus() == fKillTrackAndSecondaries)
+    fEventAction->ForgetTrack(track);
+}
@@ -0,0 +1,25 @@
+#ifndef STEPPING_HH
+#define STEPPING_HH
+
+#include "G4Neutron.hh"
+#include "G4RunManager.hh"
+#include "G4Step.hh"
+#include "G4UserSteppingAction.hh"
+
+#include "construction.hh"
+#include "event.hh"
+
+class SteppingAction : public G4UserSteppingAction {
+public:
+  SteppingAction(EventAction *eventAction);
+  ~SteppingAction();
+
+  virtual void UserSteppingAction(const G4Step *);
+
+private:
+  void RecordWeightWindow(const G4Step *step);
+
+  EventAction *fEventAction;
+};
+
+#endif
@@ -0,0 +1,246 @@
+#include "weightwindow.hh"
+
+#include "G4AutoLock.hh"
+#include "G4Exception.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+// upper edges of the energy bins, the last one is above any DT neutron
+static const G4double kUpperEnergies[] = {0.1 * eV, 10. * eV, 10. * keV,
+                                          1. * MeV, 1. * GeV};
+
+WeightWindow *WeightWindow::Instance() {
+  static WeightWindow instance;
+  return &instance;
+}
+
+WeightWindow::WeightWindow()
+    : fGenerating(false), fTallyDetector("WrapPost"),
+      fTallyMin(0.015 * eV), fTallyMax(0.030 * eV), fThickness(0.),
+      fCells(0), fTallySum(0.), fTallySum2(0.) {}
+
+void WeightWindow::Load(const G4String &fileName) {
+  G4AutoLock lock(&fMutex);
+  fLoadFile = fileName;
+  fLowerWeights.clear();
+}
+
+void WeightWindow::Generate(const G4String &fileName) {
+  G4AutoLock lock(&fMutex);
+  fGenerateFile = fileName == "none" ? G4String() : fileName;
+  fGenerating = !fGenerateFile.empty();
+}
+
+void WeightWindow::SetTallyDetector(const G4String &detector) {
+  fTallyDetector = detector;
+}
+
+G4int WeightWindow::EnergyBins() {
+  return sizeof(kUpperEnergies) / sizeof(kUpperEnergies[0]);
+}
+
+G4int WeightWindow::EnergyBin(G4double energy) {
+  G4int bin = 0;
+  while (bin < EnergyBins() - 1 && energy > kUpperEnergies[bin])
+    bin++;
+  return bin;
+}
+
+G4int WeightWindow::Bin(G4int cell, G4double energy) const {
+  return cell * EnergyBins() + EnergyBin(energy);
+}
+
+void WeightWindow::BeginRun(const G4String &material, G4double thickness,
+                            G4int layers) {
+  G4AutoLock lock(&fMutex);
+  // a loaded file is checked again after a moderator change
+  G4bool changed = material != fMaterial || thickness != fThickness ||
+                   layers + 2 != fCells;
+  fMaterial = material;
+  fThickness = thickness;
+  // the rest of the world, the layers and the cell downstream
+  fCells = layers + 2;
+  fEntered.assign(Bins(), 0.);
+  fScore.assign(Bins(), 0.);
+  fTallySum = 0.;
+  fTallySum2 = 0.;
+  if (IsLoaded() && (fLowerWeights.empty() || changed))
+    Read();
+}
+
+void WeightWindow::AddEvent(const std::vector<G4double> &entered,
+                            const std::vector<G4double> &score,
+                            G4double tally) {
+  G4AutoLock lock(&fMutex);
+  for (std::size_t i = 0; i < entered.size() && i < fEntered.size(); i++) {
+    fEntered[i] += entered[i];
+    fScore[i] += score[i];
+  }
+  fTallySum += tally;
+  fTallySum2 += tally * tally;
+}
+
+void WeightWindow::Finish(G4int events, G4double seconds) {
+  G4AutoLock lock(&fMutex);
+  if (events < 2)
+    return;
+  G4double mean = fTallySum / events;
+  G4double variance =
+      (fTallySum2 - fTallySum * fTallySum / events) / (events - 1.);
+  G4double error = std::sqrt(std::max(variance, 0.) / events);
+  G4double relative = mean > 0. ? error / mean : 0.;
+  G4double fom =
+      relative > 0. && seconds > 0. ? 1. / (relative * relative * seconds)
+                                    : 0.;
+  G4cout << "Tally " << fTallyDetector << ": " << mean << " +- " << error
+         << " per event, " << seconds << " s, FOM " << fom << G4endl;
+
+  if (IsGenerating())
+    Write(events);
+}
+
+G4UpperEnergyToLowerWeightMap
+WeightWindow::GetLowerWeights(G4int cell) const {
+  G4UpperEnergyToLowerWeightMap weights;
+  for (G4int e = 0; e < EnergyBins(); e++)
+    weights[kUpperEnergies[e]] = fLowerWeights[cell * EnergyBins() + e];
+  return weights;
+}
+
+void WeightWindow::Read() {
+  std::ifstream file(fLoadFile);
+  if (!file) {
+    G4Exception("WeightWindow::Read", "FileNotFound", FatalException,
+                ("Cannot open weight windows " + fLoadFile +
+                 ", run /moderator/window/generate first")
+                    .c_str());
+    return;
+  }
+
+  G4String material;
+  G4double thickness = 0.;
+  G4int cells = 0;
+  std::vector<G4double> lowerWeights;
+  G4String line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#')
+      continue;
+    std::istringstream fields(line);
+    G4String tag;
+    fields >> tag;
+    if (tag == "material") {
+      fields >> material;
+    } else if (tag == "thickness") {
+      fields >> thickness;
+    } else if (tag == "cells") {
+      fields >> cells;
+    } else if (tag == "W") {
+      G4int cell = 0;
+      fields >> cell;
+      for (G4int e = 0; e < EnergyBins(); e++) {
+        G4double weight = 0.;
+        fields >> weight;
+        lowerWeights.push_back(weight);
+      }
+    }
+  }
+
+  if (material != fMaterial || std::abs(thickness - fThickness) > 1e-6 ||
+      cells != fCells || (G4int)lowerWeights.size() != Bins()) {
+    std::ostringstream message;
+    message << fLoadFile << " was generated for " << cells - 2
+            << " layers in " << thickness / cm << " cm of " << material
+            << " but the moderator is " << fCells - 2 << " layers in "
+            << fThickness / cm << " cm of " << fMaterial;
+    G4Exception("WeightWindow::Read", "GeometryMismatch", FatalException,
+                message.str().c_str());
+  }
+  fLowerWeights = lowerWeights;
+  G4cout << "Loaded weight windows from " << fLoadFile << G4endl;
+}
+
+void WeightWindow::Write(G4int events) const {
+  // importance of a bin is the tally per unit weight entering it, the
+  // lower bound is inversely proportional and puts the source weight in
+  // the middle of its window
+  std::vector<G4double> lowerWeights(Bins(), 0.);
+  G4double tallyPerEvent = fTallySum / events;
+  if (tallyPerEvent <= 0.) {
+    G4Exception("WeightWindow::Write", "NoTally", JustWarning,
+                ("Nothing reached the " + fTallyDetector +
+                 " tally, no weight windows written")
+                    .c_str());
+    return;
+  }
+  G4double normalization = 2. / (1. + kUpperFactor) * tallyPerEvent;
+  for (G4int i = 0; i < Bins(); i++) {
+    if (fScore[i] > 0.)
+      lowerWeights[i] = normalization * fEntered[i] / fScore[i];
+  }
+
+  // bins the tally never saw keep the loaded bound, else take the closest
+  // energy bin of the cell, else the cell upstream
+  for (G4int c = 0; c < fCells; c++) {
+    for (G4int e = 0; e < EnergyBins(); e++) {
+      G4int i = c * EnergyBins() + e;
+      if (lowerWeights[i] > 0.)
+        continue;
+      if (!fLowerWeights.empty() && fLowerWeights[i] > 0.) {
+        lowerWeights[i] = fLowerWeights[i];
+        continue;
+      }
+      for (G4int d = 1; d < EnergyBins() && lowerWeights[i] <= 0.; d++) {
+        if (e - d >= 0 && fScore[i - d] > 0.)
+          lowerWeights[i] = lowerWeights[i - d];
+        else if (e + d < EnergyBins() && fScore[i + d] > 0.)
+          lowerWeights[i] = lowerWeights[i + d];
+      }
+      if (lowerWeights[i] <= 0. && c > 0)
+        lowerWeights[i] = lowerWeights[i - EnergyBins()];
+    }
+  }
+  // nothing scored upstream either, use the window of the source
+  for (G4double &weight : lowerWeights) {
+    if (weight <= 0.)
+      weight = 2. / (1. + kUpperFactor);
+  }
+
+  std::ofstream file(fGenerateFile);
+  file.precision(6);
+  file << "# ThermalDT weight windows for the " << fTallyDetector
+       << " tally between " << fTallyMin / eV << " and " << fTallyMax / eV
+       << " eV\n";
+  file << "# W cell lower weight bounds per energy bin, upper edges (MeV):";
+  for (G4int e = 0; e < EnergyBins(); e++)
+    file << " " << kUpperEnergies[e];
+  file << "\n# cell 0 is outside the moderator layers, the last one behind "
+          "them\n";
+  file << "material " << fMaterial << "\n";
+  file << "thickness " << fThickness << "\n";
+  file << "cells " << fCells << "\n";
+  for (G4int c = 0; c < fCells; c++) {
+    file << "W " << c;
+    for (G4int e = 0; e < EnergyBins(); e++)
+      file << " " << lowerWeights[c * EnergyBins() + e];
+    file << "\n";
+  }
+  G4cout << "Wrote weight windows to " << fGenerateFile << G4endl;
+}
+
+G4bool WeightWindowWorld::FillWindowStore(
+    const std::vector<G4GeometryCell> &cells) {
+  WeightWindow *windows = WeightWindow::Instance();
+  if (!windows->IsLoaded())
+    return false;
+  G4WeightWindowStore *store = G4WeightWindowStore::GetInstance(kWorldName);
+  store->SetParallelWorldVolume(kWorldName);
+  store->Clear();
+  for (std::size_t i = 0; i < cells.size(); i++)
+    store->AddUpperEboundLowerWeightPairs(cells[i],
+                                          windows->GetLowerWeights(i));
+  return true;
+}
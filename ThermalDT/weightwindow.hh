@@ -0,0 +1,95 @@
+#ifndef WEIGHTWINDOW_HH
+#define WEIGHTWINDOW_HH
+
+#include "G4String.hh"
+#include "G4Threading.hh"
+#include "G4Types.hh"
+#include "G4WeightWindowStore.hh"
+#include "importance.hh"
+#include <atomic>
+#include <vector>
+
+// Weight windows on the importance cells of the moderator, per cell and
+// energy bin. A generating run scores how much of a tally every cell and
+// energy bin leads to per unit weight entering it and writes the lower
+// weight bounds at the end; a later run loads them instead of the cell
+// importances. Every run reports the figure of merit of the tally.
+// Configured by the master run action.
+class WeightWindow {
+public:
+  // G4WeightWindowAlgorithm parameters, the source weight 1 sits in the
+  // middle of its window
+  static constexpr G4double kUpperFactor = 5.;
+  static constexpr G4double kSurvivalFactor = 3.;
+  static constexpr G4int kMaxSplits = 5;
+
+  static WeightWindow *Instance();
+
+  // before /run/initialize, picks weight windows over cell importances
+  void Load(const G4String &fileName);
+  void Generate(const G4String &fileName);
+  void SetTallyDetector(const G4String &detector);
+  void SetTallyMin(G4double energy) { fTallyMin = energy; }
+  void SetTallyMax(G4double energy) { fTallyMax = energy; }
+
+  G4bool IsLoaded() const { return !fLoadFile.empty(); }
+  G4bool IsGenerating() const { return fGenerating.load(); }
+  const G4String &GetTallyDetector() const { return fTallyDetector; }
+  G4bool InTally(G4double energy) const {
+    return energy >= fTallyMin && energy <= fTallyMax;
+  }
+
+  void BeginRun(const G4String &material, G4double thickness,
+                G4int layers);
+  void Finish(G4int events, G4double seconds);
+
+  static G4int EnergyBins();
+  static G4int EnergyBin(G4double energy);
+  G4int Bin(G4int cell, G4double energy) const;
+  G4int Bins() const { return fCells * EnergyBins(); }
+
+  // weight entering and tally it led to, per bin, and the event tally
+  void AddEvent(const std::vector<G4double> &entered,
+                const std::vector<G4double> &score, G4double tally);
+
+  // lower bounds of one cell, keyed by the upper energy of each bin
+  G4UpperEnergyToLowerWeightMap GetLowerWeights(G4int cell) const;
+
+private:
+  WeightWindow();
+  ~WeightWindow() {}
+
+  void Read();
+  void Write(G4int events) const;
+
+  G4Mutex fMutex;
+  G4String fLoadFile;
+  G4String fGenerateFile;
+  std::atomic<G4bool> fGenerating;
+  G4String fTallyDetector;
+  G4double fTallyMin;
+  G4double fTallyMax;
+
+  G4String fMaterial;
+  G4double fThickness;
+  G4int fCells;
+  std::vector<G4double> fLowerWeights;
+
+  std::vector<G4double> fEntered;
+  std::vector<G4double> fScore;
+  G4double fTallySum;
+  G4double fTallySum2;
+};
+
+// The moderator importance cells, with the loaded weight windows in place
+// of the importances.
+class WeightWindowWorld : public ImportanceWorld {
+public:
+  WeightWindowWorld(const ModeratorSlab *moderator)
+      : ImportanceWorld(moderator) {}
+
+protected:
+  virtual G4bool FillWindowStore(const std::vector<G4GeometryCell> &cells);
+};
+
+#endif
@@ -0,0 +1,84 @@
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+# Generate -> run -> refine cycle of the moderator weight windows. Run from
+# ThermalDT after building in build/. Iteration 0 is analog (or uses
+# --start), every later one loads the windows of the one before, scores the
+# tally with them and writes refined windows. The figure of merit of the
+# tally is printed after each iteration; the ROOT outputs of the last
+# iteration are left in build/ as usual.
+
+TALLY = re.compile(r'Tally (\S+): (\S+) \+- (\S+) per event, (\S+) s, '
+                   r'FOM (\S+)')
+
+
+def write_macro(path, args, load, generate):
+    with open(path, 'w') as f:
+        f.write(f'/run/numberOfThreads {args.threads}\n')
+        f.write(f'/moderator/importance/layers {args.layers}\n')
+        if load:
+            f.write(f'/moderator/window/load {load}\n')
+        f.write('/run/initialize\n')
+        f.write(f'/moderator/window/detector {args.detector}\n')
+        f.write(f'/moderator/window/tallyMin {args.tally_min} eV\n')
+        f.write(f'/moderator/window/tallyMax {args.tally_max} eV\n')
+        f.write(f'/moderator/window/generate {generate}\n')
+        f.write(f'/run/beamOn {args.events}\n')
+
+
+def run_iteration(args, iteration, load):
+    generate = f'{args.prefix}{iteration}.ww'
+    macro = f'ww{iteration}.mac'
+    write_macro(os.path.join('build', macro), args, load, generate)
+    result = subprocess.run(['./sim', macro], cwd='build',
+                            capture_output=True, text=True)
+    match = TALLY.search(result.stdout)
+    if result.returncode != 0 or not match:
+        print(result.stdout[-2000:], result.stderr[-2000:], sep='\n')
+        sys.exit(f'Iteration {iteration} failed')
+    mean, error, seconds, fom = (float(v) for v in match.groups()[1:])
+    return generate, mean, error, seconds, fom
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Iterate weight windows for the moderator tally')
+    parser.add_argument('--iterations', type=int, default=4)
+    parser.add_argument('--events', type=int, default=100000)
+    parser.add_argument('--threads', type=int, default=16)
+    parser.add_argument('--layers', type=int, default=5)
+    parser.add_argument('--detector', default='WrapPost')
+    parser.add_argument('--tally-min', type=float, default=0.015,
+                        help='eV')
+    parser.add_argument('--tally-max', type=float, default=0.030,
+                        help='eV')
+    parser.add_argument('--prefix', default='moderator',
+                        help='window files are <prefix><iteration>.ww')
+    parser.add_argument('--start', default=None,
+                        help='window file to start from instead of analog, '
+                             'relative to build/')
+    args = parser.parse_args()
+
+    if not os.path.exists(os.path.join('build', 'sim')):
+        sys.exit('build/sim not found, build ThermalDT first')
+
+    load = args.start
+    first_fom = None
+    print(f"{'iter':>4} {'tally/event':>12} {'error':>10} {'time (s)':>9}"
+          f" {'FOM':>10} {'gain':>6}")
+    for iteration in range(args.iterations):
+        load, mean, error, seconds, fom = run_iteration(args, iteration,
+                                                        load)
+        if first_fom is None:
+            first_fom = fom
+        gain = fom / first_fom if first_fom > 0 else float('nan')
+        print(f'{iteration:4d} {mean:12.4g} {error:10.3g} {seconds:9.1f}'
+              f' {fom:10.4g} {gain:6.2f}')
+    print(f'Last windows: build/{load}')
+
+
+if __name__ == '__main__':
+    main()
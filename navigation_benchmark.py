@@ -0,0 +1,94 @@
+import argparse
+import csv
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+# Steps and wall time per event of the apps whose shields and walls are
+# built by GeometryBuilder, for every /geometry/builder/mode. Each app has
+# to be built in <app>/build first. The runs use the app's default
+# generator and write their output into a scratch directory, so existing
+# results in build/ are left alone.
+
+APPS = ['Coincidence-PSI', 'LiF/ModeratedNeutrons']
+MODES = ['boolean', 'nested', 'shells']
+
+NAVIGATION = re.compile(r'Navigation: (\d+) events, (\S+) steps/event, '
+                        r'(\S+) ms/event')
+
+
+def benchmark(app, mode, args):
+    sim = os.path.abspath(os.path.join(app, 'build', 'sim'))
+    with tempfile.TemporaryDirectory() as workdir:
+        macro = os.path.join(workdir, 'navigation.mac')
+        with open(macro, 'w') as f:
+            f.write(f'/run/numberOfThreads {args.threads}\n')
+            f.write(f'/geometry/builder/mode {mode}\n')
+            for setting in args.smartless:
+                f.write(f'/geometry/builder/smartless {setting}\n')
+            f.write('/run/initialize\n')
+            # physics tables are built at the first beamOn, keep them out
+            # of the timing
+            f.write('/run/beamOn 0\n')
+            f.write(f'/run/beamOn {args.events}\n')
+        result = subprocess.run([sim, macro], cwd=workdir,
+                                capture_output=True, text=True)
+    match = None
+    for match in NAVIGATION.finditer(result.stdout):
+        pass
+    if result.returncode != 0 or not match:
+        tail = (result.stdout + result.stderr).splitlines()[-5:]
+        print(f'{app} with {mode} failed:', *tail, sep='\n  ')
+        return None
+    return {'app': app, 'mode': mode, 'threads': args.threads,
+            'events': int(match.group(1)),
+            'steps_per_event': float(match.group(2)),
+            'ms_per_event': float(match.group(3))}
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Benchmark the navigation of boolean and native shield '
+                    'and wall geometry')
+    parser.add_argument('--apps', nargs='+', default=APPS)
+    parser.add_argument('--modes', nargs='+', default=MODES)
+    parser.add_argument('--events', type=int, default=100000)
+    parser.add_argument('--threads', type=int, default=1)
+    parser.add_argument('--smartless', nargs='*', default=[],
+                        help='"<logical volume> <smartless>" settings for '
+                             'every run')
+    parser.add_argument('--output', default='navigation_benchmark.csv')
+    args = parser.parse_args()
+
+    results = []
+    for app in args.apps:
+        if not os.path.exists(os.path.join(app, 'build', 'sim')):
+            print(f'{app}/build/sim not found, skipped')
+            continue
+        reference = None
+        for mode in args.modes:
+            result = benchmark(app, mode, args)
+            if not result:
+                continue
+            if reference is None:
+                reference = result['ms_per_event']
+            result['speedup'] = reference / result['ms_per_event']
+            results.append(result)
+            print(f"{app:24s} {mode:8s} "
+                  f"{result['steps_per_event']:9.1f} steps/event"
+                  f"  {result['ms_per_event']:9.4f} ms/event"
+                  f"  x{result['speedup']:.2f}")
+
+    if not results:
+        sys.exit('No successful runs')
+    with open(args.output, 'w', newline='') as f:
+        writer = csv.DictWriter(f, fieldnames=list(results[0].keys()))
+        writer.writeheader()
+        writer.writerows(results)
+    print(f'Wrote {len(results)} results to {args.output}')
+
+
+if __name__ == '__main__':
+    main()
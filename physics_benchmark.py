@@ -0,0 +1,101 @@
+import argparse
+import csv
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+# Init time, peak memory and event rate of every physics preset on every
+# app's geometry. Each app has to be built in <app>/build first. The runs
+# use the app's default generator and write their output into a scratch
+# directory, so existing results in build/ are left alone.
+
+APPS = ['CZT', 'CdTe', 'SiLi', 'SiDiode', 'GeometryOptimizationHPGe',
+        'HPGeOSU', 'HPGeNSL', 'Post-PSI', 'Coincidence-PSI', 'ThermalDT',
+        'LiF/DTGenerator', 'LiF/Efficiency', 'LiF/ModeratedNeutrons',
+        'LiF/ThermalNeutronSource']
+PRESETS = ['gamma', 'alpha', 'hpge', 'neutron', 'neutronhp', 'thermal']
+
+# apps that take positional arguments before the macro
+EXTRA_ARGS = {'GeometryOptimizationHPGe': ['0.5', '10.0']}
+
+
+def run_macro(app, preset, macro, workdir):
+    sim = os.path.abspath(os.path.join(app, 'build', 'sim'))
+    command = [sim, '-p', preset] + EXTRA_ARGS.get(app, []) + [macro]
+    start = time.perf_counter()
+    with open(os.path.join(workdir, 'sim.log'), 'a') as log:
+        process = subprocess.Popen(command, cwd=workdir, stdout=log,
+                                   stderr=subprocess.STDOUT)
+        _, status, usage = os.wait4(process.pid, 0)
+    elapsed = time.perf_counter() - start
+    if os.waitstatus_to_exitcode(status) != 0:
+        return None
+    # ru_maxrss is in kB on Linux, worker threads share the process
+    return elapsed, usage.ru_maxrss / 1024.
+
+
+def benchmark(app, preset, events, threads):
+    with tempfile.TemporaryDirectory() as workdir:
+        init_macro = os.path.join(workdir, 'init.mac')
+        with open(init_macro, 'w') as f:
+            f.write(f'/run/numberOfThreads {threads}\n')
+            f.write('/run/initialize\n')
+            # physics tables are built at the first beamOn
+            f.write('/run/beamOn 0\n')
+        full_macro = os.path.join(workdir, 'full.mac')
+        with open(full_macro, 'w') as f:
+            f.write(f'/run/numberOfThreads {threads}\n')
+            f.write('/run/initialize\n')
+            f.write(f'/run/beamOn {events}\n')
+
+        init = run_macro(app, preset, init_macro, workdir)
+        full = run_macro(app, preset, full_macro, workdir) if init else None
+        if not init or not full:
+            with open(os.path.join(workdir, 'sim.log')) as log:
+                tail = log.read().splitlines()[-5:]
+            print(f'{app} with {preset} failed:', *tail, sep='\n  ')
+            return None
+
+    event_time = full[0] - init[0]
+    rate = events / event_time if event_time > 0 else float('nan')
+    return {'app': app, 'preset': preset, 'threads': threads,
+            'events': events, 'init_s': init[0], 'memory_MB': full[1],
+            'events_per_s': rate}
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Benchmark the physics presets of every app')
+    parser.add_argument('--apps', nargs='+', default=APPS)
+    parser.add_argument('--presets', nargs='+', default=PRESETS)
+    parser.add_argument('--events', type=int, default=10000)
+    parser.add_argument('--threads', type=int, default=1)
+    parser.add_argument('--output', default='physics_benchmark.csv')
+    args = parser.parse_args()
+
+    results = []
+    for app in args.apps:
+        if not os.path.exists(os.path.join(app, 'build', 'sim')):
+            print(f'{app}/build/sim not found, skipped')
+            continue
+        for preset in args.presets:
+            result = benchmark(app, preset, args.events, args.threads)
+            if result:
+                results.append(result)
+                print(f"{app:28s} {preset:10s} init {result['init_s']:7.1f} s"
+                      f"  mem {result['memory_MB']:7.0f} MB"
+                      f"  {result['events_per_s']:9.1f} events/s")
+
+    if not results:
+        sys.exit('No successful runs')
+    with open(args.output, 'w', newline='') as f:
+        writer = csv.DictWriter(f, fieldnames=list(results[0].keys()))
+        writer.writeheader()
+        writer.writerows(results)
+    print(f'Wrote {len(results)} results to {args.output}')
+
+
+if __name__ == '__main__':
+    main()